@@ -0,0 +1,236 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#ifndef __ITENSOR_BENCHMARK_BENCH_H
+#define __ITENSOR_BENCHMARK_BENCH_H
+
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <sys/resource.h>
+#include "itensor/util/cputime.h"
+#include "itensor/util/print.h"
+#include "itensor/util/profile.h"
+
+//
+// Minimal harness for the benchmark suite.
+//
+// Each benchmark is a function which is called
+// repeatedly until at least minTime seconds have
+// elapsed. The first call runs with profiling() on
+// to count the gemm flops done per call; later calls
+// are timed with profiling off. Calls taking longer
+// than minTime (such as full DMRG runs) are only
+// made once, timed with profiling on.
+//
+// Only gemm flops are counted, so gflops is zero for
+// work done entirely inside LAPACK (diagHermitian)
+// and a lower bound otherwise.
+//
+// Results are written as a whitespace separated table
+//
+//   # name nrepeat wall_s gflops peak_rss_mb
+//
+// and can be compared against a stored baseline in
+// the same format.
+//
+
+namespace itensor {
+
+struct BenchResult
+    {
+    std::string name;
+    long nrepeat = 0;
+    Real wall = 0; //seconds per call
+    Real gflops = 0;
+    Real rss = 0; //peak resident set size of the process, MB
+    };
+
+//Peak resident set size of this process so far, in MB
+Real inline
+peakRSS()
+    {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF,&usage);
+    //ru_maxrss is in kilobytes on Linux, bytes on macOS
+#ifdef __APPLE__
+    return usage.ru_maxrss/(1024.*1024.);
+#else
+    return usage.ru_maxrss/1024.;
+#endif
+    }
+
+//Sum of flops recorded by the profiling scopes
+//with the given name anywhere in the tree
+Real inline
+flopsIn(ProfileRegion const& R, std::string const& name)
+    {
+    //Scopes of the same name are assumed not to nest
+    if(R.name == name) return R.flops;
+    Real f = 0;
+    for(auto& c : R.children) f += flopsIn(c,name);
+    return f;
+    }
+
+std::vector<BenchResult> inline
+readResults(std::string const& fname)
+    {
+    auto res = std::vector<BenchResult>{};
+    std::ifstream f(fname);
+    if(!f) Error(format("Could not open benchmark results file \"%s\"",fname));
+    std::string line;
+    while(std::getline(f,line))
+        {
+        if(line.empty() || line[0] == '#') continue;
+        std::istringstream s(line);
+        auto r = BenchResult{};
+        s >> r.name >> r.nrepeat >> r.wall >> r.gflops >> r.rss;
+        if(s) res.push_back(r);
+        }
+    return res;
+    }
+
+class BenchSuite
+    {
+    Real min_time_ = 0.5;
+    Real tolerance_ = 0.1;
+    bool quick_ = false;
+    std::string filter_,
+                outfile_,
+                baseline_;
+    std::vector<BenchResult> results_;
+    public:
+
+    //Options:
+    //  -q          quick mode (smaller sizes)
+    //  -f filter   only run benchmarks whose name contains filter
+    //  -m seconds  minimum time spent per benchmark (default 0.5)
+    //  -o file     write results to file
+    //  -b file     compare against baseline results in file
+    //  -t tol      relative slowdown counted as a regression (default 0.1)
+    BenchSuite(int argc, char* argv[])
+        {
+        for(int n = 1; n < argc; ++n)
+            {
+            auto opt = std::string(argv[n]);
+            auto value = [&]()
+                {
+                if(n+1 >= argc) Error(format("Missing value for option %s",opt));
+                return std::string(argv[++n]);
+                };
+            if(opt == "-q") quick_ = true;
+            else if(opt == "-f") filter_ = value();
+            else if(opt == "-m") min_time_ = std::stod(value());
+            else if(opt == "-o") outfile_ = value();
+            else if(opt == "-b") baseline_ = value();
+            else if(opt == "-t") tolerance_ = std::stod(value());
+            else Error(format("Unknown option %s",opt));
+            }
+        profileTrace() = false;
+        printfln("# %-44s %8s %12s %10s %12s","name","nrepeat","wall_s","gflops","peak_rss_mb");
+        }
+
+    bool
+    quick() const { return quick_; }
+
+    bool
+    selected(std::string const& name) const
+        {
+        return filter_.empty() || name.find(filter_) != std::string::npos;
+        }
+
+    template<typename F>
+    void
+    run(std::string const& name, F&& f)
+        {
+        if(!selected(name)) return;
+
+        auto r = BenchResult{};
+        r.name = name;
+
+        profileReset();
+        profiling() = true;
+        auto t = cpu_time();
+        f();
+        auto first = t.sincemark().wall;
+        profiling() = false;
+        auto flops = flopsIn(profileRegions(),"gemm");
+        profileReset();
+
+        if(first >= min_time_)
+            {
+            r.nrepeat = 1;
+            r.wall = first;
+            }
+        else
+            {
+            t.mark();
+            long n = 0;
+            Real wall = 0;
+            while(wall < min_time_)
+                {
+                f();
+                ++n;
+                wall = t.sincemark().wall;
+                }
+            r.nrepeat = n;
+            r.wall = wall/n;
+            }
+        r.gflops = 1E-9*flops/r.wall;
+        r.rss = peakRSS();
+        printfln("  %-44s %8d %12.6f %10.3f %12.1f",r.name,r.nrepeat,r.wall,r.gflops,r.rss);
+        results_.push_back(r);
+        }
+
+    //Writes results and compares against the baseline
+    //if requested; returns the number of regressions
+    int
+    finish() const
+        {
+        if(!outfile_.empty())
+            {
+            std::ofstream f(outfile_);
+            printfln(f,"# %-44s %8s %12s %10s %12s","name","nrepeat","wall_s","gflops","peak_rss_mb");
+            for(auto& r : results_)
+                {
+                printfln(f,"  %-44s %8d %12.6f %10.3f %12.1f",r.name,r.nrepeat,r.wall,r.gflops,r.rss);
+                }
+            }
+        if(baseline_.empty()) return 0;
+
+        auto base = std::map<std::string,BenchResult>{};
+        for(auto& r : readResults(baseline_)) base[r.name] = r;
+
+        int nregress = 0;
+        printfln("\nComparison with baseline %s (tolerance %.0f%%):",baseline_,100*tolerance_);
+        printfln("# %-44s %12s %12s %8s","name","base_wall_s","wall_s","ratio");
+        for(auto& r : results_)
+            {
+            auto it = base.find(r.name);
+            if(it == base.end())
+                {
+                printfln("  %-44s %12s %12.6f %8s",r.name,"-",r.wall,"new");
+                continue;
+                }
+            auto ratio = r.wall/it->second.wall;
+            auto status = "";
+            if(ratio > 1+tolerance_)
+                {
+                status = "SLOWER";
+                ++nregress;
+                }
+            else if(ratio < 1-tolerance_)
+                {
+                status = "faster";
+                }
+            printfln("  %-44s %12.6f %12.6f %8.3f %s",r.name,it->second.wall,r.wall,ratio,status);
+            }
+        printfln("%d regression%s",nregress,nregress == 1 ? "" : "s");
+        return nregress;
+        }
+    };
+
+} //namespace itensor
+
+#endif
@@ -0,0 +1,100 @@
+//
+// Records the dense contractions done during a short
+// (non-QN) DMRG calculation using TStats, and prints
+// the distinct shapes accounting for the most flops
+// in the format read by the contract benchmark of
+// the suite.
+//
+// Built by "make harvest", which compiles
+// itdata/dense.cc with COLLECT_TSTATS defined.
+//
+// Run as: ./harvest_shapes [outfile] [nshape]
+//
+#include <fstream>
+#include <map>
+#include "itensor/all.h"
+#include "itensor/util/tensorstats.h"
+
+#ifndef COLLECT_TSTATS
+#error "harvest_shapes must be compiled with COLLECT_TSTATS defined"
+#endif
+
+using namespace itensor;
+
+std::string
+shapeKey(TStats const& t)
+    {
+    return format("%s",t);
+    }
+
+Real
+flops(TStats const& t)
+    {
+    //Every distinct label appears once in the loop nest
+    auto dims = std::map<int,int>{};
+    for(auto n : range(t.Ar)) dims[t.Alabs[n]] = t.Adims[n];
+    for(auto n : range(t.Br)) dims[t.Blabs[n]] = t.Bdims[n];
+    Real f = 2;
+    for(auto& d : dims) f *= d.second;
+    return f;
+    }
+
+int
+main(int argc, char* argv[])
+    {
+    auto outfile = std::string((argc > 1) ? argv[1] : "contract_shapes.txt");
+    int nshape = (argc > 2) ? std::atoi(argv[2]) : 12;
+
+    int N = 40;
+    auto sites = SpinOne(N);
+    auto ampo = AutoMPO(sites);
+    for(int j = 1; j < N; ++j)
+        {
+        ampo += 0.5,"S+",j,"S-",j+1;
+        ampo += 0.5,"S-",j,"S+",j+1;
+        ampo +=     "Sz",j,"Sz",j+1;
+        }
+    auto H = MPO(ampo);
+    auto state = InitState(sites);
+    for(int i = 1; i <= N; ++i) state.set(i,i%2==1 ? "Up" : "Dn");
+    auto psi = MPS(state);
+    auto sweeps = Sweeps(4);
+    sweeps.maxm() = 20,50,100,100;
+    sweeps.cutoff() = 1E-12;
+    sweeps.niter() = 2;
+    dmrg(psi,H,sweeps,{"Quiet",true});
+
+    struct Shape
+        {
+        TStats t;
+        long count = 0;
+        Real flops = 0;
+        };
+    auto shapes = std::map<std::string,Shape>{};
+    for(auto& t : global_tstats())
+        {
+        auto& s = shapes[shapeKey(t)];
+        s.t = t;
+        s.count += 1;
+        s.flops += flops(t);
+        }
+
+    auto sorted = std::vector<Shape>{};
+    for(auto& s : shapes) sorted.push_back(s.second);
+    std::sort(sorted.begin(),sorted.end(),
+              [](Shape const& a, Shape const& b) { return a.flops > b.flops; });
+
+    std::ofstream f(outfile);
+    printfln(f,"# %d dense contractions recorded by TStats during SpinOne N=%d DMRG (maxm=100),",
+             global_tstats().size(),N);
+    printfln(f,"# %d distinct shapes; the %d accounting for the most flops follow",
+             sorted.size(),std::min<size_t>(nshape,sorted.size()));
+    for(auto n : range(std::min<size_t>(nshape,sorted.size())))
+        {
+        printfln(f,"# count %d, %.3g flops in total",sorted[n].count,sorted[n].flops);
+        f << sorted[n].t;
+        }
+    printfln("Wrote %d shapes to %s",std::min<size_t>(nshape,sorted.size()),outfile);
+
+    return 0;
+    }
@@ -0,0 +1,108 @@
+//
+// Throughput of ITensor messages between two MPI nodes:
+// stringstream path (write/read into a buffer, sent in
+// chunks) versus the binary path (header plus storage
+// data sent directly), for MailBox::send/receive and
+// for broadcast.
+//
+// Run as: mpirun -np 2 ./mpi_message [maxsizeMB]
+//
+#include "itensor/util/parallel.h"
+#include "itensor/all_basic.h"
+#include "itensor/util/cputime.h"
+
+using namespace itensor;
+
+template<typename F>
+double
+timeIt(Environment const& env, int nrepeat, F&& f)
+    {
+    env.barrier();
+    auto t = cpu_time();
+    for(int n = 0; n < nrepeat; ++n) f();
+    env.barrier();
+    return t.sincemark().wall/nrepeat;
+    }
+
+int
+main(int argc, char* argv[])
+    {
+    Environment env(argc,argv);
+    if(env.nnodes() < 2)
+        {
+        printfln("mpi_message: run with at least 2 MPI nodes (mpirun -np 2)");
+        return 0;
+        }
+    long maxMB = (argc > 1) ? std::atol(argv[1]) : 256;
+
+    if(env.firstNode()) printfln("%12s %10s %14s %14s %14s %14s",
+                                 "bytes","nrepeat","send stream","send binary",
+                                 "bcast stream","bcast binary");
+
+    for(long mb = 1; mb <= maxMB; mb *= 4)
+        {
+        auto n = long(std::sqrt(mb*1024.*1024./sizeof(Real)));
+        auto i = Index("i",n),
+             j = Index("j",n);
+        auto T = ITensor();
+        if(env.firstNode()) T = randomTensor(i,j);
+        auto bytes = double(n*n*sizeof(Real));
+        int nrepeat = std::max(1l,64/mb);
+
+        auto sendStream = timeIt(env,nrepeat,[&]
+            {
+            if(env.rank() > 1) return;
+            MailBox mailbox(env,env.firstNode() ? 1 : 0);
+            if(env.firstNode())
+                {
+                std::stringstream data;
+                itensor::write(data,T);
+                mailbox.send(data);
+                }
+            else
+                {
+                std::stringstream data;
+                mailbox.receive(data);
+                auto R = ITensor();
+                itensor::read(data,R);
+                }
+            });
+
+        auto sendBinary = timeIt(env,nrepeat,[&]
+            {
+            if(env.rank() > 1) return;
+            MailBox mailbox(env,env.firstNode() ? 1 : 0);
+            if(env.firstNode())
+                {
+                mailbox.send(T);
+                }
+            else
+                {
+                auto R = ITensor();
+                mailbox.receive(R);
+                }
+            });
+
+        auto bcastStream = timeIt(env,nrepeat,[&]
+            {
+            std::stringstream data;
+            if(env.firstNode()) itensor::write(data,T);
+            env.broadcast(data);
+            auto R = T;
+            if(!env.firstNode()) itensor::read(data,R);
+            });
+
+        auto bcastBinary = timeIt(env,nrepeat,[&]
+            {
+            auto R = T;
+            broadcast(env,R);
+            });
+
+        auto rate = [bytes](double t) { return format("%.3f GB/s",bytes/t/1E9); };
+        if(env.firstNode()) printfln("%12.0f %10d %14s %14s %14s %14s",
+                                     bytes,nrepeat,rate(sendStream),rate(sendBinary),
+                                     rate(bcastStream),rate(bcastBinary));
+        }
+
+    return 0;
+    }
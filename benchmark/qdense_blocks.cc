@@ -0,0 +1,124 @@
+//
+// Compares block lookup during QDense contractions:
+// BlockOffsets tables (Global::blockTable() == true)
+// versus binary search over the offsets array, timing
+// fixed-sweep DMRG for an S=1 Heisenberg chain and
+// a Hubbard chain.
+//
+// Also times contracting tensors with many small
+// blocks, where block lookup dominates.
+//
+// Run as: ./qdense_blocks [maxm]
+//
+#include "itensor/all.h"
+#include "itensor/util/cputime.h"
+
+using namespace itensor;
+
+template<typename SiteSetT>
+void
+runDMRG(std::string const& name,
+        SiteSetT const& sites,
+        IQMPO const& H,
+        InitState const& state,
+        Sweeps const& sweeps)
+    {
+    for(auto table : {false,true})
+        {
+        Global::blockTable() = table;
+        auto psi = IQMPS(state);
+        auto t = cpu_time();
+        auto energy = dmrg(psi,H,sweeps,{"Quiet",true});
+        auto wall = t.sincemark().wall;
+        printfln("%-10s %-14s %10.3f s  E = %.10f",
+                 name,table ? "table" : "binary search",wall,energy);
+        }
+    Global::blockTable() = false;
+    }
+
+IQIndex
+manySectors(std::string const& name, int nsector)
+    {
+    auto iq = stdx::reserve_vector<IndexQN>(nsector);
+    for(auto n : range(nsector))
+        {
+        iq.emplace_back(Index(format("%s%d",name,n),1+n%2),QN(n-nsector/2));
+        }
+    return IQIndex(name,std::move(iq));
+    }
+
+void
+runContract(int nsector, int nrepeat)
+    {
+    auto i = manySectors("i",nsector),
+         j = manySectors("j",nsector),
+         k = manySectors("k",nsector),
+         l = manySectors("l",nsector),
+         m = manySectors("m",nsector);
+    auto A = randomTensor(QN(),i,j,dag(k),dag(l));
+    auto B = randomTensor(QN(),k,l,dag(m),dag(prime(i)));
+    for(auto table : {false,true})
+        {
+        Global::blockTable() = table;
+        auto t = cpu_time();
+        for(auto n : range(nrepeat)) 
+            {
+            auto C = A*B;
+            }
+        auto wall = t.sincemark().wall;
+        printfln("%-10s %-14s %10.3f s  (%d sectors per index)",
+                 "contract",table ? "table" : "binary search",wall/nrepeat,nsector);
+        }
+    Global::blockTable() = false;
+    }
+
+int
+main(int argc, char* argv[])
+    {
+    runContract(10,20);
+    runContract(30,2);
+
+    int maxm = (argc > 1) ? std::atoi(argv[1]) : 200;
+
+    auto sweeps = Sweeps(5);
+    sweeps.maxm() = 20,50,maxm/2,maxm;
+    sweeps.cutoff() = 1E-12;
+    sweeps.niter() = 2;
+    sweeps.noise() = 1E-7,1E-8,0.0;
+
+        {
+        int N = 100;
+        auto sites = SpinOne(N);
+        auto ampo = AutoMPO(sites);
+        for(int j = 1; j < N; ++j)
+            {
+            ampo += 0.5,"S+",j,"S-",j+1;
+            ampo += 0.5,"S-",j,"S+",j+1;
+            ampo +=     "Sz",j,"Sz",j+1;
+            }
+        auto H = IQMPO(ampo);
+        auto state = InitState(sites);
+        for(int i = 1; i <= N; ++i) state.set(i,i%2==1 ? "Up" : "Dn");
+        runDMRG("S=1",sites,H,state,sweeps);
+        }
+
+        {
+        int N = 20;
+        auto sites = Hubbard(N);
+        auto ampo = AutoMPO(sites);
+        for(int i = 1; i <= N; ++i) ampo += 4.,"Nupdn",i;
+        for(int b = 1; b < N; ++b)
+            {
+            ampo += -1.,"Cdagup",b,"Cup",b+1;
+            ampo += -1.,"Cdagup",b+1,"Cup",b;
+            ampo += -1.,"Cdagdn",b,"Cdn",b+1;
+            ampo += -1.,"Cdagdn",b+1,"Cdn",b;
+            }
+        auto H = IQMPO(ampo);
+        auto state = InitState(sites);
+        for(int i = 1; i <= N; ++i) state.set(i,i%2==1 ? "Up" : "Dn");
+        runDMRG("Hubbard",sites,H,state,sweeps);
+        }
+
+    return 0;
+    }
@@ -0,0 +1,1221 @@
+//
+// Benchmark suite covering the main costs of DMRG:
+//
+//   contract/dense/...   dense tensor contractions, using shapes
+//                        recorded by TStats (contract_shapes.txt,
+//                        regenerate with "make harvest")
+//   contract/qdense/...  QDense environment update contractions
+//                        of converged SpinOne and Hubbard states
+//   decomp/...           svd, diagHermitian and denmatDecomp of
+//                        dense tensors of several sizes, and svd
+//                        of two-site QN wavefunctions
+//   product/...          LocalOp::product of the effective
+//                        Hamiltonian at the center bond
+//   dmrg/...             full fixed-sweep DMRG on SpinHalf,
+//                        SpinOne and Hubbard chains, and for
+//                        the lowest states of a SpinOne chain
+//                        found one at a time or batched
+//   autompo/...          adding the N^4 terms of a random
+//                        two-body spinless fermion Hamiltonian
+//                        to an AutoMPO, and converting it to
+//                        an IQMPO; converting a cylinder Hubbard
+//                        model with long-range interactions
+//   mpo/...              sums and products of a long-range
+//                        Heisenberg IQMPO, and compressing them
+//   tevol/...            real time evolution of a SpinHalf
+//                        chain with a list of BondGates and
+//                        with second and fourth order TrotterGates
+//   siteset/op/...       SiteSet::op for every site of a Hubbard
+//                        chain, with and without the operator cache
+//   rescale/...          a memory-bound contraction, SpinOne DMRG
+//                        and TRG for the 2D Ising model, with
+//                        contraction results always normalized
+//                        ("eager") and only rescaled near over-
+//                        or underflow ("deferred", the default)
+//   storage/...          a dense two-site effective Hamiltonian
+//                        product, SpinOne DMRG and Ising TRG with
+//                        and without the storage buffer pool
+//   dispatch/...         small-tensor workloads: SiteSet operator
+//                        algebra, AutoMPO conversion and ancilla
+//                        finite temperature evolution (as in
+//                        tutorial/finiteT), with doTask using its
+//                        dispatch tables ("table", the default)
+//                        and virtual calls ("virtual")
+//   elementwise/...      memory-bound loops over all elements
+//                        of L^3 tensors: scaling and conjugating
+//                        complex data, and adding real or complex
+//                        tensors with the same or permuted index
+//                        order, run with one thread and with
+//                        Global::elementwiseThreads(); the bytes
+//                        read and written per call (printed in a
+//                        comment) over wall_s give the bandwidth
+//   diag/...             contractions with diagonal tensors:
+//                        scaling the rows and columns of dense
+//                        and QN matrices by singular values, a
+//                        partial trace with a delta tensor,
+//                        and products of two diagonal tensors
+//   combine/...          combining non-adjacent indices of dense
+//                        and QN tensors (a permuting copy) and
+//                        denmatDecomp with the combined indices
+//                        adjacent on AA but in a different order
+//                        than on the tensor to orthogonalize
+//   permute/...          permuting copies of rank 3 to 6 tensors
+//                        (the kernel of transform, used by
+//                        combiners, contractions and +=), small
+//                        ones where per-element loop overhead
+//                        matters and a large one as a check
+//   blocks/...           contracting QN tensors with many small
+//                        blocks, dominated by the loop over
+//                        matching blocks (loopContractedBlocks)
+//   index/...            creating Index objects (whose cost is
+//                        that of generating their IDs) on one
+//                        thread and on all cores at once
+//   jobs/...             many independent small SpinHalf DMRG
+//                        calculations run by runJobs on 1, 2, 4,
+//                        ... threads up to the number of cores;
+//                        ideal scaling halves wall_s with each
+//                        doubling (run with OPENBLAS_NUM_THREADS=1)
+//
+// Run as: ./suite [-q] [-f filter] [-m mintime] [-o results.txt]
+//                 [-b baseline.txt] [-t tolerance]
+// (see bench.h). "make baseline" stores baseline.txt and
+// "make compare" compares a new run against it; the exit
+// status is nonzero if any benchmark got slower than the
+// tolerance allows.
+//
+#include "itensor/all.h"
+#include "itensor/tensor/sliceten.h"
+#include "itensor/util/jobs.h"
+#include "bench.h"
+
+using namespace itensor;
+
+struct Shape
+    {
+    std::vector<long> Adims,Bdims,Cdims;
+    Labels Alabs,Blabs,Clabs;
+    };
+
+//Reads the format written by operator<<(std::ostream&,TStats)
+std::vector<Shape>
+readShapes(std::string const& fname)
+    {
+    auto shapes = std::vector<Shape>{};
+    std::ifstream f(fname);
+    if(!f)
+        {
+        printfln("Could not open %s, skipping dense contractions",fname);
+        return shapes;
+        }
+    auto readTensor = [](std::istringstream& s, std::vector<long>& dims, Labels& labs)
+        {
+        std::string tok;
+        s >> tok >> tok >> tok; //name, (rank), [
+        while(s >> tok && tok != "]") dims.push_back(std::stol(tok));
+        s >> tok; //{
+        while(s >> tok && tok != "}") labs.push_back(std::stoi(tok));
+        };
+    std::string line;
+    auto lines = std::vector<std::string>{};
+    while(std::getline(f,line))
+        {
+        if(line.empty() || line[0] == '#') continue;
+        lines.push_back(line);
+        if(lines.size() < 3) continue;
+        auto sh = Shape{};
+        std::istringstream sa(lines[0]), sb(lines[1]), sc(lines[2]);
+        readTensor(sa,sh.Adims,sh.Alabs);
+        readTensor(sb,sh.Bdims,sh.Blabs);
+        readTensor(sc,sh.Cdims,sh.Clabs);
+        shapes.push_back(sh);
+        lines.clear();
+        }
+    return shapes;
+    }
+
+Tensor
+randomTen(std::vector<long> const& dims)
+    {
+    auto rb = RangeBuilder(dims.size());
+    for(auto d : dims) rb.nextIndex(d);
+    auto R = rb.build();
+    auto T = Tensor(std::vector<Real>(area(R)),std::move(R));
+    randomize(T);
+    return T;
+    }
+
+std::string
+dimString(std::vector<long> const& dims)
+    {
+    auto s = std::to_string(dims.front());
+    for(auto n : range1(dims.size()-1)) s += "x"+std::to_string(dims[n]);
+    return s;
+    }
+
+void
+denseContractions(BenchSuite& suite)
+    {
+    for(auto& sh : readShapes("contract_shapes.txt"))
+        {
+        auto A = randomTen(sh.Adims),
+             B = randomTen(sh.Bdims);
+        auto C = randomTen(sh.Cdims);
+        auto name = format("contract/dense/%s*%s",dimString(sh.Adims),dimString(sh.Bdims));
+        suite.run(name,[&]{ contract(A,sh.Alabs,B,sh.Blabs,C,sh.Clabs); });
+        }
+    }
+
+void
+decompositions(BenchSuite& suite)
+    {
+    auto sizes = suite.quick() ? std::vector<int>{25,50} : std::vector<int>{50,100,200};
+    int d = 3;
+    for(auto m : sizes)
+        {
+        auto l = Index("l",m),
+             s1 = Index("s1",d),
+             s2 = Index("s2",d),
+             r = Index("r",m),
+             mid = Index("mid",m);
+        auto AA = randomTensor(l,s1,s2,r);
+        suite.run(format("decomp/svd/%dx%dx%dx%d",m,d,d,m),[&]
+            {
+            ITensor U(l,s1),S,V;
+            svd(AA,U,S,V);
+            });
+
+        auto c = Index("c",m*d);
+        auto X = randomTensor(c,prime(c));
+        auto rho = X+swapPrime(X,0,1);
+        suite.run(format("decomp/diagHermitian/%dx%d",m*d,m*d),[&]
+            {
+            ITensor U,D;
+            diagHermitian(rho,U,D);
+            });
+
+        suite.run(format("decomp/denmatDecomp/%dx%dx%dx%d",m,d,d,m),[&]
+            {
+            auto A = ITensor(l,s1,mid),
+                 B = ITensor(mid,s2,r);
+            denmatDecomp(AA,A,B,Fromleft);
+            });
+        }
+    }
+
+struct Model
+    {
+    std::string name;
+    IQMPO H;
+    IQMPS psi;
+    };
+
+template<typename SiteSetT>
+IQMPO
+heisenberg(SiteSetT const& sites)
+    {
+    auto N = sites.N();
+    auto ampo = AutoMPO(sites);
+    for(int j = 1; j < N; ++j)
+        {
+        ampo += 0.5,"S+",j,"S-",j+1;
+        ampo += 0.5,"S-",j,"S+",j+1;
+        ampo +=     "Sz",j,"Sz",j+1;
+        }
+    return IQMPO(ampo);
+    }
+
+IQMPO
+hubbard(Hubbard const& sites, Real U = 4.)
+    {
+    auto N = sites.N();
+    auto ampo = AutoMPO(sites);
+    for(int i = 1; i <= N; ++i) ampo += U,"Nupdn",i;
+    for(int b = 1; b < N; ++b)
+        {
+        ampo += -1.,"Cdagup",b,"Cup",b+1;
+        ampo += -1.,"Cdagup",b+1,"Cup",b;
+        ampo += -1.,"Cdagdn",b,"Cdn",b+1;
+        ampo += -1.,"Cdagdn",b+1,"Cdn",b;
+        }
+    return IQMPO(ampo);
+    }
+
+template<typename SiteSetT>
+InitState
+neel(SiteSetT const& sites)
+    {
+    auto state = InitState(sites);
+    for(int i = 1; i <= sites.N(); ++i) state.set(i,i%2==1 ? "Up" : "Dn");
+    return state;
+    }
+
+Sweeps
+fixedSweeps(int maxm)
+    {
+    auto sweeps = Sweeps(5);
+    sweeps.maxm() = 10,20,maxm/2,maxm;
+    sweeps.cutoff() = 1E-12;
+    sweeps.niter() = 2;
+    sweeps.noise() = 1E-7,1E-8,0.0;
+    return sweeps;
+    }
+
+Real
+runDMRG(IQMPS & psi, IQMPO const& H, Sweeps const& sweeps)
+    {
+    return dmrg(psi,H,sweeps,{"Quiet",true});
+    }
+
+void
+stateBenchmarks(BenchSuite& suite)
+    {
+    int maxm = suite.quick() ? 50 : 200;
+    auto envName = [maxm](std::string const& model)
+        { return format("contract/qdense/%s/env_m%d",model,maxm); };
+    auto svdName = [maxm](std::string const& model)
+        { return format("decomp/svd/%s/twosite_m%d",model,maxm); };
+    auto productName = [maxm](std::string const& model)
+        { return format("product/%s/m%d",model,maxm); };
+
+    //Short DMRG runs give states with realistic block
+    //structure, only computed if a benchmark using
+    //them is selected
+    auto needed = [&](std::string const& model)
+        {
+        return suite.selected(envName(model))
+            || suite.selected(svdName(model))
+            || suite.selected(productName(model));
+        };
+
+    auto models = std::vector<Model>{};
+    if(needed("SpinOne"))
+        {
+        auto sites = SpinOne(suite.quick() ? 20 : 50);
+        auto H = heisenberg(sites);
+        auto psi = IQMPS(neel(sites));
+        runDMRG(psi,H,fixedSweeps(maxm));
+        models.push_back({"SpinOne",H,psi});
+        }
+    if(needed("Hubbard"))
+        {
+        auto sites = Hubbard(suite.quick() ? 10 : 20);
+        auto H = hubbard(sites);
+        auto psi = IQMPS(neel(sites));
+        runDMRG(psi,H,fixedSweeps(maxm));
+        models.push_back({"Hubbard",H,psi});
+        }
+
+    for(auto& M : models)
+        {
+        auto& psi = M.psi;
+        auto& H = M.H;
+        auto b = psi.N()/2;
+        psi.position(b);
+
+        //Left environment up to site b-1
+        auto E = IQTensor(1.);
+        for(int j = 1; j < b; ++j)
+            {
+            E *= psi.A(j);
+            E *= H.A(j);
+            E *= dag(prime(psi.A(j)));
+            }
+        suite.run(envName(M.name),[&]
+            {
+            auto R = E*psi.A(b);
+            R *= H.A(b);
+            R *= dag(prime(psi.A(b)));
+            });
+
+        auto phi = psi.A(b)*psi.A(b+1);
+        suite.run(svdName(M.name),[&]
+            {
+            auto U = psi.A(b);
+            IQTensor S,V;
+            svd(phi,U,S,V,{"Maxm",maxm,"Cutoff",1E-12});
+            });
+
+        auto PH = LocalMPO<IQTensor>(H);
+        PH.position(b,psi);
+        suite.run(productName(M.name),[&]
+            {
+            IQTensor phip;
+            PH.product(phi,phip);
+            });
+        }
+    }
+
+//Products with the dense and sparse (see sparsempo.h)
+//forms of a long-range Hubbard cylinder MPO, without
+//quantum numbers
+void
+sparseMPOProducts(BenchSuite& suite)
+    {
+    int Nx = suite.quick() ? 4 : 6,
+        Ny = 4,
+        maxm = suite.quick() ? 50 : 100;
+    auto name = [&](std::string const& type)
+        { return format("product/HubbardLR_cyl%dx%d_%s/m%d",Nx,Ny,type,maxm); };
+    if(!suite.selected(name("dense")) && !suite.selected(name("sparse"))) return;
+
+    auto N = Nx*Ny;
+    auto sites = Hubbard(N);
+    auto ampo = AutoMPO(sites);
+    for(auto b : squareLattice(Nx,Ny,{"YPeriodic",true}))
+        {
+        ampo += -1.,"Cdagup",b.s1,"Cup",b.s2;
+        ampo += -1.,"Cdagup",b.s2,"Cup",b.s1;
+        ampo += -1.,"Cdagdn",b.s1,"Cdn",b.s2;
+        ampo += -1.,"Cdagdn",b.s2,"Cdn",b.s1;
+        }
+    for(int i = 1; i <= N; ++i) ampo += 4.,"Nupdn",i;
+    for(int i = 1; i <= N; ++i)
+    for(int j = i+1; j <= N; ++j)
+        {
+        int dx = (j-1)/Ny-(i-1)/Ny,
+            dy = std::abs((j-1)%Ny-(i-1)%Ny);
+        dy = std::min(dy,Ny-dy);
+        ampo += 1./(dx*dx+dy*dy),"Ntot",i,"Ntot",j;
+        }
+    auto H = toMPO<ITensor>(ampo);
+    auto psi = MPS(neel(sites));
+    auto sweeps = Sweeps(2);
+    sweeps.maxm() = maxm/2,maxm;
+    sweeps.cutoff() = 1E-10;
+    sweeps.niter() = 2;
+    dmrg(psi,H,sweeps,{"Quiet",true,"Silent",true});
+
+    auto b = N/2;
+    psi.position(b);
+    auto phi = psi.A(b)*psi.A(b+1);
+    for(auto sparse : {false,true})
+        {
+        auto PH = LocalMPO<ITensor>(H,{"SparseMPO",sparse});
+        PH.position(b,psi);
+        suite.run(name(sparse ? "sparse" : "dense"),[&]
+            {
+            ITensor phip;
+            PH.product(phi,phip);
+            });
+        }
+    }
+
+void
+dmrgSweeps(BenchSuite& suite)
+    {
+    int maxm = suite.quick() ? 50 : 200;
+    auto sweeps = fixedSweeps(maxm);
+        {
+        auto sites = SpinHalf(suite.quick() ? 40 : 100);
+        auto H = heisenberg(sites);
+        suite.run(format("dmrg/SpinHalf/N%d_m%d",sites.N(),maxm),[&]
+            {
+            auto psi = IQMPS(neel(sites));
+            runDMRG(psi,H,sweeps);
+            });
+        }
+        {
+        auto sites = SpinOne(suite.quick() ? 40 : 100);
+        auto H = heisenberg(sites);
+        suite.run(format("dmrg/SpinOne/N%d_m%d",sites.N(),maxm),[&]
+            {
+            auto psi = IQMPS(neel(sites));
+            runDMRG(psi,H,sweeps);
+            });
+        }
+        {
+        auto sites = Hubbard(suite.quick() ? 10 : 20);
+        auto H = hubbard(sites);
+        suite.run(format("dmrg/Hubbard/N%d_m%d",sites.N(),maxm),[&]
+            {
+            auto psi = IQMPS(neel(sites));
+            runDMRG(psi,H,sweeps);
+            });
+        }
+        {
+        //Lowest states found one at a time, each penalizing
+        //overlaps with the previous ones, and all together
+        //in a shared basis
+        auto sites = SpinOne(suite.quick() ? 20 : 40);
+        auto H = heisenberg(sites);
+        int nstate = 4;
+        auto args = Args{"Quiet",true,"Weight",10.};
+        auto name = [&](std::string const& how)
+            {
+            return format("dmrg/excited/SpinOne_N%d_m%d_%dstates_%s",sites.N(),maxm,nstate,how);
+            };
+        suite.run(name("seq"),[&]
+            {
+            auto psis = std::vector<IQMPS>{};
+            for(auto n : range(nstate))
+                {
+                auto psi = IQMPS(neel(sites));
+                if(n == 0) dmrg(psi,H,sweeps,args);
+                else       dmrg(psi,H,psis,sweeps,args);
+                psis.push_back(psi);
+                }
+            });
+        suite.run(name("batch"),[&]
+            {
+            auto psis = std::vector<IQMPS>(nstate);
+            psis.front() = IQMPS(neel(sites));
+            dmrgStates(psis,H,sweeps,args);
+            });
+        }
+    }
+
+void
+autompoBuild(BenchSuite& suite)
+    {
+    int N = suite.quick() ? 12 : 20;
+
+    //Hopping and pair interaction terms with random
+    //coefficients, O(N^4) terms in total
+    auto rng = std::mt19937(1);
+    auto U = std::uniform_real_distribution<Real>(-1,1);
+    auto terms = std::vector<HTerm>{};
+    for(int i = 1; i <= N; ++i)
+    for(int j = 1; j <= N; ++j)
+        {
+        auto t = HTerm(U(rng),{});
+        t.add("Cdag",i);
+        t.add("C",j);
+        terms.push_back(t);
+        }
+    for(int i = 1; i <= N; ++i)
+    for(int j = i+1; j <= N; ++j)
+    for(int k = 1; k <= N; ++k)
+    for(int l = k+1; l <= N; ++l)
+        {
+        auto t = HTerm(U(rng),{});
+        t.add("Cdag",i);
+        t.add("Cdag",j);
+        t.add("C",l);
+        t.add("C",k);
+        terms.push_back(t);
+        }
+
+    auto sites = Spinless(N);
+    suite.run(format("autompo/add/Spinless_N%d_each",N),[&]
+        {
+        auto ampo = AutoMPO(sites);
+        for(auto& t : terms) ampo.add(t);
+        });
+    suite.run(format("autompo/add/Spinless_N%d_batch",N),[&]
+        {
+        auto ampo = AutoMPO(sites);
+        ampo.add(terms);
+        });
+
+    //toMPO is serial unless asked for threads
+    auto nthread = std::max(1,int(std::thread::hardware_concurrency()));
+    auto ampo = AutoMPO(sites);
+    ampo.add(terms);
+    suite.run(format("autompo/toMPO/Spinless_N%d",N),[&]
+        {
+        toMPO<IQTensor>(ampo,{"Cutoff",1E-12,"NThread",nthread});
+        });
+
+    //Hubbard model on a cylinder with 1/r^2 density
+    //interactions between all pairs of sites
+    int Nx = suite.quick() ? 8 : 32,
+        Ny = 4;
+    auto hsites = Hubbard(Nx*Ny);
+    auto hampo = AutoMPO(hsites);
+    for(auto& b : squareLattice(Nx,Ny,{"YPeriodic",true}))
+        {
+        hampo += -1.,"Cdagup",b.s1,"Cup",b.s2;
+        hampo += -1.,"Cdagup",b.s2,"Cup",b.s1;
+        hampo += -1.,"Cdagdn",b.s1,"Cdn",b.s2;
+        hampo += -1.,"Cdagdn",b.s2,"Cdn",b.s1;
+        }
+    for(int i = 1; i <= Nx*Ny; ++i)
+        {
+        hampo += 4.,"Nupdn",i;
+        for(int j = i+1; j <= Nx*Ny; ++j) hampo += 1./sqr(j-i),"Ntot",i,"Ntot",j;
+        }
+    suite.run(format("autompo/toMPO/Hubbard_cyl%dx%d",Nx,Ny),[&]
+        {
+        toMPO<IQTensor>(hampo,{"NThread",nthread});
+        });
+    }
+
+void
+mpoCompression(BenchSuite& suite)
+    {
+    int N = suite.quick() ? 20 : 40;
+    auto sites = SpinHalf(N);
+    auto ampo = AutoMPO(sites);
+    for(int i = 1; i <= N; ++i)
+    for(int j = i+1; j <= std::min(N,i+8); ++j)
+        {
+        auto J = 1./sqr(j-i);
+        ampo += 0.5*J,"S+",i,"S-",j;
+        ampo += 0.5*J,"S-",i,"S+",j;
+        ampo +=     J,"Sz",i,"Sz",j;
+        }
+    auto H = IQMPO(ampo);
+    auto terms = std::vector<IQMPO>{H,H,H};
+
+    suite.run(format("mpo/sum/HeisenbergLR_N%d",N),[&]
+        {
+        sum(H,H);
+        });
+    suite.run(format("mpo/nmultMPO/HeisenbergLR_N%d",N),[&]
+        {
+        IQMPO H2;
+        nmultMPO(H,H,H2,{"Cutoff",1E-12});
+        });
+    for(auto method : {"SVD","Fit"})
+        {
+        suite.run(format("mpo/compress/%s_3terms_N%d",method,N),[&]
+            {
+            IQMPO res;
+            compressMPO(terms,res,{"Method",method});
+            });
+        }
+    }
+
+void
+timeEvolution(BenchSuite& suite)
+    {
+    int N = suite.quick() ? 20 : 40;
+    auto sites = SpinHalf(N);
+    auto bondH = std::vector<IQTensor>(N);
+    for(int b = 1; b < N; ++b)
+        {
+        bondH[b] =      sites.op("Sz",b)*sites.op("Sz",b+1);
+        bondH[b] += 0.5*sites.op("S+",b)*sites.op("S-",b+1);
+        bondH[b] += 0.5*sites.op("S-",b)*sites.op("S+",b+1);
+        }
+    auto state = InitState(sites);
+    for(int j = 1; j <= N; ++j) state.set(j,j%2==1 ? "Up" : "Dn");
+
+    int maxm = 100;
+    Real tstep = 0.05,
+         ttotal = 1.;
+    auto args = Args{"Cutoff",1E-10,"Maxm",maxm,"ShowPercent",false};
+    auto name = [&](std::string const& how)
+        {
+        return format("tevol/SpinHalf_N%d_m%d_%s",N,maxm,how);
+        };
+
+    //Second order sweep of separately built gates
+    suite.run(name("gates"),[&]
+        {
+        auto gates = std::vector<IQGate>{};
+        for(int b = 1; b < N; ++b) gates.push_back(IQGate(sites,b,b+1,IQGate::tReal,tstep/2,bondH[b]));
+        for(int b = N-1; b >= 1; --b) gates.push_back(IQGate(sites,b,b+1,IQGate::tReal,tstep/2,bondH[b]));
+        auto psi = IQMPS(state);
+        gateTEvol(gates,ttotal,tstep,psi,args);
+        });
+    for(auto order : {2,4})
+        {
+        suite.run(name(format("trotter%d",order)),[&]
+            {
+            auto gates = IQTrotter(sites,bondH,IQGate::tReal,tstep,{"Order",order});
+            auto psi = IQMPS(state);
+            gateTEvol(gates,ttotal,tstep,psi,args);
+            });
+        }
+    }
+
+void
+siteOps(BenchSuite& suite)
+    {
+    int N = 100;
+    auto sites = Hubbard(N);
+    auto names = std::vector<std::string>{"Ntot","Cdagup","Cup","F","Id","Cdagup*F","Nupdn","Sz"};
+    for(auto cached : {true,false})
+        {
+        suite.run(format("siteset/op/Hubbard_N%d_%s",N,cached ? "cached" : "uncached"),[&]
+            {
+            for(int j = 1; j <= N; ++j)
+            for(auto& nm : names)
+                {
+                if(!cached) sites.clearOpCache();
+                sites.op(nm,j);
+                }
+            });
+        }
+    }
+
+//Free energy per site log(Z)/Ns of the 2D classical
+//Ising model at temperature T from nscale steps of TRG
+//(as in tutorial/trg), with A normalized at each scale
+Real
+isingTRG(Real T, int maxm, int nscale)
+    {
+    auto x0 = Index("x0",2,Xtype),
+         y0 = Index("y0",2,Ytype);
+    auto A = ITensor(x0,prime(y0,2),prime(x0,2),y0);
+    auto Sig = [](int s) { return 1.-2.*(s-1); };
+    for(auto s1 : range1(2))
+    for(auto s2 : range1(2))
+    for(auto s3 : range1(2))
+    for(auto s4 : range1(2))
+        {
+        auto E = Sig(s1)*Sig(s2)+Sig(s2)*Sig(s3)+Sig(s3)*Sig(s4)+Sig(s4)*Sig(s1);
+        A.set(x0(s1),prime(y0,2)(s2),prime(x0,2)(s3),y0(s4),exp(-(E+4.)/T));
+        }
+
+    Real lnz = 0;
+    for(auto scale : range(nscale))
+        {
+        //A stands for 2^(nscale-scale) of the tensors at the top scale
+        auto nrm = norm(A);
+        A /= nrm;
+        lnz += log(nrm)/pow(2,1+scale);
+
+        auto x = noprime(findtype(A,Xtype)),
+             y = noprime(findtype(A,Ytype));
+        auto x2 = prime(x,2),
+             y2 = prime(y,2),
+             x3 = prime(x,3),
+             y3 = prime(y,3);
+        auto args = Args{"Maxm",maxm};
+
+        //F1 has the right and lower legs of A, F3 the
+        //left and upper; F2 the left and lower, F4 the
+        //upper and right
+        auto F1 = ITensor(x2,y),
+             F3 = ITensor(x,y2);
+        factor(A,F1,F3,{args,"IndexType",Xtype,"IndexName",format("x%d",scale+1)});
+        auto F2 = ITensor(x,y),
+             F4 = ITensor(y2,x2);
+        factor(A,F2,F4,{args,"IndexType",Ytype,"IndexName",format("y%d",scale+1)});
+        auto l13 = commonIndex(F1,F3),
+             l24 = commonIndex(F2,F4);
+
+        //Contract the four tensors around a plaquette:
+        //F4 (lower left), F3 (lower right), F2 (upper
+        //right) and F1 (upper left)
+        F3 *= delta(x,x2);
+        F3 *= delta(y2,y3);
+        F2 *= delta(y,y3);
+        F2 *= delta(x,x3);
+        F2.prime(l24,2);
+        F1 *= delta(x2,x3);
+        F1 *= delta(y,y2);
+        F1.prime(l13,2);
+        A = F4*F3*F2*F1;
+        }
+
+    auto x = noprime(findtype(A,Xtype)),
+         y = noprime(findtype(A,Ytype));
+    auto Z = (delta(x,prime(x,2))*A*delta(y,prime(y,2))).real();
+    return lnz+log(Z)/pow(2,1+nscale);
+    }
+
+void
+rescaleModes(BenchSuite& suite)
+    {
+    int m = 500,
+        k = 4;
+    auto a = Index("a",m),
+         b = Index("b",k),
+         c = Index("c",m);
+    auto Ai = randomTensor(a,b),
+         Bi = randomTensor(b,c);
+
+    int maxm = suite.quick() ? 50 : 100;
+    auto sites = SpinOne(suite.quick() ? 20 : 40);
+    auto H = heisenberg(sites);
+    auto sweeps = fixedSweeps(maxm);
+
+    int trgm = suite.quick() ? 10 : 20,
+        nscale = 12;
+
+    for(auto deferred : {false,true})
+        {
+        Global::deferRescale() = deferred;
+        auto mode = std::string(deferred ? "deferred" : "eager");
+        suite.run(format("rescale/contract/%dx%d*%dx%d_%s",m,k,k,m,mode),[&]
+            {
+            auto C = Ai*Bi;
+            });
+        suite.run(format("rescale/dmrg/SpinOne_N%d_m%d_%s",sites.N(),maxm,mode),[&]
+            {
+            auto psi = IQMPS(neel(sites));
+            runDMRG(psi,H,sweeps);
+            });
+        suite.run(format("rescale/trg/Ising_m%d_%dscales_%s",trgm,nscale,mode),[&]
+            {
+            isingTRG(3.,trgm,nscale);
+            });
+        }
+    Global::deferRescale() = true;
+    }
+
+void
+storagePooling(BenchSuite& suite)
+    {
+    int maxm = suite.quick() ? 50 : 100;
+    auto sites = SpinOne(suite.quick() ? 20 : 40);
+    auto H = heisenberg(sites);
+    auto sweeps = fixedSweeps(maxm);
+    int trgm = suite.quick() ? 10 : 20,
+        nscale = 12;
+
+    //Random environments and MPO tensors of a SpinOne
+    //chain with bond dimension m
+    int m = suite.quick() ? 50 : 100;
+    auto a = Index("a",m),
+         c = Index("c",m),
+         s1 = Index("s1",3,Site),
+         s2 = Index("s2",3,Site),
+         w0 = Index("w0",5),
+         w1 = Index("w1",5),
+         w2 = Index("w2",5);
+    auto L = randomTensor(a,prime(a),w0),
+         W1 = randomTensor(w0,s1,prime(s1),w1),
+         W2 = randomTensor(w1,s2,prime(s2),w2),
+         R = randomTensor(c,prime(c),w2);
+    auto phi = randomTensor(a,s1,s2,c);
+
+    for(auto pool : {false,true})
+        {
+        Global::poolStorage() = pool;
+        clearStoragePool();
+        auto mode = std::string(pool ? "pool" : "nopool");
+        suite.run(format("storage/product/Dense_m%d_%s",m,mode),[&]
+            {
+            auto phip = phi*L;
+            phip *= W1;
+            phip *= W2;
+            phip *= R;
+            });
+        suite.run(format("storage/dmrg/SpinOne_N%d_m%d_%s",sites.N(),maxm,mode),[&]
+            {
+            auto psi = IQMPS(neel(sites));
+            runDMRG(psi,H,sweeps);
+            });
+        suite.run(format("storage/trg/Ising_m%d_%dscales_%s",trgm,nscale,mode),[&]
+            {
+            isingTRG(3.,trgm,nscale);
+            });
+        }
+    Global::poolStorage() = true;
+    }
+
+//Heisenberg model on the physical sites of a SpinHalf
+//chain purified with ancilla sites (one per physical
+//site), as in tutorial/finiteT/ancilla.cc
+AutoMPO
+ancillaHeisenberg(SiteSet const& sites)
+    {
+    auto ampo = AutoMPO(sites);
+    for(auto j : range1(sites.N()/2-1))
+        {
+        auto s1 = 2*j-1,
+             s2 = 2*j+1;
+        ampo += 0.5,"S+",s1,"S-",s2;
+        ampo += 0.5,"S-",s1,"S+",s2;
+        ampo +=     "Sz",s1,"Sz",s2;
+        }
+    return ampo;
+    }
+
+//Imaginary time evolution from infinite temperature
+//by nt steps of expH, measuring the energy at the end
+void
+ancillaTEvol(SiteSet const& sites,
+             MPO const& H,
+             MPO const& expH,
+             int nt,
+             int maxm)
+    {
+    auto psi = MPS(sites);
+    for(int n = 1; n <= sites.N(); n += 2)
+        {
+        auto s1 = sites(n);
+        auto s2 = sites(n+1);
+        auto wf = ITensor(s1,s2);
+        wf.set(s1(1),s2(2), ISqrt2);
+        wf.set(s1(2),s2(1), -ISqrt2);
+        ITensor D;
+        psi.Aref(n) = ITensor(s1);
+        psi.Aref(n+1) = ITensor(s2);
+        svd(wf,psi.Aref(n),D,psi.Aref(n+1));
+        psi.Aref(n) *= D;
+        }
+
+    auto args = Args{"Maxm",maxm,"Cutoff",1E-11};
+    for(auto tt : range1(nt))
+        {
+        psi = exactApplyMPO(expH,psi,args);
+        psi.Aref(1) /= norm(psi.A(1));
+        if(tt == nt) overlap(psi,H,psi);
+        }
+    }
+
+void
+storageDispatch(BenchSuite& suite)
+    {
+    auto sites = SpinHalf(20);
+
+    //Long-range Heisenberg model, whose AutoMPO
+    //conversion multiplies many small operators
+    int N = suite.quick() ? 12 : 20;
+    auto hsites = SpinHalf(N);
+    auto ampo = AutoMPO(hsites);
+    for(int i = 1; i <= N; ++i)
+    for(int j = i+1; j <= N; ++j)
+        {
+        auto J = 1./sqr(j-i);
+        ampo += 0.5*J,"S+",i,"S-",j;
+        ampo += 0.5*J,"S-",i,"S+",j;
+        ampo +=     J,"Sz",i,"Sz",j;
+        }
+
+    int aN = suite.quick() ? 6 : 10,
+        nt = suite.quick() ? 5 : 10,
+        maxm = suite.quick() ? 50 : 100;
+    auto asites = SpinHalf(2*aN);
+    auto aampo = ancillaHeisenberg(asites);
+    auto aH = MPO(aampo);
+    auto expH = toExpH<ITensor>(aampo,0.1);
+
+    for(auto table : {false,true})
+        {
+        Global::tableDispatch() = table;
+        auto mode = std::string(table ? "table" : "virtual");
+        suite.run(format("dispatch/siteops/SpinHalf_N20_%s",mode),[&]
+            {
+            //Products and sums of the 2x2 operators of each site
+            for(auto j : range1(sites.N()))
+                {
+                auto Sp = sites.op("S+",j),
+                     Sm = sites.op("S-",j),
+                     Sz = sites.op("Sz",j);
+                auto S2 = multSiteOps(Sz,Sz);
+                S2 += 0.5*multSiteOps(Sp,Sm);
+                S2 += 0.5*multSiteOps(Sm,Sp);
+                if(norm(S2) == 0) Error("Zero operator");
+                }
+            });
+        suite.run(format("dispatch/toMPO/Heisenberg_1r2_N%d_%s",N,mode),[&]
+            {
+            toMPO<IQTensor>(ampo);
+            });
+        suite.run(format("dispatch/finiteT/ancilla_N%d_m%d_%s",aN,maxm,mode),[&]
+            {
+            ancillaTEvol(asites,aH,expH,nt,maxm);
+            });
+        }
+    Global::tableDispatch() = true;
+    }
+
+void
+elementwiseLoops(BenchSuite& suite)
+    {
+    int L = suite.quick() ? 100 : 160;
+    auto i = Index("i",L),
+         j = Index("j",L),
+         k = Index("k",L);
+    auto A = randomTensor(i,j,k),
+         B = randomTensor(i,j,k),
+         P = randomTensor(k,i,j);
+    auto Z = randomTensorC(i,j,k);
+    auto n = Real(L)*L*L;
+    printfln("# elementwise: %.0f elements, MB moved per call:"
+             " scale, conj %.0f; add %.0f (Real) %.0f (Cplx+=Real)",
+             n,1E-6*32*n,1E-6*24*n,1E-6*40*n);
+
+    auto maxthread = Global::elementwiseThreads();
+    auto nthreads = std::vector<int>{1};
+    if(maxthread > 1) nthreads.push_back(maxthread);
+    for(auto nthread : nthreads)
+        {
+        Global::elementwiseThreads() = nthread;
+        auto mode = format("L%d_%dthread",L,nthread);
+        suite.run("elementwise/scale/Cplx_"+mode,[&]
+            {
+            Z *= Cplx(0.,1.);
+            });
+        suite.run("elementwise/conj/Cplx_"+mode,[&]
+            {
+            Z.conj();
+            });
+        suite.run("elementwise/add/Real_"+mode,[&]
+            {
+            A += B;
+            });
+        suite.run("elementwise/add/Real_perm_"+mode,[&]
+            {
+            A += P;
+            });
+        suite.run("elementwise/add/CplxReal_"+mode,[&]
+            {
+            Z += B;
+            });
+        suite.run("elementwise/add/CplxReal_perm_"+mode,[&]
+            {
+            Z += P;
+            });
+        }
+    Global::elementwiseThreads() = maxthread;
+    }
+
+void
+diagContractions(BenchSuite& suite)
+    {
+    int m = suite.quick() ? 500 : 1000;
+    auto i = Index("i",m),
+         a = Index("a",m),
+         b = Index("b",m),
+         j = Index("j",m);
+    auto sv = std::vector<Real>(m);
+    for(auto n : range(sv)) sv[n] = 1./(1.+n);
+    auto S = diagTensor(sv,a,b);
+    auto U = randomTensor(i,a),
+         V = randomTensor(b,j);
+    suite.run(format("diag/scale_rows/m%d",m),[&]
+        {
+        auto R = U*S;
+        });
+    suite.run(format("diag/scale_cols/m%d",m),[&]
+        {
+        auto R = S*V;
+        });
+
+    int t = suite.quick() ? 60 : 100;
+    auto p = Index("p",t),
+         q = Index("q",t),
+         r = Index("r",t);
+    auto T = randomTensor(p,r,q);
+    auto d = delta(p,q);
+    suite.run(format("diag/trace/L%d",t),[&]
+        {
+        auto R = d*T;
+        });
+
+    //QN matrices with 10 sectors, from the
+    //svd of a random IQTensor
+    int sm = m/10;
+    auto qinds = [sm](std::string name)
+        {
+        auto iq = std::vector<IndexQN>{};
+        for(auto n : range(10)) iq.emplace_back(Index(nameint(name,n),sm),QN(n-5));
+        return IQIndex(name,std::move(iq));
+        };
+    auto L = qinds("L"),
+         R = qinds("R");
+    auto W = randomTensor(QN(),L,dag(R));
+    IQTensor QU(L),QS,QV;
+    svd(W,QU,QS,QV);
+    suite.run(format("diag/qscale_rows/m%d",m),[&]
+        {
+        auto P = QU*QS;
+        });
+    suite.run(format("diag/qscale_cols/m%d",m),[&]
+        {
+        auto P = QS*QV;
+        });
+
+    auto S2 = diagTensor(sv,b,j);
+    suite.run(format("diag/diag_diag/m%d",m),[&]
+        {
+        auto P = S*S2;
+        });
+    }
+
+void
+combiners(BenchSuite& suite)
+    {
+    int m = suite.quick() ? 100 : 200,
+        d = 3;
+    auto l = Index("l",m),
+         s1 = Index("s1",d),
+         s2 = Index("s2",d),
+         r = Index("r",m),
+         mid = Index("mid",m);
+    auto AA = randomTensor(l,s1,s2,r);
+    printfln("# combine: dense AA is %.1f MB",1E-6*8*area(AA.inds()));
+    auto shape = format("%dx%dx%dx%d",m,d,d,m);
+    auto C = combiner(l,s2);
+    suite.run("combine/dense/perm_"+shape,[&]
+        {
+        auto R = AA*C;
+        });
+    suite.run("combine/denmat_reordered/"+shape,[&]
+        {
+        auto A = ITensor(s1,l,mid),
+             B = ITensor(mid,s2,r);
+        denmatDecomp(AA,A,B,Fromleft);
+        });
+
+    //QN tensor with 10 sectors on each link
+    int qm = m/10;
+    auto qlink = [qm](std::string name)
+        {
+        auto iq = std::vector<IndexQN>{};
+        for(auto n : range(10)) iq.emplace_back(Index(nameint(name,n),qm),QN(n-5));
+        return IQIndex(name,std::move(iq));
+        };
+    auto qsite = [](std::string name)
+        {
+        return IQIndex(name,Index(name+"+",1,Site),QN(+1),
+                            Index(name+"0",1,Site),QN( 0),
+                            Index(name+"-",1,Site),QN(-1));
+        };
+    auto L = qlink("L"),
+         R = qlink("R"),
+         Q1 = qsite("Q1"),
+         Q2 = qsite("Q2");
+    auto QAA = randomTensor(QN(),L,Q1,Q2,dag(R));
+    auto QC = combiner(L,Q2);
+    suite.run("combine/qdense/perm_"+shape,[&]
+        {
+        auto P = QAA*QC;
+        });
+    auto QAAc = QAA*QC;
+    suite.run("combine/qdense/uncombine_"+shape,[&]
+        {
+        auto P = QAAc*dag(QC);
+        });
+    }
+
+void
+rankKernels(BenchSuite& suite)
+    {
+    //Reverses the index order of a tensor with extents dims
+    auto permBench = [&suite](std::vector<long> const& dims)
+        {
+        auto r = long(dims.size());
+        auto T = randomTen(dims);
+        auto P = Permutation(r);
+        for(auto n : range(r)) P.setFromTo(n,r-1-n);
+        auto R = permuteExtents(T.range(),P);
+        auto out = Tensor(std::vector<Real>(area(R)),std::move(R));
+        auto reps = std::max(1l,100000l/long(T.size()));
+        suite.run(format("permute/r%d_%s_x%d",r,dimString(dims),reps),[&,reps]
+            {
+            for(auto rep : range(reps))
+                {
+                (void)rep;
+                makeRef(out) &= permute(makeRef(T),P);
+                }
+            });
+        };
+    permBench({2,3,2,3,2,3});
+    permBench({20,20,20});
+    permBench({8,8,8,8});
+    permBench({5,5,5,5,5});
+    permBench({4,4,4,4,4,4});
+    if(!suite.quick()) permBench({200,3,3,200});
+
+    //QN tensors whose links have nsec sectors of size
+    //1 or 2, contracted over two indices
+    auto link = [](std::string name, int nsec)
+        {
+        auto iq = std::vector<IndexQN>{};
+        for(auto n : range(nsec)) iq.emplace_back(Index(nameint(name,n),1+n%2),QN(n-nsec/2));
+        return IQIndex(name,std::move(iq));
+        };
+        {
+        auto a = link("a",20),
+             b = link("b",20),
+             c = link("c",20),
+             d = link("d",20),
+             e = link("e",20);
+        auto A = randomTensor(QN(),a,b,dag(c),dag(d)),
+             B = randomTensor(QN(),c,d,dag(e),dag(prime(a)));
+        suite.run("blocks/contract/r4_20sectors",[&]
+            {
+            auto C = A*B;
+            });
+        }
+        {
+        auto a = link("a",6),
+             b = link("b",6),
+             c = link("c",6);
+        auto A = randomTensor(QN(),a,dag(prime(a)),b,dag(prime(b)),c,dag(prime(c))),
+             B = randomTensor(QN(),prime(a),dag(prime(a,2)),prime(b),dag(prime(b,2)));
+        suite.run("blocks/contract/r6_6sectors",[&]
+            {
+            auto C = A*B;
+            });
+        }
+    }
+
+void
+indexCreation(BenchSuite& suite)
+    {
+    int n = 1000000;
+    suite.run(format("index/new/%d",n),[n]
+        {
+        Index::id_type sum = 0;
+        for(int j = 0; j < n; ++j) sum += Index("i",2).id();
+        if(sum == 1) println();
+        });
+    auto ncore = std::max(1,int(std::thread::hardware_concurrency()));
+    if(ncore > 1)
+        {
+        suite.run(format("index/new/%d_%dthread",n,ncore),[n,ncore]
+            {
+            runJobs(ncore,[n](int)
+                {
+                Index::id_type sum = 0;
+                for(int j = 0; j < n; ++j) sum += Index("i",2).id();
+                if(sum == 1) println();
+                },
+                {"Threads",ncore});
+            });
+        }
+    }
+
+void
+independentJobs(BenchSuite& suite)
+    {
+    int N = suite.quick() ? 16 : 32,
+        maxm = suite.quick() ? 20 : 40;
+    auto sweeps = fixedSweeps(maxm);
+    auto sites = SpinHalf(N);
+    auto H = heisenberg(sites);
+
+    auto ncore = std::max(1,int(std::thread::hardware_concurrency()));
+    int njobs = std::max(8,ncore);
+    auto nthreads = std::vector<int>{};
+    for(int t = 1; t < ncore; t *= 2) nthreads.push_back(t);
+    nthreads.push_back(ncore);
+    for(auto nthread : nthreads)
+        {
+        suite.run(format("jobs/dmrg/N%d_m%d_%djobs_%dthread",N,maxm,njobs,nthread),[&]
+            {
+            runJobs(njobs,[&](int job)
+                {
+                auto psi = IQMPS(neel(sites));
+                runDMRG(psi,H,sweeps);
+                },
+                {"Threads",nthread});
+            });
+        }
+    }
+
+int
+main(int argc, char* argv[])
+    {
+    auto suite = BenchSuite(argc,argv);
+
+    denseContractions(suite);
+    decompositions(suite);
+    stateBenchmarks(suite);
+    sparseMPOProducts(suite);
+    dmrgSweeps(suite);
+    autompoBuild(suite);
+    mpoCompression(suite);
+    timeEvolution(suite);
+    siteOps(suite);
+    rescaleModes(suite);
+    storagePooling(suite);
+    storageDispatch(suite);
+    elementwiseLoops(suite);
+    diagContractions(suite);
+    combiners(suite);
+    rankKernels(suite);
+    indexCreation(suite);
+    independentJobs(suite);
+
+    return suite.finish() > 0 ? 1 : 0;
+    }
@@ -33,6 +33,7 @@
 #include "itensor/mps/lattice/triangular.h"
 
 #include "itensor/mps/sites/spinhalf.h"
+#include "itensor/mps/sites/spinhalfsu2.h"
 #include "itensor/mps/sites/spinone.h"
 #include "itensor/mps/sites/hubbard.h"
 #include "itensor/mps/sites/spinless.h"
@@ -102,6 +102,54 @@ doTask(GetBlocks<Real> const& G, QDense<Real> const& d);
 template vector<Rank2Block<Cplx>>
 doTask(GetBlocks<Cplx> const& G, QDense<Cplx> const& d);
 
+//Blocks of reduced elements; rank 2 blocks
+//have no intermediate spins, so block[0] and
+//block[1] are the sectors of the two indices
+template<typename T>
+vector<Rank2Block<T>>
+doTask(GetBlocks<T> const& G, 
+       SU2Dense<T> const& d)
+    {
+    if(G.is.r() != 2) Error("doTask(GetBlocks,SU2Dense) only supports rank 2");
+    auto res = vector<Rank2Block<T>>{d.offsets.size()};
+    size_t n = 0;
+    for(auto& dio : d.offsets)
+        {
+        auto& R = res[n++];
+        R.i1 = dio.block[0];
+        R.i2 = dio.block[1];
+        auto nrow = G.is[0][R.i1].m();
+        auto ncol = G.is[1][R.i2].m();
+        R.M = makeMatRef(d.data()+dio.offset,d.size()-dio.offset,nrow,ncol);
+        }
+    if(G.transpose) 
+        {
+        for(auto& R : res) 
+            {
+            R.M = transpose(R.M);
+            std::swap(R.i1,R.i2);
+            }
+        }
+    return res;
+    }
+template vector<Rank2Block<Real>>
+doTask(GetBlocks<Real> const& G, SU2Dense<Real> const& d);
+template vector<Rank2Block<Cplx>>
+doTask(GetBlocks<Cplx> const& G, SU2Dense<Cplx> const& d);
+
+namespace detail {
+
+IQTensor
+svdCombiner(IQTensor const& AA,
+            std::vector<IQIndex> inds,
+            Args const& args)
+    {
+    if(isSU2(AA)) return su2Combiner(std::move(inds),args);
+    return combiner(std::move(inds),args);
+    }
+
+} //namespace detail
+
 ///////////////
 
 
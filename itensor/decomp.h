@@ -5,6 +5,7 @@
 #ifndef __ITENSOR_DECOMP_H
 #define __ITENSOR_DECOMP_H
 #include "itensor/iqtensor.h"
+#include "itensor/su2tensor.h"
 #include "itensor/spectrum.h"
 #include "itensor/mps/localop.h"
 
@@ -163,6 +164,25 @@ svdRank2(ITensorT<IndexT> const& A,
          ITensorT<IndexT> & V,
          Args args = Args::global());
 
+namespace detail {
+
+//Combiner used by svd to make AA rank 2
+ITensor inline
+svdCombiner(ITensor const& AA,
+            std::vector<Index> inds,
+            Args const& args)
+    {
+    return combiner(std::move(inds),args);
+    }
+
+//Uses su2Combiner if AA has SU(2) symmetry
+IQTensor
+svdCombiner(IQTensor const& AA,
+            std::vector<IQIndex> inds,
+            Args const& args);
+
+} //namespace detail
+
 template<class Tensor>
 Spectrum 
 svd(Tensor AA, 
@@ -208,12 +228,12 @@ svd(Tensor AA,
            Vcomb;
     if(!Uinds.empty())
         {
-        Ucomb = combiner(std::move(Uinds),{"IndexName","uc"});
+        Ucomb = detail::svdCombiner(AA,std::move(Uinds),{"IndexName","uc"});
         AA *= Ucomb;
         }
     if(!Vinds.empty())
         {
-        Vcomb = combiner(std::move(Vinds),{"IndexName","vc"});
+        Vcomb = detail::svdCombiner(AA,std::move(Vinds),{"IndexName","vc"});
         AA *= Vcomb;
         }
 
@@ -258,6 +278,7 @@ denmatDecomp(Tensor const& AA,
              BigMatrixT const& PH,
              Args args)
     {
+    PROFILE_SCOPE("denmatDecomp")
     using IndexT = typename Tensor::index_type;
 
     auto noise = args.getReal("Noise",0.);
@@ -276,14 +297,16 @@ denmatDecomp(Tensor const& AA,
     
     auto& activeInds = (to_orth ? to_orth : AA).inds();
 
+    //Take the indices in the order they have on AA, so
+    //that if they are adjacent there the combiner only
+    //relabels AA instead of permuting its data
     auto cinds = stdx::reserve_vector<IndexT>(activeInds.r());
-    for(auto& I : activeInds)
+    for(auto& I : AA.inds())
         {
-        if(!hasindex(newoc,I)) cinds.push_back(I);
+        if(hasindex(activeInds,I) && !hasindex(newoc,I)) cinds.push_back(I);
         }
 
     //Apply combiner
-    START_TIMER(8)
     auto iname = args.getString("IndexName",mid ? mid.rawname() : "mid");
     auto cmb = combiner(std::move(cinds),iname);
     auto ci = cmb.inds().front();
@@ -302,8 +325,6 @@ denmatDecomp(Tensor const& AA,
         if(tr > 1E-16) rho *= 1./tr;
         }
 
-    STOP_TIMER(8)
-
     if(args.getBool("UseOrigM",false))
         {
         args.add("Cutoff",-1);
@@ -448,6 +469,11 @@ std::vector<Rank2Block<T>>
 doTask(GetBlocks<T> const& G, 
        QDense<T> const& d);
 
+template<typename T>
+std::vector<Rank2Block<T>>
+doTask(GetBlocks<T> const& G, 
+       SU2Dense<T> const& d);
+
 void
 showEigs(Vector const& P,
          Real truncerr,
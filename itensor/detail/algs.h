@@ -73,10 +73,11 @@ contains(const Container& C,
     }
 
 //Simple linear congruential random number generator
+//(with a separate seed for each thread)
 inline int&
 seed_quickran(int newseed)
     {
-    static int seed = (std::time(NULL) + getpid());
+    static thread_local int seed = (std::time(NULL) + getpid());
     if(newseed != 0) seed = newseed;
     return seed;
     }
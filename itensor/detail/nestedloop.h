@@ -0,0 +1,138 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#ifndef __ITENSOR_NESTEDLOOP_H
+#define __ITENSOR_NESTEDLOOP_H
+
+#include <cstddef>
+#include <vector>
+
+namespace itensor {
+namespace detail {
+
+//
+// Loops over all values of r indices, with index 0
+// varying fastest (as RangeIter and GCounter do),
+// calling f(o1,o2) with the offsets
+//
+//   o1 = i[0]*s1[0] + ... + i[r-1]*s1[r-1]
+//   o2 = i[0]*s2[0] + ... + i[r-1]*s2[r-1]
+//
+// of the current values i into two strided arrays.
+//
+// The offsets are updated incrementally, one addition
+// per step, instead of being recomputed from i. For
+// r <= maxNestedRank the counter has a rank known at
+// compile time (NestedLoop<r>), so its arrays live in
+// registers and the carry loop is unrolled; larger r
+// use a counter of run-time size.
+//
+
+const size_t maxNestedRank = 6;
+
+template<size_t R>
+struct NestedLoop
+    {
+    template<typename Func>
+    static void
+    run(size_t const* ext,
+        size_t const* s1,
+        size_t const* s2,
+        Func & f)
+        {
+        size_t e[R], t1[R], t2[R], i[R];
+        for(size_t n = 0; n < R; ++n)
+            {
+            if(ext[n] == 0) return;
+            e[n] = ext[n];
+            t1[n] = s1[n];
+            t2[n] = s2[n];
+            i[n] = 0;
+            }
+        size_t o1 = 0,
+               o2 = 0;
+        while(true)
+            {
+            f(o1,o2);
+            size_t n = 0;
+            for(; n < R; ++n)
+                {
+                o1 += t1[n];
+                o2 += t2[n];
+                if(++i[n] < e[n]) break;
+                o1 -= e[n]*t1[n];
+                o2 -= e[n]*t2[n];
+                i[n] = 0;
+                }
+            if(n == R) return;
+            }
+        }
+    };
+
+template<>
+struct NestedLoop<0>
+    {
+    template<typename Func>
+    static void
+    run(size_t const*, size_t const*, size_t const*, Func & f)
+        {
+        f(0,0);
+        }
+    };
+
+template<typename Func>
+void
+nestedLoopGeneral(size_t r,
+                  size_t const* ext,
+                  size_t const* s1,
+                  size_t const* s2,
+                  Func & f)
+    {
+    for(size_t n = 0; n < r; ++n) if(ext[n] == 0) return;
+    auto i = std::vector<size_t>(r,0);
+    size_t o1 = 0,
+           o2 = 0;
+    while(true)
+        {
+        f(o1,o2);
+        size_t n = 0;
+        for(; n < r; ++n)
+            {
+            ++i[n];
+            o1 += s1[n];
+            o2 += s2[n];
+            if(i[n] < ext[n]) break;
+            o1 -= ext[n]*s1[n];
+            o2 -= ext[n]*s2[n];
+            i[n] = 0;
+            }
+        if(n == r) return;
+        }
+    }
+
+template<typename Func>
+void
+nestedLoop(size_t r,
+           size_t const* ext,
+           size_t const* s1,
+           size_t const* s2,
+           Func && f)
+    {
+    switch(r)
+        {
+        case 0: NestedLoop<0>::run(ext,s1,s2,f); return;
+        case 1: NestedLoop<1>::run(ext,s1,s2,f); return;
+        case 2: NestedLoop<2>::run(ext,s1,s2,f); return;
+        case 3: NestedLoop<3>::run(ext,s1,s2,f); return;
+        case 4: NestedLoop<4>::run(ext,s1,s2,f); return;
+        case 5: NestedLoop<5>::run(ext,s1,s2,f); return;
+        case 6: NestedLoop<6>::run(ext,s1,s2,f); return;
+        default: nestedLoopGeneral(r,ext,s1,s2,f);
+        }
+    }
+
+} //namespace detail
+} //namespace itensor
+
+#endif
@@ -64,6 +64,7 @@ davidson(BigMatrixT const& A,
          std::vector<Tensor>& phi,
          Args const& args)
     {
+    PROFILE_SCOPE("davidson")
     auto maxiter_ = args.getInt("MaxIter",2);
     auto errgoal_ = args.getReal("ErrGoal",1E-14);
     auto debug_level_ = args.getInt("DebugLevel",-1);
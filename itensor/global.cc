@@ -1,3 +1,5 @@
+#include <atomic>
+#include <thread>
 #include "itensor/global.h"
 
 namespace itensor {
@@ -9,27 +11,63 @@ Global::checkArrows()
     return checkArrows_;
     }
 bool&
+Global::blockTable()
+    {
+    static bool blockTable_ = false;
+    return blockTable_;
+    }
+bool&
+Global::deferRescale()
+    {
+    static bool deferRescale_ = true;
+    return deferRescale_;
+    }
+bool&
+Global::poolStorage()
+    {
+    static bool poolStorage_ = true;
+    return poolStorage_;
+    }
+size_t&
+Global::storagePoolBytes()
+    {
+    static size_t storagePoolBytes_ = 512*1024*1024;
+    return storagePoolBytes_;
+    }
+bool&
+Global::tableDispatch()
+    {
+    static bool tableDispatch_ = true;
+    return tableDispatch_;
+    }
+int&
+Global::elementwiseThreads()
+    {
+    static int elementwiseThreads_ = 1;
+    return elementwiseThreads_;
+    }
+bool&
 Global::debug1()
     {
-    static bool debug1_ = false;
+    static thread_local bool debug1_ = false;
     return debug1_;
     }
 bool&
 Global::debug2()
     {
-    static bool debug2_ = false;
+    static thread_local bool debug2_ = false;
     return debug2_;
     }
 bool&
 Global::debug3()
     {
-    static bool debug3_ = false;
+    static thread_local bool debug3_ = false;
     return debug3_;
     }
 bool&
 Global::debug4()
     {
-    static bool debug4_ = false;
+    static thread_local bool debug4_ = false;
     return debug4_;
     }
 //Global named arguments
@@ -61,7 +99,7 @@ Global::args(const Args::Name& name, const std::string& sval)
 bool&
 Global::printdat()
     {
-    static bool printdat_ = false;
+    static thread_local bool printdat_ = false;
     return printdat_;
     }
 Real&
@@ -82,8 +120,11 @@ Global::random(int seed)
     using Generator = std::mt19937;
     using Distribution = std::uniform_real_distribution<Real>;
 
-    static Generator rng(std::time(NULL)+getpid());
-    static Distribution dist(0,1);
+    //Each thread has its own generator, so that threads
+    //seeded with seedRNG draw reproducible sequences
+    static thread_local Generator rng(std::time(NULL)+getpid()
+                                      +std::hash<std::thread::id>()(std::this_thread::get_id()));
+    static thread_local Distribution dist(0,1);
 
     if(seed != 0)  //reseed rng
         {
@@ -95,11 +136,10 @@ Global::random(int seed)
 void
 Global::warnDeprecated(const std::string& message)
     {
-    static int depcount = 1;
-    if(depcount <= 10)
+    static std::atomic<int> depcount(1);
+    if(depcount++ <= 10)
         {
         println("\n\n",message,"\n");
-        ++depcount;
         }
     }
 bool&
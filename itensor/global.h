@@ -82,10 +82,48 @@ const int MAX_M = 5000;
 enum Printdat { ShowData, HideData };
 
 
+//
+// Global settings and state
+//
+// The switches from checkArrows to elementwiseThreads
+// (and printScale, showIDs, read32BitIDs) are shared
+// by all threads; set them before starting threads
+// which use ITensor. The debug flags, printdat and the
+// random number generator belong to the calling thread,
+// and Global::args() is the calling thread's global
+// Args (see ScopedGlobalArgs in util/args.h), so
+// independent computations can run on separate threads.
+//
+
 class Global
     {
     public:
     static bool& checkArrows();
+    //Use direct lookup tables (BlockOffsets) to find
+    //blocks when contracting block-sparse tensors
+    //(default false: the tables are built for each
+    //contraction, which has not been measured to pay off)
+    static bool& blockTable();
+    //Only rescale the result of a contraction when
+    //its norm approaches overflow (above 1E30), instead
+    //of normalizing every result (see computeScalefac)
+    static bool& deferRescale();
+    //Reuse the data buffers of destroyed Dense and
+    //QDense storage (see itdata/storagepool.h)
+    static bool& poolStorage();
+    //Most bytes of buffers kept by the storage pool
+    //of each thread (default 512 MB)
+    static size_t& storagePoolBytes();
+    //Look up doTask implementations in static tables
+    //indexed by storage type (see itdata/dotask.h)
+    //instead of through virtual plugInto/applyTo calls
+    static bool& tableDispatch();
+    //Maximum number of threads used by loops over the
+    //elements of large tensors (see tensor/elementwise.h);
+    //default 1, since these loops compete for cores with
+    //threaded BLAS and with user threads
+    static int& elementwiseThreads();
+    //Per-thread debugging flags
     static bool& debug1();
     static bool& debug2();
     static bool& debug3();
@@ -101,6 +139,8 @@ class Global
     static bool& printdat();
     static Real& printScale();
     static bool& showIDs();
+    //Uniform random number in [0,1) from a generator
+    //of the calling thread, reseeded if seed != 0
     static Real random(int seed = 0);
     void static warnDeprecated(const std::string& message);
     static bool& read32BitIDs();
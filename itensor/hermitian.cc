@@ -33,6 +33,7 @@ diagHImpl(ITensor H,
           ITensor& D,
           Args const& args)
     {
+    PROFILE_SCOPE("diagHermitian")
     auto cutoff = args.getReal("Cutoff",0.);
     auto maxm = args.getInt("Maxm",H.inds().front().m());
     auto minm = args.getInt("Minm",1);
@@ -130,7 +131,7 @@ diagHImpl(IQTensor    H,
           IQTensor  & D,
           Args const& args)
     {
-    SCOPED_TIMER(7)
+    PROFILE_SCOPE("diagHermitian")
     auto cutoff = args.getReal("Cutoff",0.);
     auto maxm = args.getInt("Maxm",MAX_INT);
     auto minm = args.getInt("Minm",1);
@@ -2,6 +2,9 @@
 // Distributed under the ITensor Library License, Version 1.2
 //    (See accompanying LICENSE file.)
 //
+#include <atomic>
+#include <chrono>
+#include <unistd.h>
 #include "itensor/index.h"
 #include "itensor/util/readwrite.h"
 
@@ -46,11 +49,71 @@ nameint(string const& f, int n)
 
 
 
+namespace {
+
+using id_type = Index::id_type;
+
+//Counter values of seeded streams have the top bit
+//set; the default counter starts below 2^62, so it
+//cannot reach them
+const id_type seededBit = 1ul << 63;
+const int streamBits = 40;
+const unsigned long maxStream = 1ul << 23;
+
+std::atomic<id_type>&
+nextIDBlock()
+    {
+    static std::atomic<id_type> next(
+        [] {
+           auto t = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+           auto r = detail::BlockID::mix(id_type(t)^(id_type(getpid()) << 32));
+           return (r & ((1ul << 62)-1)) | 1ul;
+           }());
+    return next;
+    }
+
+thread_local Index::IDGenerator idgen_;
+
+} //namespace
+
+void detail::BlockID::
+newBlock()
+    {
+    if(seeded_) Error("Seeded stream of Index IDs used up (2^40 IDs)");
+    next_ = nextIDBlock().fetch_add(blockSize,std::memory_order_relaxed);
+    end_ = next_+blockSize;
+    }
+
+void detail::BlockID::
+seed(unsigned long s)
+    {
+    seeded_ = (s != 0);
+    if(s == 0)
+        {
+        next_ = end_ = 0;
+        return;
+        }
+    next_ = seededBit | (id_type(s % maxStream) << streamBits);
+    end_ = next_+(1ul << streamBits);
+    }
+
+void
+seedIndexIDs(unsigned long seed) { idgen_.seed(seed); }
+
+ScopedIndexIDs::
+ScopedIndexIDs(unsigned long seed)
+  : prev_(idgen_)
+    {
+    idgen_.seed(seed);
+    }
+
+ScopedIndexIDs::
+~ScopedIndexIDs() { idgen_ = prev_; }
+
 Index::id_type Index::
 generateID()
     {
-    static thread_local Index::IDGenerator G;
-    return G();
+    return idgen_();
     }
 
 Index::
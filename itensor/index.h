@@ -49,6 +49,59 @@ namespace detail {
         private:
         result_type id = 0;
         };
+
+    //
+    // Generator of the IDs of new Index objects.
+    //
+    // IDs are a bijective hash (the splitmix64 finalizer)
+    // of distinct 64 bit counter values, so they look
+    // random, as hash-ordered containers expect, yet
+    // never repeat. By default each thread takes ranges
+    // of blockSize counter values from a process-wide
+    // atomic counter, which starts at a random value
+    // so that IDs also differ between runs; no locks
+    // are needed and IDs are unique across threads.
+    //
+    // After seed(s), s != 0, the IDs come instead from
+    // a stream of 2^40 counter values fixed by s (and
+    // disjoint from those of the default mode and of
+    // other seeds modulo 2^23), making runs reproducible.
+    // Using up a seeded stream is an error.
+    //
+    struct BlockID
+        {
+        using result_type = std::uint_fast64_t;
+
+        static const result_type blockSize = 1ul << 16;
+
+        result_type
+        operator()()
+            {
+            if(next_ == end_) newBlock();
+            return mix(next_++);
+            }
+
+        //Switch to the stream of IDs determined by s,
+        //or back to the default unique IDs if s == 0
+        void
+        seed(unsigned long s);
+
+        static result_type
+        mix(result_type x)
+            {
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ul;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebul;
+            return x ^ (x >> 31);
+            }
+
+        private:
+        result_type next_ = 0,
+                    end_ = 0;
+        bool seeded_ = false;
+
+        void
+        newBlock();
+        };
     } //namespace detail
 
 //
@@ -64,7 +117,7 @@ namespace detail {
 class Index
     {
     public:
-    using IDGenerator = detail::RandomID;
+    using IDGenerator = detail::BlockID;
     using id_type = IDGenerator::result_type;
     using indexval_type = IndexVal;
     using prime_type = int;
@@ -182,6 +235,32 @@ class Index
 
     }; //class Index
 
+//Make the IDs of Index objects created from now on
+//by the calling thread a reproducible sequence
+//determined by seed (see detail::BlockID), or with
+//seed == 0 return to the default unique random IDs.
+//Threads seeded with the same value create the same
+//IDs, so give each thread a different seed.
+void
+seedIndexIDs(unsigned long seed);
+
+//Seeds the Index IDs of the calling thread as
+//seedIndexIDs(seed) does, until destroyed
+class ScopedIndexIDs
+    {
+    Index::IDGenerator prev_;
+    public:
+
+    explicit
+    ScopedIndexIDs(unsigned long seed);
+
+    ~ScopedIndexIDs();
+
+    ScopedIndexIDs(ScopedIndexIDs const&) = delete;
+    ScopedIndexIDs&
+    operator=(ScopedIndexIDs const&) = delete;
+    };
+
 // i1 compares equal to i2 if i2 is a copy of i1 with same primelevel
 bool 
 operator==(Index const& i1, Index const& i2);
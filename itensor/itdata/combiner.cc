@@ -37,9 +37,12 @@ permuteStore(Dense<T>   const& d,
              Permutation const& P,
              ManageStore      & m)
     {
+    //Permute in one pass into a buffer from the
+    //storage pool, rather than a freshly allocated one
     auto tfrom = makeTenRef(d.data(),d.size(),&dis);
-    auto to = Ten<Range,T>(permute(tfrom,P));
-    m.makeNewData<Dense<T>>(move(to.storage()));
+    auto Rto = permuteExtents(tfrom.range(),P);
+    auto nd = m.makeNewData<Dense<T>>(UninitStorage{},d.size());
+    makeTenRef(nd->data(),nd->size(),&Rto) &= permute(tfrom,P);
     }
 
 template<typename Storage>
@@ -97,7 +97,7 @@ doTask(Fill<Cplx> const& f, DenseCplx & D)
 void
 doTask(Mult<Cplx> const& M, Dense<Cplx> & D)
     {
-    for(auto& el : D) el *= M.x;
+    scaleElements(D.data(),D.size(),M.x);
     }
 void
 doTask(Mult<Cplx> const& M, Dense<Real> const& D, ManageStore & m)
@@ -140,7 +140,7 @@ doTask(Conj,DenseReal const& D) { /*Nothing to conj*/ }
 void
 doTask(Conj,DenseCplx & D) 
     { 
-    for(auto& el : D) el = std::conj(el);
+    conjElements(D.data(),D.size());
     }
 
 void
@@ -245,6 +245,7 @@ doTask(Contract<Index> & C,
        Dense<T2> const& R,
        ManageStore & m)
     {
+    PROFILE_SCOPE("contract")
     //if(not C.needresult)
     //    {
     //    m.makeNewData<ITLazy>(C.Lis,m.parg1(),C.Ris,m.parg2());
@@ -283,22 +284,21 @@ doTask(Contract<Index> & C,
     auto tL = makeTenRef(L.data(),L.size(),&C.Lis);
     auto tR = makeTenRef(R.data(),R.size(),&C.Ris);
     auto rsize = area(C.Nis);
-    START_TIMER(4)
-    auto nd = m.makeNewData<Dense<common_type<T1,T2>>>(rsize);
-    STOP_TIMER(4)
+    //contract overwrites every element of the result
+    auto nd = m.makeNewData<Dense<common_type<T1,T2>>>(UninitStorage{},rsize);
     auto tN = makeTenRef(nd->data(),nd->size(),&(C.Nis));
 
 #ifdef COLLECT_TSTATS
     tstats(tL,Lind,tR,Rind,tN,Nind);
 #endif
 
-    START_TIMER(2)
     contract(tL,Lind,tR,Rind,tN,Nind);
-    STOP_TIMER(2)
 
-    START_TIMER(3)
-    if(rsize > 1) C.scalefac = computeScalefac(*nd);
-    STOP_TIMER(3)
+    if(rsize > 1) 
+        {
+        PROFILE_SCOPE("scalefac",2.*rsize,sizeof(common_type<T1,T2>)*rsize)
+        C.scalefac = computeScalefac(*nd);
+        }
     }
 template void doTask(Contract<Index>&,DenseReal const&,DenseReal const&,ManageStore&);
 template void doTask(Contract<Index>&,DenseCplx const&,DenseReal const&,ManageStore&);
@@ -357,6 +357,10 @@ add(PlusEQ<Index> const& P,
         auto d2 = realData(D2);
         daxpy_wrapper(d1.size(),P.fac(),d2.data(),1,d1.data(),1);
         }
+    else if(isTrivial(P.perm()))
+        {
+        transformElements(D2.data(),D1.data(),D1.size(),Adder{P.fac()});
+        }
     else
         {
         auto ref1 = makeTenRef(D1.data(),D1.size(),&P.is1());
@@ -9,6 +9,7 @@
 #include "itensor/util/readwrite.h"
 #include "itensor/detail/call_rewrite.h"
 #include "itensor/itdata/itdata.h"
+#include "itensor/itdata/storagepool.h"
 
 namespace itensor {
 
@@ -42,8 +43,13 @@ class Dense
 
     Dense() { }
 
+    //Buffers of the size and copy constructors
+    //come from the storage pool, and are returned
+    //to it on destruction
     explicit
-    Dense(size_t size) : store(size) { }
+    Dense(size_t size) : store(acquireStorage<value_type>(size)) { }
+
+    Dense(UninitStorage u, size_t size) : store(acquireStorage<value_type>(size,u)) { }
 
     Dense(size_t size, value_type val) 
       : store(size,val)
@@ -54,6 +60,35 @@ class Dense
 
     Dense(storage_type&& data) : store(std::move(data)) { }
 
+    Dense(Dense const& other) : store(copyStorage(other.store)) { }
+
+    Dense(Dense&& other) = default;
+
+    //Assignment returns the old buffer to the pool
+    Dense&
+    operator=(Dense const& other)
+        {
+        if(this != &other)
+            {
+            releaseStorage(store);
+            store = copyStorage(other.store);
+            }
+        return *this;
+        }
+
+    Dense&
+    operator=(Dense&& other)
+        {
+        if(this != &other)
+            {
+            releaseStorage(store);
+            store = std::move(other.store);
+            }
+        return *this;
+        }
+
+    ~Dense() { releaseStorage(store); }
+
     //
     //std container like methods
     //
@@ -140,6 +175,24 @@ write(std::ostream& s, Dense<T> const& dat)
     itensor::write(s,dat.store);
     }
 
+template<typename T>
+Datac
+writeHeader(std::ostream& s, Dense<T> const& dat)
+    {
+    itensor::write(s,dat.store.size());
+    return realData(dat);
+    }
+
+template<typename T>
+Data
+readHeader(std::istream& s, Dense<T> & dat)
+    {
+    auto size = dat.store.size();
+    itensor::read(s,size);
+    dat.store.resize(size);
+    return realData(dat);
+    }
+
 template<typename F, typename T>
 void
 doTask(ApplyIT<F>& A, Dense<T> const& d, ManageStore & m)
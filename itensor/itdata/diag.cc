@@ -165,6 +165,92 @@ template void doTask(Contract<Index>&, Diag<Real> const&, Dense<Cplx> const&, Ma
 template void doTask(Contract<Index>&, Diag<Cplx> const&, Dense<Real> const&, ManageStore&);
 template void doTask(Contract<Index>&, Diag<Cplx> const&, Dense<Cplx> const&, ManageStore&);
 
+template<typename T1, typename T2, typename T3>
+void
+contractDiagDiag(Diag<T1> const& A,
+                 Diag<T2> const& B,
+                 VecRef<T3> const& C)
+    {
+    auto ua = UnifVecWrapper<T1>(A.val,A.length);
+    auto ub = UnifVecWrapper<T2>(B.val,B.length);
+    auto ra = makeVecRefc(A.data(),A.size());
+    auto rb = makeVecRefc(B.data(),B.size());
+    if(A.allSame() && B.allSame()) contractDiagDiag(ua,ub,C);
+    else if(A.allSame())           contractDiagDiag(ua,rb,C);
+    else if(B.allSame())           contractDiagDiag(ra,ub,C);
+    else                           contractDiagDiag(ra,rb,C);
+    }
+
+template<typename T1, typename T2, typename T3>
+void
+contractDiagOuter(Diag<T1> const& A, size_t astride,
+                  Diag<T2> const& B, size_t bstride,
+                  VecRef<T3> const& C)
+    {
+    auto ua = UnifVecWrapper<T1>(A.val,A.length);
+    auto ub = UnifVecWrapper<T2>(B.val,B.length);
+    auto ra = makeVecRefc(A.data(),A.size());
+    auto rb = makeVecRefc(B.data(),B.size());
+    if(A.allSame() && B.allSame()) contractDiagOuter(ua,astride,ub,bstride,C);
+    else if(A.allSame())           contractDiagOuter(ua,astride,rb,bstride,C);
+    else if(B.allSame())           contractDiagOuter(ra,astride,ub,bstride,C);
+    else                           contractDiagOuter(ra,astride,rb,bstride,C);
+    }
+
+template<typename T1, typename T2>
+void
+doTask(Contract<Index> & C,
+       Diag<T1>   const& A,
+       Diag<T2>   const& B,
+       ManageStore     & m)
+    {
+    using T3 = common_type<T1,T2>;
+    Labels Lind,
+          Rind,
+          Nind;
+    auto ncont = computeLabels(C.Lis,C.Lis.r(),C.Ris,C.Ris.r(),Lind,Rind);
+    bool sortIndices = false;
+    contractIS(C.Lis,Lind,C.Ris,Rind,C.Nis,Nind,sortIndices);
+
+    if(ncont == 0)
+        {
+        //Outer product: dense, with A(i)*B(j)
+        //on the "diagonal" of each factor
+        auto astride = 0ul,
+             bstride = 0ul;
+        for(auto i : range(Nind))
+            {
+            if(find_index(Lind,Nind[i]) >= 0) astride += C.Nis.stride(i);
+            else                              bstride += C.Nis.stride(i);
+            }
+        auto nd = m.makeNewData<Dense<T3>>(area(C.Nis),0.);
+        contractDiagOuter(A,astride,B,bstride,makeVecRef(nd->data(),nd->size()));
+        return;
+        }
+
+    //Uncontracted indices of A and B all
+    //step with the contracted ones, so the
+    //result is diagonal too
+    auto nr = rank(C.Nis);
+    if(nr >= 2 && A.allSame() && B.allSame()
+       && size_t(minM(C.Nis)) <= std::min(A.length,B.length))
+        {
+        m.makeNewData<Diag<T3>>(minM(C.Nis),A.val*B.val);
+        return;
+        }
+    auto nsize = (nr==0) ? 1ul : size_t(minM(C.Nis));
+    using nstorage_type = typename Diag<T3>::storage_type;
+    auto nstore = nstorage_type(nsize,0);
+    contractDiagDiag(A,B,makeVecRef(nstore.data(),nsize));
+    if(nr==0)      m.makeNewData<Diag<T3>>(1,nstore.front());
+    else if(nr==1) m.makeNewData<Dense<T3>>(std::move(nstore));
+    else           m.makeNewData<Diag<T3>>(std::move(nstore));
+    }
+template void doTask(Contract<Index>&, Diag<Real> const&, Diag<Real> const&, ManageStore&);
+template void doTask(Contract<Index>&, Diag<Real> const&, Diag<Cplx> const&, ManageStore&);
+template void doTask(Contract<Index>&, Diag<Cplx> const&, Diag<Real> const&, ManageStore&);
+template void doTask(Contract<Index>&, Diag<Cplx> const&, Diag<Cplx> const&, ManageStore&);
+
 struct Adder
     {
     const Real f = 1.;
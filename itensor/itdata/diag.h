@@ -135,6 +135,28 @@ write(std::ostream& s, Diag<T> const& dat)
     itensor::write(s,dat.store);
     }
 
+template<typename T>
+Datac
+writeHeader(std::ostream& s, Diag<T> const& dat)
+    {
+    itensor::write(s,dat.val);
+    itensor::write(s,dat.length);
+    itensor::write(s,dat.store.size());
+    return realData(dat);
+    }
+
+template<typename T>
+Data
+readHeader(std::istream& s, Diag<T> & dat)
+    {
+    itensor::read(s,dat.val);
+    itensor::read(s,dat.length);
+    auto size = dat.store.size();
+    itensor::read(s,size);
+    dat.store.resize(size);
+    return realData(dat);
+    }
+
 template <typename F, typename T>
 void
 doTask(ApplyIT<F>& A, Diag<T> const& d, ManageStore & m) 
@@ -195,6 +217,13 @@ doTask(Contract<Index> & C,
        Dense<T2>  const& t,
        ManageStore     & m);
 
+template<typename T1, typename T2>
+void
+doTask(Contract<Index> & C,
+       Diag<T1>   const& A,
+       Diag<T2>   const& B,
+       ManageStore     & m);
+
 template<typename T1, typename T2>
 void
 doTask(PlusEQ<Index> const& P,
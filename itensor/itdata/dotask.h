@@ -5,7 +5,9 @@
 #ifndef __ITENSOR_DOTASK_H
 #define __ITENSOR_DOTASK_H
 
+#include <array>
 #include <cassert>
+#include "itensor/global.h"
 #include "itensor/itdata/itdata.h"
 #include "itensor/util/print.h"
 #include "itensor/itdata/returntype.h"
@@ -43,6 +45,11 @@ struct TwoArgs
     template<typename RT, typename Task, typename D, typename Return>
     void
     call(RT& rt, Task& t, D& d, ManageStore& m, Return& ret);
+
+    //Version where the second storage type is known
+    template<typename RT, typename Task, typename D1, typename D2, typename Return>
+    void
+    call(RT& rt, Task& t, D1& d1, D2& d2, ManageStore& m, Return& ret);
     };
 
 template<typename Derived, typename TList>
@@ -142,6 +149,11 @@ class RegisterTask : public FuncT<RegisterTask<NArgs,Task,Return>,StorageTypes>
     template<typename D>
     void
     applyToImpl(D& d);
+
+    //For two argument tasks (NArgs == TwoArgs)
+    template<typename D1, typename D2>
+    void
+    applyToImpl(D1& d1, D2& d2);
     };
 
 template <class RT, typename Task, typename D1, typename Return, class PType1, class PType2>
@@ -494,6 +506,20 @@ applyToImpl(D& d)
     NArgs{}.call(*this,task_,d,m_,ret_);
     }
 
+template <typename NArgs, typename Task, typename Return>
+template<typename D1, typename D2>
+void RegisterTask<NArgs,Task,Return>::
+applyToImpl(D1& d1, D2& d2)
+    {
+    constexpr bool isLazy = HasEvaluate<D1>::result();
+    if(isLazy)
+        {
+        applyToImpl(d1);
+        return;
+        }
+    NArgs{}.call(*this,task_,d1,d2,m_,ret_);
+    }
+
 template<class PType>
 template<typename RT, typename Task, typename D, typename Return>
 void OneArg<PType>::
@@ -535,6 +561,15 @@ call(RT& rt, Task& t, D& d, ManageStore& m, Return& ret)
     m.parg2()->plugInto(w);
     }
 
+template<class PType1, class PType2>
+template<typename RT, typename Task, typename D1, typename D2, typename Return>
+void TwoArgs<PType1,PType2>::
+call(RT& rt, Task& t, D1& d1, D2& d2, ManageStore& m, Return& ret)
+    {
+    CallWrap<RT,Task,D1,Return,PType1,PType2> w(rt,t,d1,m,ret);
+    w.applyToImpl(d2);
+    }
+
 template <class RT, typename Task, typename D1, typename Return, class PType1, class PType2>
 template<typename D2>
 void CallWrap<RT,Task,D1,Return,PType1,PType2>::
@@ -614,6 +649,109 @@ applyToImpl(D2& d2)
         }
     }
 
+/////////////
+
+//
+// Dispatch tables
+//
+// Instead of the double dispatch of plugInto/applyTo
+// (two virtual calls per argument), doTask looks up
+// the applyToImpl instantiation for the storage types
+// of its arguments in a table indexed by
+// ITData::typeIndex(). The tables are static, built
+// once for each task type and constness of the first
+// argument, so calling a task on any pair of storage
+// types costs a single indirect call.
+//
+
+template<bool isConst, typename T>
+using ConstIf = stdx::conditional_t<isConst,const T,T>;
+
+template<typename D>
+D&
+storeOf(ITData& p)
+    {
+    return static_cast<ITWrap<stdx::remove_const_t<D>>&>(p).d;
+    }
+
+template<typename RT, typename D>
+void
+applyToStore(RT& rt, ITData& p)
+    {
+    rt.applyToImpl(storeOf<D>(p));
+    }
+
+template<typename RT, typename D1, typename D2>
+void
+applyToStores(RT& rt, ITData& p1, ITData& p2)
+    {
+    rt.applyToImpl(storeOf<D1>(p1),storeOf<D2>(p2));
+    }
+
+template<typename RT>
+using ApplyFunc1 = void (*)(RT&,ITData&);
+
+template<typename RT>
+using ApplyFunc2 = void (*)(RT&,ITData&,ITData&);
+
+template<typename RT, bool isConst, typename... Ts>
+void
+dispatchTable(RT& rt, ITData& p, TypeList<Ts...>)
+    {
+    static const ApplyFunc1<RT> table[] = { &applyToStore<RT,ConstIf<isConst,Ts>>... };
+    table[p.typeIndex()](rt,p);
+    }
+
+template<typename RT, typename D1, typename... Ts>
+constexpr std::array<ApplyFunc2<RT>,sizeof...(Ts)>
+dispatchRow() { return {{ &applyToStores<RT,D1,Ts>... }}; }
+
+//Second argument is always non-const, as for
+//m.parg2()->plugInto(w) in TwoArgs::call
+template<typename RT, bool isConst1, typename... Ts>
+void
+dispatchTable(RT& rt, ITData& p1, ITData& p2, TypeList<Ts...>)
+    {
+    using Row = std::array<ApplyFunc2<RT>,sizeof...(Ts)>;
+    static const std::array<Row,sizeof...(Ts)> table = {{ dispatchRow<RT,ConstIf<isConst1,Ts>,Ts...>()... }};
+    table[p1.typeIndex()][p2.typeIndex()](rt,p1,p2);
+    }
+
+template<bool isConst, typename RT>
+void
+dispatch(RT& rt, ITData& p)
+    {
+    if(Global::tableDispatch() && p.typeIndex() >= 0)
+        {
+        dispatchTable<RT,isConst>(rt,p,StorageTypes{});
+        }
+    else if(isConst)
+        {
+        static_cast<ITData const&>(p).plugInto(rt);
+        }
+    else
+        {
+        p.plugInto(rt);
+        }
+    }
+
+template<bool isConst1, typename RT>
+void
+dispatch(RT& rt, ITData& p1, ITData& p2)
+    {
+    if(Global::tableDispatch() && p1.typeIndex() >= 0 && p2.typeIndex() >= 0)
+        {
+        dispatchTable<RT,isConst1>(rt,p1,p2,StorageTypes{});
+        }
+    else if(isConst1)
+        {
+        static_cast<ITData const&>(p1).plugInto(rt);
+        }
+    else
+        {
+        p1.plugInto(rt);
+        }
+    }
 
 } //namespace detail
 
@@ -642,7 +780,7 @@ doTask(Task&& t,
     using Ret = DoTaskReturn<Task,StorageTypes>;
     ManageStore m(&(arg.p));
     detail::RegisterTask<detail::OneArg<CPData>,decltype(t),Ret> r{std::forward<Task>(t),std::move(m)};
-    arg->plugInto(r);
+    detail::dispatch<true>(r,*arg.p);
     return r.getReturn();
     }
 
@@ -658,7 +796,7 @@ doTask(Task&& t,
     using Ret = DoTaskReturn<Task,StorageTypes>;
     ManageStore m(&arg);
     detail::RegisterTask<detail::OneArg<PData>,decltype(t),Ret> r(std::forward<Task>(t),std::move(m));
-    arg->plugInto(r);
+    detail::dispatch<false>(r,*arg);
     return r.getReturn();
     }
 
@@ -676,7 +814,7 @@ doTask(Task&& t,
     using Ret = DoTaskReturn<Task,StorageTypes>;
     ManageStore m(&(arg1.p),&(arg2.p));
     detail::RegisterTask<detail::TwoArgs<CPData,CPData>,decltype(t),Ret> r(std::forward<Task>(t),std::move(m));
-    arg1->plugInto(r);
+    detail::dispatch<true>(r,*arg1.p,*arg2.p);
     return r.getReturn();
     }
 
@@ -694,7 +832,7 @@ doTask(Task&& t,
     using Ret = DoTaskReturn<Task,StorageTypes>;
     ManageStore m(&arg1,&(arg2.p));
     detail::RegisterTask<detail::TwoArgs<PData,CPData>,decltype(t),Ret> r(std::forward<Task>(t),std::move(m));
-    arg1->plugInto(r);
+    detail::dispatch<false>(r,*arg1,*arg2.p);
     return r.getReturn();
     }
 
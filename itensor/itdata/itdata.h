@@ -62,9 +62,24 @@ using FuncBase = FuncBaseT<StorageTypes>;
 
 struct ITData
     {
+    private:
+    int type_ = -1;
+    public:
+
     ITData() { }
+
+    //type is the position of the storage type in StorageTypes
+    explicit
+    ITData(int type) : type_(type) { }
+
     virtual ~ITData() { }
 
+    //Position of the storage type in StorageTypes, used
+    //to look up tasks in the dispatch tables of doTask
+    //(-1 if unknown, then doTask calls plugInto)
+    int
+    typeIndex() const { return type_; }
+
     PData virtual
     clone() const = 0;
 
@@ -84,7 +99,9 @@ class ITWrap : public ITData
     T d;
 
     template<typename... VArgs>
-    ITWrap(VArgs&&... vargs) : d(std::forward<VArgs>(vargs)...) 
+    ITWrap(VArgs&&... vargs) 
+      : ITData(indexOf<StorageTypes,T>()),
+        d(std::forward<VArgs>(vargs)...) 
         { 
         }
 
@@ -151,7 +151,8 @@ combine(QDense<T>   const& d,
          nrange = Range(nr); //block range of new storage
     auto dblock = Labels(dr), //block index of current storage
          nblock = Labels(nr), //block index of new storage
-         cblock = Labels(ncomb); //corresponding subblock of combiner
+         cblock = Labels(ncomb), //corresponding subblock of combiner
+         cext = Labels(ncomb); //extents of combined indices in block
     size_t start = 0, //offsets within sector of combined
            end   = 0; //IQIndex where block will go
     for(auto io : d.offsets) //loop over non-zero blocks
@@ -163,11 +164,6 @@ combine(QDense<T>   const& d,
         drange.init(make_indexdim(dis,dblock));
         auto dref = makeTenRef(d.data(),io.offset,d.size(),&drange);
 
-        //Permute combined indices to front, then
-        //group the first ncomb indices into one
-        auto Pdref = Ten<Range,T>{permute(dref,dperm)};
-        auto gPdref = groupInds(Pdref,0,ncomb);
-
         //Figure out "block index" where this block will
         //go in new storage (nblock) and which sector of
         //combined indices maps to new combined index (cblock)
@@ -190,7 +186,27 @@ combine(QDense<T>   const& d,
 
         //Slice this new-storage block to get subblock where data will go
         auto nsub = subIndex(nref,0,start,end);
-        nsub &= gPdref;
+
+        //View the subblock with the combined index split
+        //back into the combined indices, so that the block
+        //of d can be permuted straight into it in one pass
+        auto srange = RangeBuilder(dr);
+        auto cstride = nsub.stride(0);
+        for(auto i : range(dr)) 
+            {
+            auto k = dperm[i];
+            if(combined(i)) cext[k] = drange.extent(i);
+            }
+        for(auto k : range(ncomb))
+            {
+            srange.setIndStr(k,cext[k],cstride);
+            cstride *= cext[k];
+            }
+        for(auto k : range(1,nr))
+            {
+            srange.setIndStr(ncomb+k-1,nsub.extent(k),nsub.stride(k));
+            }
+        makeRef(nsub.store(),srange.build()) &= permute(dref,dperm);
         }
     }
 
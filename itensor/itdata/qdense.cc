@@ -76,7 +76,7 @@ QDense(IQIndexSet const& is,
        QN         const& div)
     {
     auto totalsize = updateOffsets(is,div);
-    store.assign(totalsize,0.);
+    store = acquireStorage<T>(totalsize);
     }
 template QDense<Real>::QDense(IQIndexSet const&, QN const&);
 template QDense<Cplx>::QDense(IQIndexSet const&, QN const&);
@@ -208,7 +208,7 @@ template void doTask(Mult<Real> const&, QDenseCplx&);
 void
 doTask(Mult<Cplx> const& M, QDense<Cplx> & d)
     {
-    for(auto& el : d) el *= M.x;
+    scaleElements(d.data(),d.size(),M.x);
     }
 
 void
@@ -241,7 +241,7 @@ template void doTask(Fill<Cplx> const& F, QDense<Real> const&, ManageStore &);
 void
 doTask(Conj, QDenseCplx & d)
     {
-    for(auto& el : d) applyConj(el);
+    conjElements(d.data(),d.size());
     }
 
 void
@@ -386,6 +386,10 @@ add(PlusEQ<IQIndex> const& P,
         auto dB = realData(B);
         daxpy_wrapper(dA.size(),P.fac(),dB.data(),1,dA.data(),1);
         }
+    else if(isTrivial(P.perm()))
+        {
+        transformElements(B.data(),A.data(),A.size(),Adder{P.fac()});
+        }
     else
         {
         auto r = P.is1().r();
@@ -442,6 +446,7 @@ doTask(Contract<IQIndex>& Con,
        QDense<VB> const& B,
        ManageStore& m)
     {
+    PROFILE_SCOPE("contract")
     using VC = common_type<VA,VB>;
     Labels Lind,
           Rind;
@@ -454,9 +459,7 @@ doTask(Contract<IQIndex>& Con,
     auto Cdiv = doTask(CalcDiv{Con.Lis},A)+doTask(CalcDiv{Con.Ris},B);
 
     //Allocate storage for C
-    START_TIMER(33)
     auto nd = m.makeNewData<QDense<VC>>(Con.Nis,Cdiv);
-    STOP_TIMER(33)
     auto& C = *nd;
 
     //Function to execute for each pair of
@@ -483,21 +486,18 @@ doTask(Contract<IQIndex>& Con,
         auto cref = makeRef(cblock,&Crange);
 
         //Compute cref += aref*bref
-        START_TIMER(2)
         contract(aref,Lind,bref,Rind,cref,Cind,1.,1.);
-        STOP_TIMER(2)
         };
 
-    START_TIMER(20)
     loopContractedBlocks(A,Con.Lis,
                          B,Con.Ris,
                          C,Con.Nis,
                          do_contract);
-    STOP_TIMER(20)
 
-    START_TIMER(21)
-    Con.scalefac = computeScalefac(C);
-    STOP_TIMER(21)
+        {
+        PROFILE_SCOPE("scalefac",2.*C.size(),sizeof(VC)*C.size())
+        Con.scalefac = computeScalefac(C);
+        }
     }
 template void doTask(Contract<IQIndex>& Con,QDense<Real> const&,QDense<Real> const&,ManageStore&);
 template void doTask(Contract<IQIndex>& Con,QDense<Cplx> const&,QDense<Real> const&,ManageStore&);
@@ -9,6 +9,7 @@
 #include "itensor/itdata/task_types.h"
 #include "itensor/iqindex.h"
 #include "itensor/itdata/itdata.h"
+#include "itensor/itdata/storagepool.h"
 #include "itensor/tensor/types.h"
 #include "itensor/detail/gcounter.h"
 #include "itensor/detail/call_rewrite.h"
@@ -61,6 +62,14 @@ class QDense
     //       store(b,c)
     //       { }
 
+    //Zero-initialized data of the given size, 
+    //from the storage pool
+    QDense(std::vector<BlOf> const& off,
+           size_t size)
+         : offsets(off),
+           store(acquireStorage<value_type>(size))
+           { }
+
     template<typename... StoreArgs>
     QDense(std::vector<BlOf> const& off,
            StoreArgs&&... sargs)
@@ -68,6 +77,40 @@ class QDense
            store(std::forward<StoreArgs>(sargs)...)
            { }
 
+    QDense(QDense const& other) 
+         : offsets(other.offsets), 
+           store(copyStorage(other.store)) 
+           { }
+
+    QDense(QDense&& other) = default;
+
+    //Assignment returns the old buffer to the pool
+    QDense&
+    operator=(QDense const& other)
+        {
+        if(this != &other)
+            {
+            offsets = other.offsets;
+            releaseStorage(store);
+            store = copyStorage(other.store);
+            }
+        return *this;
+        }
+
+    QDense&
+    operator=(QDense&& other)
+        {
+        if(this != &other)
+            {
+            offsets = std::move(other.offsets);
+            releaseStorage(store);
+            store = std::move(other.store);
+            }
+        return *this;
+        }
+
+    ~QDense() { releaseStorage(store); }
+
     explicit operator bool() const { return !store.empty() && !offsets.empty(); }
 
     value_type *
@@ -160,6 +203,26 @@ read(std::istream & s, QDense<T> & dat)
     itensor::read(s,dat.store);
     }
 
+template<typename T>
+Datac
+writeHeader(std::ostream & s, QDense<T> const& dat)
+    {
+    itensor::write(s,dat.offsets);
+    itensor::write(s,dat.store.size());
+    return realData(dat);
+    }
+
+template<typename T>
+Data
+readHeader(std::istream & s, QDense<T> & dat)
+    {
+    itensor::read(s,dat.offsets);
+    auto size = dat.store.size();
+    itensor::read(s,size);
+    dat.store.resize(size);
+    return realData(dat);
+    }
+
 template<typename T>
 void
 swap(QDense<T> & d1,
@@ -513,5 +513,130 @@ template void doTask(Contract<IQIndex>& Con,QDense<Real> const& A,QDiag<Cplx> co
 template void doTask(Contract<IQIndex>& Con,QDense<Cplx> const& A,QDiag<Cplx> const& B,ManageStore& m);
 
 
+template<typename VA, typename VB, typename VC>
+void
+contractDiagDiag(QDiag<VA> const& A, size_t nba, size_t nea,
+                 QDiag<VB> const& B, size_t nbb, size_t neb,
+                 VecRef<VC> const& C)
+    {
+    auto ua = UnifVecWrapper<VA>(A.val,nea-nba);
+    auto ub = UnifVecWrapper<VB>(B.val,neb-nbb);
+    auto ra = makeVecRefc(A.data()+(A.allSame() ? 0 : nba),nea-nba);
+    auto rb = makeVecRefc(B.data()+(B.allSame() ? 0 : nbb),neb-nbb);
+    if(A.allSame() && B.allSame()) contractDiagDiag(ua,ub,C);
+    else if(A.allSame())           contractDiagDiag(ua,rb,C);
+    else if(B.allSame())           contractDiagDiag(ra,ub,C);
+    else                           contractDiagDiag(ra,rb,C);
+    }
+
+template<typename VA, typename VB, typename VC>
+void
+contractDiagOuter(QDiag<VA> const& A, size_t nba, size_t nea, size_t astride,
+                  QDiag<VB> const& B, size_t nbb, size_t neb, size_t bstride,
+                  VecRef<VC> const& C, size_t cstart)
+    {
+    auto ua = UnifVecWrapper<VA>(A.val,nea-nba);
+    auto ub = UnifVecWrapper<VB>(B.val,neb-nbb);
+    auto ra = makeVecRefc(A.data()+(A.allSame() ? 0 : nba),nea-nba);
+    auto rb = makeVecRefc(B.data()+(B.allSame() ? 0 : nbb),neb-nbb);
+    if(A.allSame() && B.allSame()) contractDiagOuter(ua,astride,ub,bstride,C,cstart);
+    else if(A.allSame())           contractDiagOuter(ua,astride,rb,bstride,C,cstart);
+    else if(B.allSame())           contractDiagOuter(ra,astride,ub,bstride,C,cstart);
+    else                           contractDiagOuter(ra,astride,rb,bstride,C,cstart);
+    }
+
+template<typename VA, typename VB>
+void
+doTask(Contract<IQIndex>& Con,
+       QDiag<VA> const& A,
+       QDiag<VB> const& B,
+       ManageStore& m)
+    {
+    using VC = common_type<VA,VB>;
+    auto& Ais = Con.Lis;
+    auto& Bis = Con.Ris;
+    auto& Cis = Con.Nis;
+    Labels AL,
+           BL,
+           CL;
+    bool sortInds = false;
+    auto ncont = computeLabels(Ais,Ais.r(),Bis,Bis.r(),AL,BL);
+    contractIS(Ais,AL,Bis,BL,Cis,CL,sortInds);
+
+    if(ncont > 0)
+        {
+        //All IQIndices of A and B have the same size
+        //and step together along the diagonal, so
+        //the result is a QDiag holding A(J)*B(J)
+        if(rank(Cis) > 0 && A.allSame() && B.allSame())
+            {
+            m.makeNewData<QDiag<VC>>(Cis,A.val*B.val);
+            return;
+            }
+        auto *nd = m.makeNewData<QDiag<VC>>(Cis);
+        auto n = std::min(A.length,B.length);
+        contractDiagDiag(A,0,n,B,0,n,makeVecRef(nd->data(),nd->store.size()));
+        return;
+        }
+
+    //Outer product: each pair of diagonal blocks
+    //of A and B fills part of one block of C
+    auto Cdiv = doTask(CalcDiv{Ais},A)+doTask(CalcDiv{Bis},B);
+    auto *nd = m.makeNewData<QDense<VC>>(Cis,Cdiv);
+    auto& C = *nd;
+
+    auto AtoC = IntArray(rank(Ais),-1);
+    auto BtoC = IntArray(rank(Bis),-1);
+    for(auto ic : range(Cis))
+        {
+        auto ia = findindex(Ais,Cis[ic]);
+        if(ia >= 0) AtoC[ia] = ic;
+        else        BtoC[findindex(Bis,Cis[ic])] = ic;
+        }
+
+    auto Cblockind = IntArray(rank(Cis),0);
+    auto loopA = [&](size_t nba, size_t nea, IntArray const& Ablock)
+        {
+        auto loopB = [&](size_t nbb, size_t neb, IntArray const& Bblock)
+            {
+            for(auto ia : range(Ablock)) Cblockind[AtoC[ia]] = Ablock[ia];
+            for(auto ib : range(Bblock)) Cblockind[BtoC[ib]] = Bblock[ib];
+            auto cblock = getBlock(C,Cis,Cblockind);
+            if(!cblock) return;
+            Range Crange;
+            Crange.init(make_indexdim(Cis,Cblockind));
+
+            //Position of the first diagonal element of each
+            //block relative to the start of the C block
+            auto astarts = std::get<2>(diagBlockBounds(Ais,Ablock));
+            auto bstarts = std::get<2>(diagBlockBounds(Bis,Bblock));
+            auto cstart = 0ul,
+                 astride = 0ul,
+                 bstride = 0ul;
+            for(auto ia : range(Ablock)) 
+                {
+                astride += Crange.stride(AtoC[ia]);
+                cstart += astarts[ia]*Crange.stride(AtoC[ia]);
+                }
+            for(auto ib : range(Bblock)) 
+                {
+                bstride += Crange.stride(BtoC[ib]);
+                cstart += bstarts[ib]*Crange.stride(BtoC[ib]);
+                }
+            auto Cref = makeVecRef(cblock.data(),cblock.size());
+            contractDiagOuter(A,nba,nea,astride,
+                              B,nbb,neb,bstride,
+                              Cref,cstart);
+            };
+        loopDiagBlocks(B,Bis,loopB);
+        };
+    loopDiagBlocks(A,Ais,loopA);
+    }
+template void doTask(Contract<IQIndex>& Con,QDiag<Real> const& A,QDiag<Real> const& B,ManageStore& m);
+template void doTask(Contract<IQIndex>& Con,QDiag<Cplx> const& A,QDiag<Real> const& B,ManageStore& m);
+template void doTask(Contract<IQIndex>& Con,QDiag<Real> const& A,QDiag<Cplx> const& B,ManageStore& m);
+template void doTask(Contract<IQIndex>& Con,QDiag<Cplx> const& A,QDiag<Cplx> const& B,ManageStore& m);
+
+
 } //namespace itensor
 
@@ -126,6 +126,28 @@ read(std::istream & s, QDiag<T> & dat)
     itensor::read(s,dat.length);
     itensor::read(s,dat.store);
     }
+
+template<typename T>
+Datac
+writeHeader(std::ostream & s, QDiag<T> const& dat)
+    {
+    itensor::write(s,dat.val);
+    itensor::write(s,dat.length);
+    itensor::write(s,dat.store.size());
+    return realData(dat);
+    }
+
+template<typename T>
+Data
+readHeader(std::istream & s, QDiag<T> & dat)
+    {
+    itensor::read(s,dat.val);
+    itensor::read(s,dat.length);
+    auto size = dat.store.size();
+    itensor::read(s,size);
+    dat.store.resize(size);
+    return realData(dat);
+    }
  
 template<typename T>
 Cplx
@@ -273,6 +295,13 @@ doTask(Contract<IQIndex>& Con,
        QDiag<VB> const& B,
        ManageStore& m);
 
+template<typename VA, typename VB>
+void
+doTask(Contract<IQIndex>& Con,
+       QDiag<VA> const& A,
+       QDiag<VB> const& B,
+       ManageStore& m);
+
 template<typename T>
 void
 doTask(Order<IQIndex> const& P,
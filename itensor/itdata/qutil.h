@@ -5,7 +5,9 @@
 #ifndef __ITENSOR_QUTIL_H
 #define __ITENSOR_QUTIL_H
 
+#include <unordered_map>
 #include "itensor/indexset.h"
+#include "itensor/global.h"
 
 namespace itensor {
 
@@ -97,6 +99,168 @@ getBlock(BlockSparse & d,
     return data_range_type{};
     }
 
+//
+// Lookup table for the non-zero blocks of block-sparse
+// storage having an "offsets" array (such as QDense).
+// Finds the data offset of a block given its location
+// block_ind in O(1), using a table holding an entry
+// for every possible block, or a hash map if most
+// blocks are zero (as for high-rank tensors).
+// Also stores the location of each non-zero block so
+// it can be read off instead of calling computeBlockInd.
+//
+// Used when Global::blockTable() is true (default false),
+// otherwise getBlock's binary search is used.
+//
+class BlockOffsets
+    {
+    long r_ = 0;
+    bool dense_ = true;
+    std::vector<long> stride_;
+    std::vector<long> table_;
+    std::unordered_map<long,long> hash_;
+    std::vector<long> blockinds_;
+    public:
+
+    BlockOffsets() { }
+
+    template<typename Offsets>
+    BlockOffsets(Offsets const& offsets,
+                 IQIndexSet const& is);
+
+    //Data offset of block with location block_ind,
+    //or -1 if the block is zero (not stored)
+    template<typename Indexable>
+    long
+    offset(Indexable const& block_ind) const
+        {
+        long ii = 0;
+        for(long j = 0; j < r_; ++j) ii += block_ind[j]*stride_[j];
+        return offsetOfKey(ii);
+        }
+
+    //Data offset of the block at position key of the
+    //table, key = sum_j block_ind[j]*stride(j)
+    long
+    offsetOfKey(long key) const
+        {
+        if(dense_) return table_[key];
+        auto it = hash_.find(key);
+        return (it == hash_.end()) ? -1 : it->second;
+        }
+
+    //Stride of index j in table keys
+    long
+    stride(long j) const { return stride_[j]; }
+
+    //Location of the nth non-zero block (in the
+    //order of the offsets array); r entries
+    long const*
+    blockInd(size_t n) const { return blockinds_.data()+n*r_; }
+    };
+
+template<typename Offsets>
+BlockOffsets::
+BlockOffsets(Offsets const& offsets,
+             IQIndexSet const& is)
+  : r_(is.r()),
+    stride_(is.r())
+    {
+    //Use a dense table unless it would have many
+    //more entries than there are non-zero blocks
+    auto maxdense = std::max(1024l,16l*long(offsets.size()));
+    long nblocks = 1;
+    for(long j = 0; j < r_; ++j)
+        {
+        stride_[j] = nblocks;
+        nblocks *= is[j].nindex();
+        if(nblocks > maxdense) dense_ = false;
+        }
+    if(dense_) table_.assign(nblocks,-1);
+    else       hash_.reserve(offsets.size());
+
+    blockinds_.resize(offsets.size()*r_);
+    for(auto n : range(offsets))
+        {
+        auto& io = offsets[n];
+        if(dense_) table_[io.block] = io.offset;
+        else       hash_[io.block] = io.offset;
+        long block = io.block;
+        auto* ind = blockinds_.data()+n*r_;
+        for(long j = r_-1; j >= 0; --j)
+            {
+            ind[j] = block/stride_[j];
+            block -= ind[j]*stride_[j];
+            }
+        }
+    }
+
+namespace detail {
+
+//Finds blocks of block-sparse storage by location,
+//through a BlockOffsets table for storage
+//having an offsets array, otherwise by getBlock
+template<typename BlockSparse>
+class BlockFinder
+    {
+    BlockSparse & d_;
+    IQIndexSet const& is_;
+    bool use_table_ = false;
+    BlockOffsets table_;
+    public:
+
+    BlockFinder(BlockSparse & d,
+                IQIndexSet const& is)
+      : d_(d),
+        is_(is)
+        {
+        init(stdx::select_overload{});
+        }
+
+    template<typename Indexable>
+    auto
+    operator()(Indexable const& block_ind) const
+        -> decltype(getBlock(d_,is_,block_ind))
+        {
+        using data_range_type = decltype(getBlock(d_,is_,block_ind));
+        if(!use_table_) return getBlock(d_,is_,block_ind);
+        if(block_ind.size() == 0) return data_range_type(d_.data(),d_.size());
+        auto boff = table_.offset(block_ind);
+        if(boff >= 0) return makeDataRange(d_.data(),boff,d_.size());
+        return data_range_type{};
+        }
+
+    //The lookup table, or nullptr if blocks are
+    //found by getBlock
+    BlockOffsets const*
+    table() const { return use_table_ ? &table_ : nullptr; }
+
+    //Block at data offset boff, as found in table()
+    auto
+    atOffset(long boff) const
+        -> decltype(makeDataRange(d_.data(),boff,d_.size()))
+        {
+        return makeDataRange(d_.data(),boff,d_.size());
+        }
+
+    private:
+
+    template<typename S = BlockSparse>
+    auto
+    init(stdx::choice<1>)
+        -> stdx::if_compiles_return<void,decltype(std::declval<S&>().offsets)>
+        {
+        if(!Global::blockTable()) return;
+        use_table_ = true;
+        table_ = BlockOffsets(d_.offsets,is_);
+        }
+
+    void
+    init(stdx::choice<2>) { }
+    };
+
+} //namespace detail
+
 template<typename BlockSparseA, 
          typename BlockSparseB,
          typename BlockSparseC,
@@ -140,62 +304,126 @@ loopContractedBlocks(BlockSparseA const& A,
             }
         }
 
-    auto couB = detail::GCounter(rB);
+    //Table lookups replace binary searches over B.offsets
+    //and C.offsets in the inner loop below
+    auto useTable = Global::blockTable();
+    auto Atable = useTable ? BlockOffsets(A.offsets,Ais) : BlockOffsets{};
+    auto findB = detail::BlockFinder<BlockSparseB const>(B,Bis);
+    auto findC = detail::BlockFinder<BlockSparseC>(C,Cis);
+    auto* Btable = findB.table();
+
+    auto BtoA = IntArray(rB,-1);
+    for(auto ia : range(rA)) if(AtoB[ia] != -1) BtoA[AtoB[ia]] = ia;
+
     auto Ablockind = IntArray(rA,0);
+    auto Bblockind = IntArray(rB,0);
     auto Cblockind = IntArray(rC,0);
+
+    //Contracts block aio of A with the block bblock
+    //of B at location Bblockind
+    auto contractBlocks = [&](typename std::decay<decltype(A.offsets[0])>::type const& aio,
+                              decltype(findB(Bblockind)) const& bblock)
+        {
+        //Finish making Cblockind
+        for(auto iB : range(rB))
+            {
+            if(BtoC[iB] != -1) Cblockind[BtoC[iB]] = Bblockind[iB];
+            }
+
+        auto cblock = findC(Cblockind);
+        assert(cblock);
+
+        auto ablock = makeDataRange(A.data(),aio.offset,A.size());
+
+        callback(ablock,Ablockind,
+                 bblock,Bblockind,
+                 cblock,Cblockind);
+        };
+
+    auto couB = detail::GCounter(rB);
+    auto Bext = InfArray<size_t,11ul>(rB),
+         Bkstride = InfArray<size_t,11ul>(rB);
+    auto Bfree = IntArray(rB);
     //Loop over blocks of A (labeled by elements of A.offsets)
-    for(auto& aio : A.offsets)
+    for(auto na : range(A.offsets))
         {
-        TIMER_START(19)
+        auto& aio = A.offsets[na];
         //Reconstruct indices labeling this block of A, put into Ablock
-        //TODO: optimize away need to call computeBlockInd by
-        //      storing block indices directly in QDense
-        //      Taking 10% of running time in S=1 N=100 DMRG tests (maxm=100)
-        computeBlockInd(aio.block,Ais,Ablockind);
-        //Reset couB to run over indices of B (at first)
-        couB.reset();
-        for(auto iB : range(rB))
+        if(useTable)
+            {
+            auto* ind = Atable.blockInd(na);
+            for(auto iA : range(rA)) Ablockind[iA] = ind[iA];
+            }
+        else
             {
-            couB.setRange(iB,0,Bis[iB].nindex()-1);
+            computeBlockInd(aio.block,Ais,Ablockind);
             }
+        //Begin computing elements of Cblock(=destination of this block-block contraction)
         for(auto iA : range(rA))
             {
-            auto ival = Ablockind[iA];
+            if(AtoC[iA] != -1) Cblockind[AtoC[iA]] = Ablockind[iA];
+            }
+
+        if(Btable)
+            {
+            //Loop over the blocks of B matching this block of A
+            //by their table keys, updating the key together with
+            //the B indices not contracted with A (the key of the
+            //contracted ones is fixed)
+            long key = 0;
+            size_t nfree = 0;
+            for(auto iB : range(rB))
+                {
+                if(BtoA[iB] != -1)
+                    {
+                    Bblockind[iB] = Ablockind[BtoA[iB]];
+                    key += Bblockind[iB]*Btable->stride(iB);
+                    }
+                else
+                    {
+                    Bblockind[iB] = 0;
+                    Bfree[nfree] = iB;
+                    Bext[nfree] = Bis[iB].nindex();
+                    Bkstride[nfree] = Btable->stride(iB);
+                    ++nfree;
+                    }
+                }
+            while(true)
+                {
+                auto boff = Btable->offsetOfKey(key);
+                if(boff >= 0) contractBlocks(aio,findB.atOffset(boff));
+                size_t n = 0;
+                for(; n < nfree; ++n)
+                    {
+                    auto& i = Bblockind[Bfree[n]];
+                    key += long(Bkstride[n]);
+                    if(size_t(++i) < Bext[n]) break;
+                    key -= long(Bext[n]*Bkstride[n]);
+                    i = 0;
+                    }
+                if(n == nfree) break;
+                }
+            continue;
+            }
+
+        //Reset couB to run over indices of B (at first)
+        couB.reset();
+        for(auto iB : range(rB))
+            {
+            auto ival = BtoA[iB] != -1 ? Ablockind[BtoA[iB]] : -1;
             //Restrict couB to be fixed for indices of B contracted with A
-            if(AtoB[iA] != -1) couB.setRange(AtoB[iA],ival,ival);
-            //Begin computing elements of Cblock(=destination of this block-block contraction)
-            if(AtoC[iA] != -1) Cblockind[AtoC[iA]] = ival;
+            if(ival >= 0) couB.setRange(iB,ival,ival);
+            else          couB.setRange(iB,0,Bis[iB].nindex()-1);
             }
-        TIMER_STOP(19)
         //Loop over blocks of B which contract with current block of A
         for(;couB.notDone(); ++couB)
             {
-            TIMER_START(19)
-            //START_TIMER(33)
             //Check whether B contains non-zero block for this setting of couB
-            //TODO: check whether block is present by storing all blocks
-            //      but most have null pointers to data
-            auto bblock = getBlock(B,Bis,couB.i);
+            auto bblock = findB(couB.i);
             if(!bblock) continue;
 
-            //Finish making Cblockind and Bblockind
-            auto Bblockind = IntArray(rB,0);
-            for(auto iB : range(rB))
-                {
-                if(BtoC[iB] != -1) Cblockind[BtoC[iB]] = couB.i[iB];
-                Bblockind[iB] = couB.i[iB];
-                }
-
-            auto cblock = getBlock(C,Cis,Cblockind);
-            assert(cblock);
-
-            auto ablock = makeDataRange(A.data(),aio.offset,A.size());
-            TIMER_STOP(19)
-
-            callback(ablock,Ablockind,
-                     bblock,Bblockind,
-                     cblock,Cblockind);
-
+            for(auto iB : range(rB)) Bblockind[iB] = couB.i[iB];
+            contractBlocks(aio,bblock);
             } //for couB
         } //for A.offsets
     }
@@ -41,6 +41,9 @@ class QDiag;
 template<typename T>
 class QMixed;
 
+template<typename T>
+class SU2Dense;
+
 template<typename T>
 class Scalar;
 
@@ -63,6 +66,8 @@ QDiag<Real>,
 QDiag<Cplx>,
 QMixed<Real>,
 QMixed<Cplx>,
+SU2Dense<Real>,
+SU2Dense<Cplx>,
 Scalar<Real>,
 Scalar<Cplx>
 //ITLazy
@@ -80,6 +85,7 @@ Scalar<Cplx>
 #include "itensor/itdata/qcombiner.h"
 #include "itensor/itdata/qdiag.h"
 #include "itensor/itdata/qmixed.h"
+#include "itensor/itdata/su2dense.h"
 #include "itensor/itdata/scalar.h"
 ////#include "itensor/itdata/itlazy.h"
 #endif
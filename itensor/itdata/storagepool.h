@@ -0,0 +1,263 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#ifndef __ITENSOR_STORAGEPOOL_H
+#define __ITENSOR_STORAGEPOOL_H
+
+#include <algorithm>
+#include <vector>
+#include "itensor/global.h"
+
+namespace itensor {
+
+//
+// Pool of data buffers of Dense and QDense storage,
+// also used for the scratch space of contractions.
+//
+// When storage is destroyed, such as the old storage
+// of A after A *= B, its buffer is kept here, and the
+// next storage needing a buffer of similar size takes
+// it instead of allocating. In loops doing the same
+// products over and over (Davidson matvecs of DMRG)
+// almost every buffer is then reused.
+//
+// Buffers are sorted into size classes by the base 2
+// log of their capacity. A buffer of size n is only
+// taken from the pool if its capacity is at most 2n,
+// so storage never holds much more memory than it
+// needs. At most maxPerClass buffers are kept per
+// class, and at most Global::storagePoolBytes() in
+// total; buffers smaller than minSize elements are
+// not kept, since for those the allocator is fast
+// already.
+//
+// Each thread has its own pool (and its own
+// storagePoolBytes() limit) and counts the buffers
+// it requests, so threads running independent
+// computations never wait for each other. A buffer
+// goes to the pool of the thread destroying its
+// storage, and the buffers of a pool are freed when
+// its thread exits. The pools can be turned off with
+// Global::poolStorage() = false.
+//
+
+//Counts of storage buffers requested
+struct StorageStats
+    {
+    long nalloc = 0;   //newly allocated
+    long nreuse = 0;   //taken from the pool
+    Real alloc_bytes = 0;
+    Real reuse_bytes = 0;
+    };
+
+StorageStats inline
+operator-(StorageStats a, StorageStats const& b)
+    {
+    a.nalloc -= b.nalloc;
+    a.nreuse -= b.nreuse;
+    a.alloc_bytes -= b.alloc_bytes;
+    a.reuse_bytes -= b.reuse_bytes;
+    return a;
+    }
+
+namespace detail {
+
+//Counts of the calling thread
+StorageStats inline&
+storageCounts()
+    {
+    thread_local StorageStats c;
+    return c;
+    }
+
+template<typename T>
+class StoragePool
+    {
+    public:
+    using buffer = std::vector<T>;
+
+    static const size_t minSize = 2048;
+    static const size_t maxPerClass = 8;
+
+    private:
+    std::vector<std::vector<buffer>> classes_;
+    size_t bytes_ = 0;
+    bool closed_ = false;
+
+    static int
+    sizeClass(size_t n)
+        {
+        int k = 0;
+        while(n >>= 1) ++k;
+        return k;
+        }
+
+    public:
+
+    StoragePool() : classes_(64) { }
+
+    //Pool keeping no buffers
+    static StoragePool
+    closed()
+        {
+        auto p = StoragePool();
+        p.closed_ = true;
+        return p;
+        }
+
+    //Most bytes of buffers kept
+    size_t
+    maxBytes() const { return closed_ ? 0 : Global::storagePoolBytes(); }
+
+    //Returns a buffer of size n, either taken from the
+    //pool or newly allocated; its elements are
+    //unspecified if zero is false
+    buffer
+    acquire(size_t n, bool zero)
+        {
+        if(n == 0) return buffer();
+        auto& c = storageCounts();
+        buffer b;
+        if(n >= minSize && Global::poolStorage())
+            {
+            //Buffers with capacity in [n,2n] are in
+            //class k or k+1
+            auto k = sizeClass(n);
+            for(auto kk : {k,k+1})
+                {
+                auto& cl = classes_.at(kk);
+                auto it = std::find_if(cl.begin(),cl.end(),
+                                       [n](buffer const& x)
+                                       { return x.capacity() >= n && x.capacity() <= 2*n; });
+                if(it == cl.end()) continue;
+                b.swap(*it);
+                std::swap(*it,cl.back());
+                cl.pop_back();
+                bytes_ -= sizeof(T)*b.capacity();
+                break;
+                }
+            }
+        if(b.capacity() >= n)
+            {
+            //resize only initializes elements past the old size
+            b.resize(n);
+            if(zero) std::fill(b.begin(),b.end(),T(0));
+            c.nreuse += 1;
+            c.reuse_bytes += sizeof(T)*n;
+            }
+        else
+            {
+            b = buffer(n);
+            c.nalloc += 1;
+            c.alloc_bytes += sizeof(T)*n;
+            }
+        return b;
+        }
+
+    //Keeps the memory of b if there is room for it
+    void
+    release(buffer & b)
+        {
+        auto cap = b.capacity();
+        if(cap < minSize || !Global::poolStorage()) return;
+        auto& cl = classes_.at(sizeClass(cap));
+        if(cl.size() >= maxPerClass || bytes_+sizeof(T)*cap > maxBytes()) return;
+        bytes_ += sizeof(T)*cap;
+        cl.emplace_back();
+        cl.back().swap(b);
+        }
+
+    //Frees all buffers held
+    void
+    clear()
+        {
+        for(auto& cl : classes_) cl.clear();
+        bytes_ = 0;
+        }
+    };
+
+//Pool of the calling thread
+template<typename T>
+StoragePool<T>&
+storagePool()
+    {
+    thread_local bool alive = true;
+    struct ThreadPool
+        {
+        StoragePool<T> pool;
+        ~ThreadPool() { alive = false; }
+        };
+    thread_local ThreadPool tp;
+    if(alive) return tp.pool;
+    //Storage destroyed after the pool of its thread
+    //(such as by destructors of static objects) uses
+    //a pool which keeps nothing, and so is never
+    //modified and can be shared by all threads
+    static auto* closed = new StoragePool<T>(StoragePool<T>::closed());
+    return *closed;
+    }
+
+} //namespace detail
+
+//Tag for storage constructors leaving the elements
+//unspecified, for results which will be overwritten
+struct UninitStorage { };
+
+//Buffer of size n with all elements zero
+template<typename T>
+std::vector<T>
+acquireStorage(size_t n)
+    {
+    return detail::storagePool<T>().acquire(n,true);
+    }
+
+//Buffer of size n whose elements are unspecified
+//(they are zero if it was newly allocated)
+template<typename T>
+std::vector<T>
+acquireStorage(size_t n, UninitStorage)
+    {
+    return detail::storagePool<T>().acquire(n,false);
+    }
+
+//Buffer holding a copy of v
+template<typename T>
+std::vector<T>
+copyStorage(std::vector<T> const& v)
+    {
+    auto b = detail::storagePool<T>().acquire(v.size(),false);
+    std::copy(v.begin(),v.end(),b.begin());
+    return b;
+    }
+
+//Returns the memory of v to the pool, leaving v empty
+template<typename T>
+void
+releaseStorage(std::vector<T> & v)
+    {
+    detail::storagePool<T>().release(v);
+    v = std::vector<T>();
+    }
+
+//Counts of Dense and QDense storage buffers and
+//contraction scratch buffers requested by the
+//calling thread since it started
+StorageStats inline
+storageStats()
+    {
+    return detail::storageCounts();
+    }
+
+//Frees the buffers held by the pool of
+//the calling thread
+void inline
+clearStoragePool()
+    {
+    detail::storagePool<Real>().clear();
+    detail::storagePool<Cplx>().clear();
+    }
+
+} //namespace itensor
+
+#endif
@@ -0,0 +1,713 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#include <algorithm>
+#include <map>
+#include "itensor/detail/gcounter.h"
+#include "itensor/tensor/lapack_wrap.h"
+#include "itensor/tensor/sliceten.h"
+#include "itensor/tensor/contract.h"
+#include "itensor/itdata/su2dense.h"
+#include "itensor/itdata/qutil.h"
+#include "itensor/su2.h"
+#include "itensor/util/print_macro.h"
+
+using std::vector;
+using std::move;
+
+namespace itensor {
+
+namespace {
+
+Real
+sign(long n) { return (n%2 == 0) ? 1. : -1.; }
+
+vector<Arrow>
+arrows(IQIndexSet const& is)
+    {
+    auto dir = vector<Arrow>(is.r());
+    for(auto i : range(is.r())) dir[i] = is[i].dir();
+    return dir;
+    }
+
+vector<long>
+treeOf(vector<long> const& block, long r)
+    {
+    return vector<long>(block.begin()+r,block.end());
+    }
+
+void
+appendKey(vector<long> & key,
+          vector<long> const& tj,
+          vector<Arrow> const& dir,
+          vector<long> const& k)
+    {
+    key.push_back(tj.size());
+    key.insert(key.end(),tj.begin(),tj.end());
+    for(auto d : dir) key.push_back(d);
+    key.insert(key.end(),k.begin(),k.end());
+    }
+
+vector<size_t>
+fusionDims(vector<long> const& tj)
+    {
+    auto dims = vector<size_t>(tj.size());
+    for(auto i : range(tj.size())) dims[i] = tj[i]+1;
+    return dims;
+    }
+
+//Overlaps <X_C(kC)|Y>/|X_C(kC)|^2 of a tensor Y with
+//the fusion tensors of each tree kC of the spins tjC
+using Coefs = vector<std::pair<vector<long>,Real>>;
+
+Coefs
+treeOverlaps(vector<Real> const& Y,
+             vector<long> const& tjC,
+             vector<Arrow> const& dirC)
+    {
+    auto coefs = Coefs{};
+    auto norm2 = tjC.empty() ? 1. : tjC.back()+1.;
+    for(auto& kC : su2FusionTrees(tjC))
+        {
+        auto XC = su2FusionTensor(tjC,dirC,kC);
+        Real c = 0;
+        for(auto n : range(XC.size())) c += XC[n]*Y[n];
+        c /= norm2;
+        if(std::fabs(c) > 1E-14) coefs.emplace_back(kC,c);
+        }
+    return coefs;
+    }
+
+//Coefficients expanding the contraction of the fusion
+//tensors of an A block and a B block over the trees
+//of the resulting C block
+Coefs const&
+contractCoefs(vector<long> const& tjA, vector<Arrow> const& dirA,
+              vector<long> const& kA, Labels const& Lind,
+              vector<long> const& tjB, vector<Arrow> const& dirB,
+              vector<long> const& kB, Labels const& Rind,
+              vector<long> const& tjC, vector<Arrow> const& dirC,
+              Labels const& Cind)
+    {
+    thread_local std::map<vector<long>,Coefs> cache;
+    auto key = vector<long>{};
+    appendKey(key,tjA,dirA,kA);
+    appendKey(key,tjB,dirB,kB);
+    for(auto l : Lind) key.push_back(l);
+    for(auto l : Rind) key.push_back(l);
+    auto it = cache.find(key);
+    if(it != cache.end()) return it->second;
+
+    auto const XA = su2FusionTensor(tjA,dirA,kA);
+    auto const XB = su2FusionTensor(tjB,dirB,kB);
+    auto RA = Range(fusionDims(tjA)),
+         RB = Range(fusionDims(tjB)),
+         RC = Range(fusionDims(tjC));
+    auto XAB = vector<Real>(area(RC),0.);
+    contract(makeTenRef(XA.data(),XA.size(),&RA),Lind,
+             makeTenRef(XB.data(),XB.size(),&RB),Rind,
+             makeTenRef(XAB.data(),XAB.size(),&RC),Cind);
+
+    return cache.emplace(move(key),treeOverlaps(XAB,tjC,dirC)).first->second;
+    }
+
+//Coefficients expanding the fusion tensor of a block,
+//with index i moved to position dest[i], over the trees
+//of the permuted block
+Coefs const&
+permuteCoefs(vector<long> const& tjS,
+             vector<Arrow> const& dirS,
+             vector<long> const& kS,
+             Permutation const& P)
+    {
+    thread_local std::map<vector<long>,Coefs> cache;
+    auto r = tjS.size();
+    auto key = vector<long>{};
+    appendKey(key,tjS,dirS,kS);
+    for(auto i : range(r)) key.push_back(P.dest(i));
+    auto it = cache.find(key);
+    if(it != cache.end()) return it->second;
+
+    auto tjD = vector<long>(r);
+    auto dirD = vector<Arrow>(r);
+    for(auto i : range(r))
+        {
+        tjD[P.dest(i)] = tjS[i];
+        dirD[P.dest(i)] = dirS[i];
+        }
+    auto XS = su2FusionTensor(tjS,dirS,kS);
+    auto RS = Range(fusionDims(tjS)),
+         RD = Range(fusionDims(tjD));
+    auto Y = vector<Real>(XS.size(),0.);
+    for(auto I : RS)
+        {
+        long os = 0,
+             od = 0;
+        for(auto i : range(r))
+            {
+            os += I[i]*RS.stride(i);
+            od += I[i]*RD.stride(P.dest(i));
+            }
+        Y[od] = XS[os];
+        }
+
+    return cache.emplace(move(key),treeOverlaps(Y,tjD,dirD)).first->second;
+    }
+
+struct Adder
+    {
+    const Real f = 1.;
+    Adder(Real f_) : f(f_) { }
+    template<typename T1, typename T2>
+    void operator()(T2 v2, T1& v1) { v1 += f*v2; }
+    //doTask(PlusEQ,...) makes real storage complex
+    //before adding complex storage to it
+    void operator()(Cplx v2, Real& v1) { Error("Adding complex data to real SU2Dense storage"); }
+    };
+
+//Adds fac times the storage S, with indices Sis,
+//to D, with indices Dis = permutation P of Sis
+template<typename TD, typename TS>
+void
+addPermuted(Permutation const& P,
+            SU2Dense<TS> const& S,
+            IQIndexSet const& Sis,
+            SU2Dense<TD> & D,
+            IQIndexSet const& Dis,
+            Real fac)
+    {
+    auto r = Sis.r();
+    auto dirS = arrows(Sis);
+    auto Dsec = vector<long>(r);
+    Range Srange,
+          Drange;
+    for(auto& so : S.offsets)
+        {
+        for(auto i : range(r)) Dsec[P.dest(i)] = so.block[i];
+        auto& coefs = permuteCoefs(su2Spins(Sis,so.block),dirS,treeOf(so.block,r),P);
+        if(coefs.empty()) continue;
+        Srange.init(make_indexdim(Sis,so.block));
+        Drange.init(make_indexdim(Dis,Dsec));
+        auto sref = makeTenRef(S.data(),so.offset,S.size(),&Srange);
+        for(auto& kc : coefs)
+            {
+            auto label = Dsec;
+            label.insert(label.end(),kc.first.begin(),kc.first.end());
+            auto* pd = findBlock(D.offsets,label);
+            if(!pd) Error("SU2Dense block missing in permutation");
+            auto dref = makeTenRef(D.data(),pd->offset,D.size(),&Drange);
+            transform(permute(sref,P),dref,Adder{kc.second*fac});
+            }
+        }
+    }
+
+template<typename T>
+long
+blockSize(SU2Dense<T> const& D, size_t n)
+    {
+    auto end = (n+1 < D.offsets.size()) ? D.offsets[n+1].offset : long(D.size());
+    return end-D.offsets[n].offset;
+    }
+
+} //namespace
+
+void SU2BlOf::
+write(std::ostream& s) const
+    {
+    itensor::write(s,block);
+    itensor::write(s,offset);
+    itensor::write(s,norm2);
+    }
+
+void SU2BlOf::
+read(std::istream& s)
+    {
+    itensor::read(s,block);
+    itensor::read(s,offset);
+    itensor::read(s,norm2);
+    }
+
+const char*
+typeNameOf(SU2DenseReal const& d) { return "SU2DenseReal"; }
+const char*
+typeNameOf(SU2DenseCplx const& d) { return "SU2DenseCplx"; }
+
+vector<long>
+su2Spins(IQIndexSet const& is,
+         vector<long> const& block)
+    {
+    auto tj = vector<long>(is.r());
+    for(auto i : range(is.r())) tj[i] = su2Spin(is[i].qn(1+block[i]));
+    return tj;
+    }
+
+vector<vector<long>>
+su2FusionTrees(vector<long> const& tj)
+    {
+    auto n = tj.size();
+    auto res = vector<vector<long>>{};
+    if(n == 0)
+        {
+        res.emplace_back();
+        return res;
+        }
+    if(n <= 2)
+        {
+        if(tj.front() == tj.back() && (n == 2 || tj.front() == 0)) res.emplace_back();
+        return res;
+        }
+    //Grow the trees one intermediate spin at a time
+    auto trees = vector<vector<long>>(1);
+    for(auto i : range1(n-3))
+        {
+        auto next = vector<vector<long>>{};
+        for(auto& t : trees)
+            {
+            auto kprev = t.empty() ? tj[0] : t.back();
+            for(auto k : su2Fuse(kprev,tj[i]))
+                {
+                next.push_back(t);
+                next.back().push_back(k);
+                }
+            }
+        trees.swap(next);
+        }
+    for(auto& t : trees)
+        {
+        auto kprev = t.empty() ? tj[0] : t.back();
+        if(isTriangle(kprev,tj[n-2],tj[n-1])) res.push_back(move(t));
+        }
+    return res;
+    }
+
+vector<Real>
+su2FusionTensor(vector<long> const& tj,
+                vector<Arrow> const& dir,
+                vector<long> const& k)
+    {
+    auto n = tj.size();
+    long size = 1;
+    for(auto t : tj) size *= t+1;
+    auto X = vector<Real>(size,0.);
+    if(n <= 1)
+        {
+        if(n == 0 || tj[0] == 0) X[0] = 1.;
+        return X;
+        }
+    auto last = tj.back();
+    if(n == 2 && tj[0] != last) return X;
+    //Indices with the same arrow as the last one
+    //enter as |j,-m> with a factor (-1)^(j-m)
+    auto flip = (dir.back() == In);
+    auto lstride = size/(last+1);
+    auto RB = RangeBuilder(n-1);
+    for(auto i : range(n-1)) RB.nextIndex(tj[i]+1);
+    for(auto I : RB.build())
+        {
+        Real x = 1.;
+        long tM = 0,
+             tK = tj[0],
+             off = 0,
+             str = 1;
+        for(auto i : range(n-1))
+            {
+            auto tm = -tj[i]+2*I[i];
+            if((dir[i] == Out) != flip)
+                {
+                x *= sign((tj[i]-tm)/2);
+                tm = -tm;
+                }
+            if(i == 0)
+                {
+                tM = tm;
+                }
+            else
+                {
+                auto tKnew = (i+2 == n) ? last : k[i-1];
+                x *= clebschGordan(tK,tM,tj[i],tm,tKnew,tM+tm);
+                tM += tm;
+                tK = tKnew;
+                }
+            off += I[i]*str;
+            str *= tj[i]+1;
+            }
+        if(x == 0. || std::abs(tM) > last) continue;
+        X[off+(tM+last)/2*lstride] = x;
+        }
+    return X;
+    }
+
+SU2BlOf const*
+findBlock(vector<SU2BlOf> const& offsets,
+          vector<long> const& block)
+    {
+    auto it = std::lower_bound(offsets.begin(),offsets.end(),block,
+                               [](SU2BlOf const& bo, vector<long> const& b)
+                               { return bo.block < b; });
+    if(it != offsets.end() && it->block == block) return &(*it);
+    return nullptr;
+    }
+
+template<typename T>
+SU2Dense<T>::
+SU2Dense(IQIndexSet const& is)
+    {
+    auto r = is.r();
+    if(r == 0)
+        {
+        offsets.emplace_back();
+        store = acquireStorage<T>(1);
+        return;
+        }
+
+    //Set up a Range to iterate over all blocks
+    auto RB = RangeBuilder(r);
+    for(auto j : range(r)) RB.nextIndex(is[j].nindex());
+
+    //Block sizes are kept in the offset
+    //field until the blocks are sorted
+    for(auto I : RB.build())
+        {
+        auto bo = SU2BlOf{};
+        bo.block.resize(r);
+        long size = 1;
+        for(auto j : range(r))
+            {
+            bo.block[j] = I[j];
+            size *= is[j][I[j]].m();
+            }
+        auto tj = su2Spins(is,bo.block);
+        bo.offset = size;
+        bo.norm2 = tj.back()+1;
+        for(auto& k : su2FusionTrees(tj))
+            {
+            offsets.push_back(bo);
+            offsets.back().block.insert(offsets.back().block.end(),k.begin(),k.end());
+            }
+        }
+    std::sort(offsets.begin(),offsets.end(),
+              [](SU2BlOf const& a, SU2BlOf const& b) { return a.block < b.block; });
+    long totalsize = 0;
+    for(auto& bo : offsets)
+        {
+        auto size = bo.offset;
+        bo.offset = totalsize;
+        totalsize += size;
+        }
+    store = acquireStorage<T>(totalsize);
+    }
+template SU2Dense<Real>::SU2Dense(IQIndexSet const&);
+template SU2Dense<Cplx>::SU2Dense(IQIndexSet const&);
+
+template<typename T>
+Cplx
+doTask(GetElt<IQIndex>& G, SU2Dense<T> const& d)
+    {
+    if(G.is.r() != 0) Error("Elements of SU2Dense storage only defined for rank 0 (see toSzBasis)");
+    if(d.store.empty()) return 0.;
+    return d.store.front();
+    }
+template Cplx doTask(GetElt<IQIndex>&, SU2Dense<Real> const&);
+template Cplx doTask(GetElt<IQIndex>&, SU2Dense<Cplx> const&);
+
+template<typename T>
+void
+doTask(Mult<Real> const& M, SU2Dense<T>& D)
+    {
+    auto d = realData(D);
+    dscal_wrapper(d.size(),M.x,d.data());
+    }
+template void doTask(Mult<Real> const&, SU2DenseReal&);
+template void doTask(Mult<Real> const&, SU2DenseCplx&);
+
+void
+doTask(Mult<Cplx> const& M, SU2Dense<Cplx> & d)
+    {
+    scaleElements(d.data(),d.size(),M.x);
+    }
+
+void
+doTask(Mult<Cplx> const& M, SU2Dense<Real> const& d, ManageStore & m)
+    {
+    auto *nd = m.makeNewData<SU2DenseCplx>(d.offsets,d.begin(),d.end());
+    doTask(M,*nd);
+    }
+
+void
+doTask(Conj, SU2DenseCplx & d)
+    {
+    conjElements(d.data(),d.size());
+    }
+
+template<typename T>
+Real
+doTask(NormNoScale, SU2Dense<T> const& D)
+    {
+    Real nrm2 = 0;
+    for(auto n : range(D.offsets.size()))
+        {
+        auto& bo = D.offsets[n];
+        auto d = realData(D);
+        auto f = sizeof(T)/sizeof(Real);
+        auto bnrm = dnrm2_wrapper(f*blockSize(D,n),d.data()+f*bo.offset);
+        nrm2 += bo.norm2*bnrm*bnrm;
+        }
+    return std::sqrt(nrm2);
+    }
+template Real doTask(NormNoScale, SU2Dense<Real> const& D);
+template Real doTask(NormNoScale, SU2Dense<Cplx> const& D);
+
+template<typename T>
+void
+doTask(PrintIT<IQIndex>& P, SU2Dense<T> const& d)
+    {
+    P.s << format("SU2Dense %s {%d blocks; data size %d}\n",
+                  typeName<T>(),d.offsets.size(),d.size());
+    Real scalefac = 1.0;
+    if(!P.x.isTooBigForReal()) scalefac = P.x.real0();
+    else P.s << "(omitting too large scale factor)\n";
+
+    auto rank = P.is.r();
+    if(rank == 0)
+        {
+        P.s << "  ";
+        P.s << formatVal(scalefac*d.store.front()) << "\n";
+        return;
+        }
+
+    auto C = detail::GCounter(rank);
+    for(auto& bo : d.offsets)
+        {
+        bool indices_printed = false;
+        auto& block = bo.block;
+        auto blockIndex = [&block,&P](long i)->Index { return (P.is[i])[block[i]]; };
+
+        Labels boff(rank,0);
+        for(auto i : range(rank))
+            {
+            for(auto j : range(block[i]))
+                boff[i] += P.is[i][j].m();
+            }
+
+        C.reset();
+        for(decltype(rank) i = 0; i < rank; ++i)
+            C.setRange(i,0,blockIndex(i).m()-1);
+        for(auto os = bo.offset; C.notDone(); ++C, ++os)
+            {
+            auto val = scalefac*d.store[os];
+            if(std::norm(val) >= Global::printScale())
+                {
+                if(!indices_printed)
+                    {
+                    indices_printed = true;
+                    //Print Indices and tree of this block
+                    for(auto i : range(rank))
+                        {
+                        if(i > 0) P.s << " ";
+                        P.s << blockIndex(i) << "<" << P.is[i].dir() << ">";
+                        }
+                    if(long(block.size()) > rank)
+                        {
+                        P.s << " tree";
+                        for(auto n : range(rank,block.size())) P.s << " " << block[n];
+                        }
+                    P.s << "\n";
+                    }
+                P.s << "(";
+                for(auto ii : range(rank))
+                    {
+                    P.s << (1+boff[ii]+C[ii]);
+                    if(1+ii != rank) P.s << ",";
+                    }
+                P.s << ") ";
+                P.s << formatVal(val) << "\n";
+                }
+            }
+        }
+    }
+template void doTask(PrintIT<IQIndex>& P, SU2Dense<Real> const& d);
+template void doTask(PrintIT<IQIndex>& P, SU2Dense<Cplx> const& d);
+
+template<typename T1, typename T2>
+void
+add(PlusEQ<IQIndex> const& P,
+    SU2Dense<T1>          & A,
+    SU2Dense<T2>     const& B)
+    {
+    if(isTrivial(P.perm()))
+        {
+#ifdef DEBUG
+        if(A.store.size() != B.store.size()) Error("Mismatched sizes in plusEq");
+#endif
+        if(std::is_same<T1,T2>::value)
+            {
+            auto dA = realData(A);
+            auto dB = realData(B);
+            daxpy_wrapper(dA.size(),P.fac(),dB.data(),1,dA.data(),1);
+            }
+        else
+            {
+            transformElements(B.data(),A.data(),A.size(),Adder{P.fac()});
+            }
+        }
+    else
+        {
+        addPermuted(P.perm(),B,P.is2(),A,P.is1(),P.fac());
+        }
+    }
+
+template<typename TA, typename TB>
+void
+doTask(PlusEQ<IQIndex> const& P,
+       SU2Dense<TA>    const& A,
+       SU2Dense<TB>    const& B,
+       ManageStore          & m)
+    {
+    if(B.store.size() == 0) return;
+
+    if(isReal(A) && isCplx(B))
+        {
+        auto *nA = m.makeNewData<SU2DenseCplx>(A.offsets,A.begin(),A.end());
+        add(P,*nA,B);
+        }
+    else
+        {
+        auto *mA = m.modifyData(A);
+        add(P,*mA,B);
+        }
+    }
+template void doTask(PlusEQ<IQIndex> const&, SU2Dense<Real> const&, SU2Dense<Real> const&, ManageStore&);
+template void doTask(PlusEQ<IQIndex> const&, SU2Dense<Real> const&, SU2Dense<Cplx> const&, ManageStore&);
+template void doTask(PlusEQ<IQIndex> const&, SU2Dense<Cplx> const&, SU2Dense<Real> const&, ManageStore&);
+template void doTask(PlusEQ<IQIndex> const&, SU2Dense<Cplx> const&, SU2Dense<Cplx> const&, ManageStore&);
+
+template<typename VA, typename VB>
+void
+doTask(Contract<IQIndex>& Con,
+       SU2Dense<VA> const& A,
+       SU2Dense<VB> const& B,
+       ManageStore& m)
+    {
+    PROFILE_SCOPE("contract")
+    using VC = common_type<VA,VB>;
+    auto& Lis = Con.Lis;
+    auto& Ris = Con.Ris;
+    Labels Lind,
+          Rind;
+    computeLabels(Lis,Lis.r(),Ris,Ris.r(),Lind,Rind);
+    //compute new index set (Con.Nis):
+    Labels Cind;
+    const bool sortResult = false;
+    contractIS(Lis,Lind,Ris,Rind,Con.Nis,Cind,sortResult);
+    auto& Nis = Con.Nis;
+
+    auto& C = *m.makeNewData<SU2Dense<VC>>(Nis);
+
+    long rA = Lis.r(),
+         rB = Ris.r(),
+         rC = Nis.r();
+
+    //Positions of the contracted indices
+    //of A and B, in the order of their labels
+    long ncon = 0;
+    for(auto l : Lind) if(l < 0) ++ncon;
+    auto Acon = vector<long>(ncon),
+         Bcon = vector<long>(ncon);
+    for(auto ia : range(rA)) if(Lind[ia] < 0) Acon.at(-1-Lind[ia]) = ia;
+    for(auto ib : range(rB)) if(Rind[ib] < 0) Bcon.at(-1-Rind[ib]) = ib;
+
+    //Source of each index of C: an index ia of A,
+    //or index ib of B stored as -1-ib
+    auto Cfrom = vector<long>(rC);
+    for(auto ic : range(rC))
+        {
+        for(auto ia : range(rA)) if(Lind[ia] == Cind[ic]) Cfrom[ic] = ia;
+        for(auto ib : range(rB)) if(Rind[ib] == Cind[ic]) Cfrom[ic] = -1-ib;
+        }
+
+    auto dirA = arrows(Lis),
+         dirB = arrows(Ris),
+         dirC = arrows(Nis);
+
+    //Sort blocks of B by the sectors of the contracted indices
+    using SecBlock = std::pair<vector<long>,SU2BlOf const*>;
+    auto Bblocks = vector<SecBlock>{};
+    for(auto& bo : B.offsets)
+        {
+        auto sec = vector<long>(Bcon.size());
+        for(auto n : range(Bcon)) sec[n] = bo.block[Bcon[n]];
+        Bblocks.emplace_back(move(sec),&bo);
+        }
+    auto secLess = [](SecBlock const& a, SecBlock const& b) { return a.first < b.first; };
+    std::sort(Bblocks.begin(),Bblocks.end(),secLess);
+
+    Range Arange,
+          Brange,
+          Crange;
+    auto Csec = vector<long>(rC);
+    auto asec = SecBlock{};
+    for(auto& ao : A.offsets)
+        {
+        asec.first.resize(Acon.size());
+        for(auto n : range(Acon)) asec.first[n] = ao.block[Acon[n]];
+        auto match = std::equal_range(Bblocks.begin(),Bblocks.end(),asec,secLess);
+        if(match.first == match.second) continue;
+
+        auto tjA = su2Spins(Lis,ao.block);
+        auto kA = treeOf(ao.block,rA);
+        Arange.init(make_indexdim(Lis,ao.block));
+        auto aref = makeTenRef(A.data(),ao.offset,A.size(),&Arange);
+
+        for(auto bb = match.first; bb != match.second; ++bb)
+            {
+            auto& bo = *(bb->second);
+            for(auto ic : range(rC))
+                {
+                auto f = Cfrom[ic];
+                Csec[ic] = (f >= 0) ? ao.block[f] : bo.block[-1-f];
+                }
+            auto& coefs = contractCoefs(tjA,dirA,kA,Lind,
+                                        su2Spins(Ris,bo.block),dirB,treeOf(bo.block,rB),Rind,
+                                        su2Spins(Nis,Csec),dirC,Cind);
+            if(coefs.empty()) continue;
+
+            Brange.init(make_indexdim(Ris,bo.block));
+            Crange.init(make_indexdim(Nis,Csec));
+            auto bref = makeTenRef(B.data(),bo.offset,B.size(),&Brange);
+            for(auto& kc : coefs)
+                {
+                auto label = Csec;
+                label.insert(label.end(),kc.first.begin(),kc.first.end());
+                auto* pc = findBlock(C.offsets,label);
+                if(!pc) Error("SU2Dense block missing in contraction");
+                auto cref = makeTenRef(C.data(),pc->offset,C.size(),&Crange);
+                //Compute cref += c*aref*bref
+                contract(aref,Lind,bref,Rind,cref,Cind,kc.second,1.);
+                }
+            }
+        }
+
+        {
+        PROFILE_SCOPE("scalefac",2.*C.size(),sizeof(VC)*C.size())
+        Con.scalefac = computeScalefac(C);
+        }
+    }
+template void doTask(Contract<IQIndex>& Con,SU2Dense<Real> const&,SU2Dense<Real> const&,ManageStore&);
+template void doTask(Contract<IQIndex>& Con,SU2Dense<Cplx> const&,SU2Dense<Real> const&,ManageStore&);
+template void doTask(Contract<IQIndex>& Con,SU2Dense<Real> const&,SU2Dense<Cplx> const&,ManageStore&);
+template void doTask(Contract<IQIndex>& Con,SU2Dense<Cplx> const&,SU2Dense<Cplx> const&,ManageStore&);
+
+template<typename T>
+void
+doTask(Order<IQIndex> const& O,
+       SU2Dense<T> & dB)
+    {
+    auto const dA = dB;
+    dB = SU2Dense<T>(O.is2());
+    addPermuted(O.perm(),dA,O.is1(),dB,O.is2(),1.);
+    }
+template void doTask(Order<IQIndex> const&,SU2Dense<Real> &);
+template void doTask(Order<IQIndex> const&,SU2Dense<Cplx> &);
+
+} //namespace itensor
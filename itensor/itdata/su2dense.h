@@ -0,0 +1,365 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#ifndef __ITENSOR_SU2DENSE_H
+#define __ITENSOR_SU2DENSE_H
+
+#include <vector>
+#include "itensor/itdata/task_types.h"
+#include "itensor/iqindex.h"
+#include "itensor/itdata/itdata.h"
+#include "itensor/itdata/storagepool.h"
+#include "itensor/tensor/types.h"
+
+namespace itensor {
+
+//
+// Storage for IQTensors with SU(2) symmetry
+//
+// Each sector of an IQIndex of such a tensor is a
+// spin multiplet: its QN is su2QN(tj) with tj = 2j,
+// and the m() of the sector Index counts the copies
+// of the multiplet. Only reduced matrix elements are
+// stored. A block is labeled by a sector of each
+// index followed by the intermediate doubled spins
+// k_1,...,k_(r-3) of a fusion tree, and stands for
+// the product of its elements with the real, SU(2)
+// invariant tensor su2FusionTensor(tj,dir,k) of the
+// projections m of each index.
+//
+// Products and sums recouple the fusion trees with
+// coefficients obtained from overlaps of fusion
+// tensors (Clebsch-Gordan contractions, equivalent to
+// the 6j symbols in su2.h); these are cached per thread.
+//
+
+template<typename T>
+class SU2Dense;
+
+using SU2DenseReal = SU2Dense<Real>;
+using SU2DenseCplx = SU2Dense<Cplx>;
+
+struct SU2BlOf
+    {
+    std::vector<long> block;
+        //^ sector of each index, followed by
+        //  the intermediate spins of the tree
+    long offset = 0;
+    long norm2 = 1;
+        //^ squared norm of the fusion tensor
+
+    void
+    write(std::ostream& s) const;
+
+    void
+    read(std::istream& s);
+    };
+
+template<typename T>
+class SU2Dense
+    {
+    static_assert(not std::is_const<T>::value,
+                  "Template argument of SU2Dense must be non-const");
+    public:
+    using value_type = T;
+    using storage_type = std::vector<value_type>;
+    using iterator = typename storage_type::iterator;
+    using const_iterator = typename storage_type::const_iterator;
+
+    //////////////
+    std::vector<SU2BlOf> offsets;
+        //^ Block labels / data offsets,
+        //  sorted by block label
+
+    storage_type store;
+        //^ reduced elements stored contiguously
+    //////////////
+
+    SU2Dense() { }
+
+    //Zero-initialized storage with a block
+    //for every fusion tree allowed by is
+    explicit
+    SU2Dense(IQIndexSet const& is);
+
+    //Zero-initialized data of the given size,
+    //from the storage pool
+    SU2Dense(std::vector<SU2BlOf> const& off,
+             size_t size)
+      : offsets(off),
+        store(acquireStorage<value_type>(size))
+        { }
+
+    template<typename InputIter>
+    SU2Dense(std::vector<SU2BlOf> const& off,
+             InputIter && b, InputIter && e)
+      : offsets(off),
+        store(acquireStorage<value_type>(std::distance(b,e)))
+        {
+        std::copy(b,e,store.begin());
+        }
+
+    SU2Dense(SU2Dense const& other)
+      : offsets(other.offsets),
+        store(copyStorage(other.store))
+        { }
+
+    SU2Dense(SU2Dense&& other) = default;
+
+    SU2Dense&
+    operator=(SU2Dense const& other)
+        {
+        if(this != &other)
+            {
+            offsets = other.offsets;
+            releaseStorage(store);
+            store = copyStorage(other.store);
+            }
+        return *this;
+        }
+
+    SU2Dense&
+    operator=(SU2Dense&& other)
+        {
+        if(this != &other)
+            {
+            offsets = std::move(other.offsets);
+            releaseStorage(store);
+            store = std::move(other.store);
+            }
+        return *this;
+        }
+
+    ~SU2Dense() { releaseStorage(store); }
+
+    explicit operator bool() const { return !store.empty() && !offsets.empty(); }
+
+    value_type *
+    data() { return store.data(); }
+
+    value_type const*
+    data() const { return store.data(); }
+
+    size_t
+    size() const { return store.size(); }
+
+    iterator
+    begin() { return store.begin(); }
+
+    iterator
+    end() { return store.end(); }
+
+    const_iterator
+    begin() const { return store.begin(); }
+
+    const_iterator
+    end() const { return store.end(); }
+    };
+
+//QN of a sector holding multiplets of spin tj/2
+QN inline
+su2QN(int tj) { return QN(tj); }
+
+//Doubled spin of a sector with QN q
+int inline
+su2Spin(QN const& q) { return q[0]; }
+
+//Doubled spins of the sectors of each index
+//in a block label
+std::vector<long>
+su2Spins(IQIndexSet const& is,
+         std::vector<long> const& block);
+
+//Intermediate spins k_1,...,k_(n-3) of all fusion
+//trees of n spins tj, fusing them from the first
+//to the next-to-last into the last (k_0 = tj[0])
+std::vector<std::vector<long>>
+su2FusionTrees(std::vector<long> const& tj);
+
+//Fusion tensor of the spins tj and tree k, of size
+//(tj[0]+1)*...*(tj[n-1]+1) with the first index
+//fastest and projections m = -j,...,j. The last
+//index is the output of the tree; indices with the
+//same arrow as it enter through the conjugate
+//representation. Its squared norm is tj[n-1]+1.
+std::vector<Real>
+su2FusionTensor(std::vector<long> const& tj,
+                std::vector<Arrow> const& dir,
+                std::vector<long> const& k);
+
+//Pointer to the block with the given label,
+//or nullptr if there is none
+SU2BlOf const*
+findBlock(std::vector<SU2BlOf> const& offsets,
+          std::vector<long> const& block);
+
+const char*
+typeNameOf(SU2DenseReal const& d);
+const char*
+typeNameOf(SU2DenseCplx const& d);
+
+template<typename T>
+bool constexpr
+isReal(SU2Dense<T> const& t) { return std::is_same<T,Real>::value; }
+
+template<typename T>
+bool constexpr
+isCplx(SU2Dense<T> const& t) { return std::is_same<T,Cplx>::value; }
+
+Data inline
+realData(SU2DenseReal & d) { return Data(d.data(),d.size()); }
+
+Datac inline
+realData(SU2DenseReal const& d) { return Datac(d.data(),d.size()); }
+
+Data inline
+realData(SU2DenseCplx & d) { return Data(reinterpret_cast<Real*>(d.data()),2*d.size()); }
+
+Datac inline
+realData(SU2DenseCplx const& d) { return Datac(reinterpret_cast<const Real*>(d.data()),2*d.size()); }
+
+template<typename T>
+void
+write(std::ostream & s, SU2Dense<T> const& dat)
+    {
+    itensor::write(s,dat.offsets);
+    itensor::write(s,dat.store);
+    }
+
+template<typename T>
+void
+read(std::istream & s, SU2Dense<T> & dat)
+    {
+    itensor::read(s,dat.offsets);
+    itensor::read(s,dat.store);
+    }
+
+template<typename T>
+Datac
+writeHeader(std::ostream & s, SU2Dense<T> const& dat)
+    {
+    itensor::write(s,dat.offsets);
+    itensor::write(s,dat.store.size());
+    return realData(dat);
+    }
+
+template<typename T>
+Data
+readHeader(std::istream & s, SU2Dense<T> & dat)
+    {
+    itensor::read(s,dat.offsets);
+    auto size = dat.store.size();
+    itensor::read(s,size);
+    dat.store.resize(size);
+    return realData(dat);
+    }
+
+//SU(2) invariant tensors carry no abelian flux
+template<typename T>
+QN
+doTask(CalcDiv const& C, SU2Dense<T> const& D) { return QN{}; }
+
+template<typename F>
+void
+doTask(GenerateIT<F,Real>& G, SU2DenseReal & D)
+    {
+    stdx::generate(D,G.f);
+    }
+
+template<typename F>
+void
+doTask(GenerateIT<F,Real>& G, SU2DenseCplx const& D, ManageStore & m)
+    {
+    auto *nD = m.makeNewData<SU2DenseReal>(D.offsets,D.size());
+    stdx::generate(*nD,G.f);
+    }
+
+template<typename F>
+void
+doTask(GenerateIT<F,Cplx>& G, SU2DenseReal const& D, ManageStore & m)
+    {
+    auto *nD = m.makeNewData<SU2DenseCplx>(D.offsets,D.size());
+    stdx::generate(*nD,G.f);
+    }
+
+template<typename F>
+void
+doTask(GenerateIT<F,Cplx>& G, SU2DenseCplx & D)
+    {
+    stdx::generate(D,G.f);
+    }
+
+//Only defined for rank 0: other elements
+//are available through toSzBasis (su2tensor.h)
+template<typename T>
+Cplx
+doTask(GetElt<IQIndex>& G, SU2Dense<T> const& d);
+
+template<typename T>
+void
+doTask(Mult<Real> const& M, SU2Dense<T>& d);
+
+void
+doTask(Mult<Cplx> const& M, SU2DenseReal const& d, ManageStore & m);
+
+void
+doTask(Mult<Cplx> const& M, SU2DenseCplx & d);
+
+//Fusion tensors are real and do not change when
+//all arrows are reversed, so only the reduced
+//elements are conjugated
+void inline
+doTask(Conj, SU2DenseReal const& d) { }
+
+void
+doTask(Conj, SU2DenseCplx & d);
+
+template<typename T>
+bool constexpr
+doTask(CheckComplex, SU2Dense<T> const& d) { return isCplx(d); }
+
+template<typename T>
+Real
+doTask(NormNoScale, SU2Dense<T> const& D);
+
+template<typename T>
+void
+doTask(PrintIT<IQIndex>& P, SU2Dense<T> const& d);
+
+auto inline constexpr
+doTask(StorageType const& S, SU2DenseReal const& d) ->StorageType::Type { return StorageType::SU2DenseReal; }
+
+auto inline constexpr
+doTask(StorageType const& S, SU2DenseCplx const& d) ->StorageType::Type { return StorageType::SU2DenseCplx; }
+
+template<typename TA, typename TB>
+void
+doTask(PlusEQ<IQIndex> const& P,
+       SU2Dense<TA>    const& A,
+       SU2Dense<TB>    const& B,
+       ManageStore          & m);
+
+template<typename VA, typename VB>
+void
+doTask(Contract<IQIndex>& Con,
+       SU2Dense<VA> const& A,
+       SU2Dense<VB> const& B,
+       ManageStore& m);
+
+template<typename T>
+void
+doTask(Order<IQIndex> const& P,
+       SU2Dense<T>         & dA);
+
+template<typename V>
+ITensor
+doTask(ToITensor & T, SU2Dense<V> const& d);
+
+template<typename V>
+bool
+doTask(IsEmpty, SU2Dense<V> const& d) { return d.offsets.empty(); }
+
+} //namespace itensor
+
+#endif
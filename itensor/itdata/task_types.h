@@ -348,6 +348,20 @@ typeNameOf(Order<I> const&) { return "Order"; }
 //
 // Helper for Contract and NCProd
 //
+// Returns the factor the data of the result was
+// divided by, to be multiplied into the scale of the
+// ITensor, or NAN if the data was left unchanged.
+//
+// Data with a norm below 1E-11 is never rescaled.
+// With Global::deferRescale() false, every other
+// result is normalized. By default (deferRescale()
+// true) the data is only rescaled if its norm is
+// above 1E30, saving a pass over it which multiplies
+// every element. This bounds the data of contraction
+// results only: tensors made by sums, svd, set() or
+// read() are not checked and may have data of any
+// norm, as when rescaling was not deferred.
+//
 template<typename Storage>
 Real
 computeScalefac(Storage & dat)
@@ -363,6 +377,7 @@ computeScalefac(Storage & dat)
     auto scalefac = doTask(NormNoScale{},dat);
     //Here the NAN acts as a flag meaning "don't rescale"
     if(std::fabs(scalefac) < 1E-11) return NAN;
+    if(Global::deferRescale() && scalefac <= 1E30) return NAN;
     doTask(Mult<Real>{1./scalefac},dat);
     return scalefac;
     }
@@ -459,13 +474,76 @@ struct StorageType
         QDiagReal=9,
         QDiagCplx=10,
         ScalarReal=11,
-        ScalarCplx=12
+        ScalarCplx=12,
+        SU2DenseReal=13,
+        SU2DenseCplx=14
         }; 
     };
 
 inline const char*
 typeNameOf(StorageType const&) { return "StorageType"; }
 
+//
+// WriteHeader and ReadHeader split a storage into
+// a header (written to a stream) and its contiguous
+// data, returned as a range of Reals so it can be
+// sent or received directly without an extra copy.
+// Storage types without contiguous data write/read
+// themselves entirely and return an empty range.
+//
+
+struct WriteHeader
+    {
+    std::ostream& s;
+    WriteHeader(std::ostream& s_) : s(s_) { }
+    };
+
+inline const char*
+typeNameOf(WriteHeader const&) { return "WriteHeader"; }
+
+struct ReadHeader
+    {
+    std::istream& s;
+    ReadHeader(std::istream& s_) : s(s_) { }
+    };
+
+inline const char*
+typeNameOf(ReadHeader const&) { return "ReadHeader"; }
+
+template<typename D>
+auto
+writeHeader(std::ostream& s, D const& d)
+    -> stdx::if_compiles_return<Datac,decltype(write(s,d))>
+    {
+    write(s,d);
+    return Datac{};
+    }
+
+template<typename D>
+auto
+readHeader(std::istream& s, D & d)
+    -> stdx::if_compiles_return<Data,decltype(read(s,d))>
+    {
+    read(s,d);
+    return Data{};
+    }
+
+template<typename D>
+auto
+doTask(WriteHeader & W, D const& d)
+    -> stdx::if_compiles_return<Datac,decltype(writeHeader(W.s,d))>
+    {
+    return writeHeader(W.s,d);
+    }
+
+template<typename D>
+auto
+doTask(ReadHeader & R, D & d)
+    -> stdx::if_compiles_return<Data,decltype(readHeader(R.s,d))>
+    {
+    return readHeader(R.s,d);
+    }
+
 
 //template<typename T>
 //void
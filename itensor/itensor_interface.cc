@@ -131,6 +131,27 @@ write(std::ostream& s) const
 template void ITensorT<Index>::write(std::ostream& s) const;
 template void ITensorT<IQIndex>::write(std::ostream& s) const;
 
+template<typename I>
+Datac ITensorT<I>::
+writeHeader(std::ostream& s) const
+    {
+    itensor::write(s,inds());
+    itensor::write(s,scale());
+    auto type = StorageType::Null;
+    if(store()) 
+        {
+        type = doTask(StorageType{},store());
+        }
+    itensor::write(s,type);
+    if(store()) 
+        {
+        return doTask(WriteHeader{s},store());
+        }
+    return Datac{};
+    }
+template Datac ITensorT<Index>::writeHeader(std::ostream& s) const;
+template Datac ITensorT<IQIndex>::writeHeader(std::ostream& s) const;
+
 template<class I>
 ITensorT<I>
 multSiteOps(ITensorT<I> A, ITensorT<I> const& B) 
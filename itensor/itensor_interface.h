@@ -296,6 +296,18 @@ class ITensorT
     void
     write(std::ostream& s) const;
 
+    //Binary form of write: writes everything except
+    //the contiguous storage data, which is returned
+    //so it can be written or sent separately
+    Datac
+    writeHeader(std::ostream& s) const;
+
+    //Reads the output of writeHeader, allocating storage
+    //of the right size; returns the range into which
+    //the storage data should be read or received
+    Data
+    readHeader(std::istream& s);
+
 
     //
     // Developer / advanced methods
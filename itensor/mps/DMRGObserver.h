@@ -48,7 +48,9 @@ class DMRGObserver : public Observer
 
     MPSt<Tensor> const& psi_;
     Real energy_errgoal; //Stop DMRG once energy has converged to this precision
+    Real variance_errgoal; //Stop DMRG once the two-site energy variance is below this
     bool printeigs;      //Print slowest decaying eigenvalues after every sweep
+    bool printstats;     //Print Davidson matvec and storage buffer counts after every sweep
     int max_eigs;
     Real max_te;
     bool done_;
@@ -65,7 +67,9 @@ DMRGObserver(MPSt<Tensor> const& psi, Args const& args)
     : 
     psi_(psi),
     energy_errgoal(args.getReal("EnergyErrgoal",-1)), 
+    variance_errgoal(args.getReal("VarianceErrgoal",-1)), 
     printeigs(args.getBool("PrintEigs",true)),
+    printstats(args.getBool("PrintSweepStats",false)),
     max_eigs(-1),
     max_te(-1),
     done_(false),
@@ -140,6 +144,21 @@ measure(Args const& args)
         println("    Largest truncation error: ",(max_te > 0 ? max_te : 0.));
         max_te = -1;
         printfln("    Energy after sweep %s is %.12f",swstr,energy);
+        if(printstats && args.defined("DavidsonMatvecs"))
+            {
+            auto nmv = args.getInt("DavidsonMatvecs");
+            printfln("    Davidson matvecs during sweep %s: %d (%.2f per bond)",swstr,nmv,nmv/(2.*std::max(N-1,1)));
+            }
+        if(printstats && args.defined("StorageNAlloc"))
+            {
+            printfln("    Storage buffers during sweep %s: %d allocated (%.1f MB), %d reused (%.1f MB)",swstr,
+                     args.getInt("StorageNAlloc"),args.getReal("StorageAllocMB"),
+                     args.getInt("StorageNReuse"),args.getReal("StorageReuseMB"));
+            }
+        if(args.defined("EnergyVariance"))
+            {
+            printfln("    Two-site energy variance after sweep %s is %.3E",swstr,args.getReal("EnergyVariance"));
+            }
         }
 
     }
@@ -166,6 +185,17 @@ checkDone(Args const& args)
         }
     last_energy_ = energy;
 
+    if(variance_errgoal > 0 && args.defined("EnergyVariance"))
+        {
+        auto var = args.getReal("EnergyVariance");
+        if(var < variance_errgoal)
+            {
+            printfln("    Energy variance goal met (var = %.3E < %.3E); returning after %d sweeps.",
+                      var, variance_errgoal, sw);
+            return true;
+            }
+        }
+
     //If STOP_DMRG found, will return true (i.e. done) once, but 
     //outer calling using same Observer may continue running e.g. infinite dmrg calling finite dmrg.
     if(fileExists("STOP_DMRG"))
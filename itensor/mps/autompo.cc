@@ -3,9 +3,12 @@
 //    (See accompanying LICENSE file.)
 //
 #include <algorithm>
+#include <future>
 #include <map>
+#include <unordered_map>
 #include "itensor/util/print_macro.h"
 #include "itensor/mps/autompo.h"
+#include "itensor/util/cputime.h"
 #include "itensor/tensor/algs.h"
 
 using std::find;
@@ -368,17 +371,50 @@ add(HTerm const& t)
     auto it = terms_.find(t);
     if(it == terms_.end())
         {
-        terms_.insert(move(t));
+        terms_.insert(t);
         }
     else //found duplicate
         {
-        auto nt = t;
-        nt.coef += it->coef;
-        terms_.erase(it);
-        terms_.insert(move(nt));
+        //coef is not part of the set ordering
+        //so it can be updated in place
+        const_cast<HTerm&>(*it).coef += t.coef;
         }
     }
 
+void AutoMPO::
+add(vector<HTerm> const& terms)
+    {
+    auto less = LessNoCoef();
+    auto sorted = stdx::reserve_vector<HTerm>(terms.size());
+    for(auto& t : terms) if(abs(t.coef) != 0.0) sorted.push_back(t);
+    std::stable_sort(sorted.begin(),sorted.end(),less);
+
+    //Merge the sorted terms with the existing ones
+    //into a new set, combining duplicates; inserting
+    //at the end of a set is amortized constant time
+    auto merged = storage();
+    auto append = [&merged,&less](HTerm const& t)
+        {
+        if(!merged.empty() && !less(*merged.rbegin(),t))
+            {
+            //coef is not part of the set ordering
+            const_cast<HTerm&>(*merged.rbegin()).coef += t.coef;
+            }
+        else
+            {
+            merged.emplace_hint(merged.end(),t);
+            }
+        };
+    auto it = terms_.begin();
+    for(auto& t : sorted)
+        {
+        for(; it != terms_.end() && !less(t,*it); ++it) append(*it);
+        append(t);
+        }
+    for(; it != terms_.end(); ++it) append(*it);
+    terms_.swap(merged);
+    }
+
 /*
 MPO convention:
 ===============
@@ -582,13 +618,13 @@ toMPOImpl(AutoMPO const& am,
     //the unique operator types occurring on the site
     //(unique including their coefficient)
     //and starting a string of operators (i.e. first op of an HTerm)
+    auto in_basis = vector<std::set<SiteTerm>>(N+1);
     for(auto& ht : am.terms())
         {
         for(auto n = ht.first().i; n <= ht.last().i; ++n)
             {
             auto& bn = basis.at(n);
-            auto test_has_first = [&ht](SiteQN const& sq){ return sq.st == ht.first(); };
-            bool has_first = (stdx::find_if(bn,test_has_first) != bn.end());
+            bool has_first = !in_basis.at(n).insert(ht.first()).second;
             if(!has_first) 
                 {
                 //printfln("Adding Op to basis at %d, Op=\n%s",n,Op);
@@ -891,50 +927,79 @@ struct MatElem
     bool operator==(MatElem const& other) const {return ind == other.ind && val == other.val; }
     };
 
-template<typename T>
-Mat<T>
-toMatrix(vector<MatElem<T>> const& vm)
+//
+// Operator names interned as integer ids, so that
+// products of site operators can be hashed and
+// compared cheaply while partitioning the terms
+//
+class OpIDs
     {
-    Mat<T> M;
-    int nr = 0, nc = 0;
-    
-    for(auto const& elem : vm)
+    std::unordered_map<string,int> ids_;
+    vector<string> names_;
+    public:
+
+    int
+    id(string const& name)
         {
-        nr = max(nr,1+elem.ind.row);
-        nc = max(nc,1+elem.ind.col);
+        auto it = ids_.find(name);
+        if(it != ids_.end()) return it->second;
+        int n = names_.size();
+        ids_.emplace(name,n);
+        names_.push_back(name);
+        return n;
         }
-    
-    resize(M,nr,nc);
-        
-    for(auto const& elem : vm)
+
+    string const&
+    name(int id) const { return names_.at(id); }
+
+    int
+    size() const { return names_.size(); }
+    };
+
+//Product of site operators as (site,op id) pairs,
+//in the same order as HTerm::ops
+using OpProd = vector<pair<int,int>>;
+
+struct OpProdHash
+    {
+    size_t
+    operator()(OpProd const& p) const
         {
-        M(elem.ind.row,elem.ind.col) = elem.val;
+        size_t h = p.size();
+        for(auto& so : p)
+            {
+            auto x = (size_t(so.first) << 32) ^ size_t(so.second);
+            h ^= std::hash<size_t>()(x) + 0x9e3779b97f4a7c15ul + (h << 6) + (h >> 2);
+            }
+        return h;
         }
-    return M;
-    }
+    };
 
-void 
-decomposeTerm(int n, 
-              SiteTermProd const& ops, 
-              SiteTermProd & left, 
-              SiteTermProd & onsite, 
-              SiteTermProd & right)
+struct OpTerm
     {
-    auto isOnSiteOrOnTheRight = [&n](const SiteTerm &t) {return t.i >= n;};
-    auto startOfOnSite = find_if(ops.begin(), ops.end(), isOnSiteOrOnTheRight);
-    
-    auto isOnTheRight = [&n](const SiteTerm &t) {return t.i > n;};
-    auto startOfRightPart = find_if(startOfOnSite, ops.end(), isOnTheRight);
+    Cplx coef;
+    OpProd ops;
 
-    left = SiteTermProd(ops.begin(), startOfOnSite);
-    onsite = SiteTermProd(startOfOnSite, startOfRightPart);
-    right = SiteTermProd(startOfRightPart, ops.end());
-    }  
+    int
+    first() const { return ops.front().first; }
+
+    int
+    last() const { return ops.back().first; }
+
+    //Number of operators on sites <= n
+    int
+    nupto(int n) const
+        {
+        int s = 0;
+        while(s < int(ops.size()) && ops[s].first <= n) ++s;
+        return s;
+        }
+    };
 
 template<typename T>
 struct Block
     {
-    using Basis = map<SiteTermProd,int>;
+    using Basis = std::unordered_map<OpProd,int,OpProdHash>;
     Basis left;
     Basis right;
     vector<MatElem<T>> mat;        
@@ -945,18 +1010,25 @@ using QNBlock = map<QN, Block<T>>;
 using IQMatEls = set<IQMPOMatElem>;
 using MPOMatrix = vector<vector<IQTensor>>;
 
-// Returns a 0-based index of the SiteTermProd ops in the vector
-// If ops is not in the vector adds it is added
+// Returns a 0-based index of the operator product
+// [begin,end) in the basis b, adding it if not present
 template<typename T>
 int
-posInBlock(SiteTermProd const& ops, 
+posInBlock(OpProd::const_iterator begin,
+           OpProd::const_iterator end,
            typename Block<T>::Basis & b)
     {
-    auto it = b.find(ops);
-    if(it != b.end()) return it->second;
-    int i = static_cast<int>(b.size());
-    b[ops] = i;
-    return i;
+    auto res = b.emplace(OpProd(begin,end),int(b.size()));
+    return res.first->second;
+    }
+
+template<typename T>
+int
+findInBlock(OpProd::const_iterator begin,
+            OpProd::const_iterator end,
+            typename Block<T>::Basis const& b)
+    {
+    return b.at(OpProd(begin,end));
     }
 
 template<typename T, typename V>
@@ -973,151 +1045,223 @@ forceType(Cplx z) { return z.real(); }
 Real
 conj(Real x) { return x; }
 
+//Calls f(n) for n in [begin,end) using up to nthread threads,
+//with values of n dealt out round-robin; serially when
+//called from a thread which is itself one of many running
+//in parallel (see detail::inParallelChunk)
+template<typename Func>
+void
+parallelFor(int begin, int end, int nthread, Func&& f)
+    {
+    nthread = std::max(1,std::min(nthread,end-begin));
+    if(nthread == 1 || detail::inParallelChunk())
+        {
+        for(auto n = begin; n < end; ++n) f(n);
+        return;
+        }
+    auto futs = vector<std::future<void>>(nthread);
+    for(auto t : range(nthread))
+        {
+        futs[t] = std::async(std::launch::async,
+                  [=,&f]()
+                      {
+                      //Keeps elementwise loops inside f serial
+                      detail::inParallelChunk() = true;
+                      for(auto n = begin+t; n < end; n += nthread) f(n);
+                      });
+        }
+    //get() rethrows exceptions from the tasks
+    for(auto& ft : futs) ft.get();
+    }
+
+//Calls f(n,active) for each site n in [1,N], where active
+//lists the terms (as positions in terms) with
+//first <= n <= last, in order of their first site.
+//The sites are split into contiguous chunks which are
+//swept in parallel, updating active from site to site.
+template<typename Func>
+void
+sweepTerms(vector<OpTerm> const& terms,
+           int N,
+           int nthread,
+           Func&& f)
+    {
+    auto byfirst = vector<int>(terms.size());
+    for(auto t : range(terms)) byfirst[t] = t;
+    std::stable_sort(byfirst.begin(),byfirst.end(),
+                     [&terms](int a, int b) { return terms[a].first() < terms[b].first(); });
+
+    auto nchunk = (nthread > 1) ? std::min(N,4*nthread) : 1;
+    parallelFor(0,nchunk,nthread,[&](int c)
+        {
+        auto n0 = 1+(c*N)/nchunk,
+             n1 = 1+((c+1)*N)/nchunk;
+        auto active = vector<int>();
+        size_t p = 0;
+        for(; p < byfirst.size() && terms[byfirst[p]].first() <= n0; ++p)
+            {
+            if(terms[byfirst[p]].last() >= n0) active.push_back(byfirst[p]);
+            }
+        for(auto n = n0; n < n1; ++n)
+            {
+            if(n > n0)
+                {
+                auto ended = [&terms,n](int t) { return terms[t].last() < n; };
+                active.erase(std::remove_if(active.begin(),active.end(),ended),active.end());
+                for(; p < byfirst.size() && terms[byfirst[p]].first() == n; ++p)
+                    {
+                    active.push_back(byfirst[p]);
+                    }
+                }
+            f(n,active);
+            }
+        });
+    }
+
 //
 // Construct left & right partials and the 
 // coefficients matrix on each link as well as the temporary MPO
 //
+// Terms are first converted to products of interned op ids,
+// and the QN divergence of each (site,op) pair is computed
+// once. Links, then sites, are then processed independently
+// (in parallel for "NThread" > 1): each link owns its blocks
+// in qbs and each site its elements of tempMPO, and terms
+// are always visited in the same order, so the result does
+// not depend on the number of threads.
+//
 template<typename T>
 void
 partitionHTerms(SiteSet const& sites,
                 AutoMPO::storage const& terms,
                 vector<QNBlock<T>> & qbs, 
                 vector<IQMatEls> & tempMPO,
-                bool checkqns = true)
+                bool checkqns = true,
+                int nthread = 1)
     {
+    PROFILE_SCOPE("AutoMPO partition")
     auto N = sites.N();
 
-    // TODO: This version of calcQN uses a "qnmap" to improve
-    //       the speed.
-    //       The qnmap keys are just strings, which assumes
-    //       all operators with the same name have the same
-    //       QN divergence. This wouldn't be true e.g. for
-    //       a spin model with different spin sizes at 
-    //       different sites.
-    //
-    //auto qnmap = map<string,QN>();
-    //auto calcQN = [&qnmap,&sites](SiteTermProd const& prod)
-    //    {
-    //    QN qn;
-    //    for(auto& st : prod)
-    //        {
-    //        auto it = qnmap.find(st.op);
-    //        if(it != qnmap.end())
-    //            {
-    //            qn += it->second;
-    //            }
-    //        else
-    //            {
-    //            auto Op = sites.op(st.op,st.i);
-    //            auto OpQN = -div(Op);
-    //            qnmap[st.op] = OpQN;
-    //            qn += OpQN;
-    //            }
-    //        }
-    //    return qn;
-    //    };
-
-    auto calcQN = [&sites](SiteTermProd const& prod)
+    auto opids = OpIDs();
+    auto oterms = stdx::reserve_vector<OpTerm>(terms.size());
+    for(HTerm const& ht : terms)
         {
-        QN qn;
-        for(auto& st : prod)
+        auto ot = OpTerm{ht.coef,OpProd{}};
+        ot.ops.reserve(ht.ops.size());
+        for(auto& st : ht.ops) ot.ops.emplace_back(st.i,opids.id(st.op));
+        oterms.push_back(move(ot));
+        }
+    auto nid = opids.size();
+
+    auto fermionic = vector<char>(nid);
+    for(auto id : range(nid)) fermionic[id] = isFermionic(SiteTerm(opids.name(id),1));
+
+    //QN divergence of each (site,op) pair, computed once;
+    //sites.op is not called inside the parallel loops
+    auto qdiv = vector<vector<QN>>(N+1);
+    if(checkqns)
+        {
+        auto have = vector<vector<char>>(N+1,vector<char>(nid,0));
+        for(auto& n : qdiv) n.resize(nid);
+        for(auto& ot : oterms)
+        for(auto& so : ot.ops)
             {
-            auto Op = sites.op(st.op,st.i);
-            auto OpQN = -div(Op);
-            qn += OpQN;
+            if(have[so.first][so.second]) continue;
+            qdiv[so.first][so.second] = -div(sites.op(opids.name(so.second),so.first));
+            have[so.first][so.second] = 1;
             }
+        }
+    auto calcQN = [checkqns,&qdiv](OpProd::const_iterator begin,
+                                   OpProd::const_iterator end)
+        {
+        QN qn;
+        if(checkqns) for(auto it = begin; it != end; ++it) qn += qdiv[it->first][it->second];
         return qn;
         };
+    auto isFermionicProd = [&fermionic](OpProd::const_iterator begin,
+                                        OpProd::const_iterator end)
+        {
+        bool isf = false;
+        for(auto it = begin; it != end; ++it) if(fermionic[it->second]) isf = !isf;
+        return isf;
+        };
 
     qbs.resize(N);
     tempMPO.resize(N);
 
-    for(HTerm const& ht : terms)
-    for(int n = ht.first().i; n <= ht.last().i; ++n)
+    // qbs.at(i) are the blocks at the link between sites i+1 and i+2
+    // i.e. qbs.at(0) are the blocks at the link between sites 1 and 2
+    // and qbs.at(N-2) are the blocks at the link between sites N-1 and N
+    // for site n the link on the left is qbs.at(n-2) and the link on the right is qbs.at(n-1)
+
+    //Bases and coefficient matrices of each link b,
+    //from the terms crossing it
+    sweepTerms(oterms,N,nthread,[&](int b, vector<int> const& active)
         {
-        SiteTermProd left, onsite, right;
-        decomposeTerm(n, ht.ops, left, onsite, right);
-        
-        TIMER_START(10)
-        QN lqn,sqn;
-        if(checkqns)
+        if(b == N) return;
+        auto& qb = qbs.at(b-1);
+        for(auto t : active)
             {
-            lqn = calcQN(left);
-            sqn = calcQN(onsite);
+            auto& ot = oterms[t];
+            if(ot.last() == b) continue;
+            auto mid = ot.ops.begin()+ot.nupto(b);
+            auto& block = qb[calcQN(ot.ops.begin(),mid)];
+            auto l = posInBlock<T>(ot.ops.begin(),mid,block.left);
+            auto j = posInBlock<T>(mid,ot.ops.end(),block.right);
+            block.mat.emplace_back(MatIndex(l,j),forceType<T>(ot.coef));
             }
-        TIMER_STOP(10)
-        
-        TIMER_START(11)
-        int j=-1,k=-1;
-
-        // qbs.at(i) are the blocks at the link between sites i+1 and i+2
-        // i.e. qbs.at(0) are the blocks at the link between sites 1 and 2
-        // and qbs.at(N-2) are the blocks at the link between sites N-1 and N
-        // for site n the link on the left is qbs.at(n-2) and the link on the right is part.at(n-1)
-        if(left.empty())
+        });
+
+    //Elements of the temporary MPO at each site n,
+    //referring to the link bases found above
+    sweepTerms(oterms,N,nthread,[&](int n, vector<int> const& active)
+        {
+        auto& tn = tempMPO.at(n-1);
+        for(auto t : active)
             {
-            if(not right.empty()) // term starting on site n
+            auto& ot = oterms[t];
+            auto sbeg = ot.ops.begin()+ot.nupto(n-1);
+            auto send = ot.ops.begin()+ot.nupto(n);
+            auto lqn = calcQN(ot.ops.begin(),sbeg);
+            auto sqn = calcQN(sbeg,send);
+            bool has_left = (sbeg != ot.ops.begin());
+            bool has_right = (send != ot.ops.end());
+
+            int j=-1,k=-1;
+            if(has_left)
                 {
-                k = posInBlock<T>(right, qbs.at(n-1)[sqn].right);
+                auto& leftlink = qbs.at(n-2).at(lqn);
+                j = findInBlock<T>(sbeg,ot.ops.end(),leftlink.right);
                 }
-            }
-        else
-            {
-            auto& leftlink = qbs.at(n-2)[lqn];
-            if(right.empty()) // term ending on site n
+            if(has_right)
                 {
-                j = posInBlock<T>(onsite, leftlink.right);
+                k = findInBlock<T>(send,ot.ops.end(),qbs.at(n-1).at(lqn+sqn).right);
+                }
+
+            // Place the coefficient of the HTerm when the term starts
+            Cplx c = (j == -1) ? ot.coef : 1;
+
+            auto onsite = SiteTermProd{};
+            for(auto it = sbeg; it != send; ++it) onsite.emplace_back(opids.name(it->second),n);
+
+            bool leftF = isFermionicProd(ot.ops.begin(),sbeg);
+            if(onsite.empty())
+                {
+                if(leftF) onsite.emplace_back("F",n);
+                else      onsite.emplace_back("Id",n);
                 }
             else
                 {
-                j = posInBlock<T>(mult(onsite,right), leftlink.right);
-                k = posInBlock<T>(right, qbs.at(n-1)[lqn+sqn].right);
+                rewriteFermionic(onsite, leftF);
                 }
-            auto l = posInBlock<T>(left,leftlink.left);
-            leftlink.mat.emplace_back(MatIndex(l, j),forceType<T>(ht.coef));
-            }
-            
-        // Place the coefficient of the HTerm when the term starts
-        Cplx c = (j == -1) ? ht.coef : 1;
-        
-        bool leftF = isFermionic(left);
-        if(onsite.empty())
-            {
-            if(leftF) onsite.emplace_back("F",n);
-            else      onsite.emplace_back("Id",n);
-            }
-        else
-            {
-            rewriteFermionic(onsite, leftF);
-            }
-        TIMER_STOP(11)
-        
-        //
-        // Add only unique IQMPOMatElems to tempMPO
-        // TODO: assumes terms are unique I think!
-        // 
-        TIMER_START(12)
-        auto& tn = tempMPO.at(n-1);
-        auto el = IQMPOMatElem(lqn, lqn+sqn, j, k, HTerm(c, onsite));
-
-        ////TODO DEBUG
-        //auto target = QN(-2,2);
-        //if(lqn == target || (lqn+sqn == target))
-        //    {
-        //    Print(lqn);
-        //    Print(lqn+sqn);
-        //    Print(sqn);
-        //    printfln("j,k = %d,%d",j,k);
-        //    Print(ht);
-        //    Print(HTerm(c,onsite));
-        //    PAUSE
-        //    }
-
-        auto it = tn.find(el);
-        if(it == tn.end()) tn.insert(move(el));
 
-        TIMER_STOP(12)
-        }
+            //
+            // Add only unique IQMPOMatElems to tempMPO
+            // TODO: assumes terms are unique I think!
+            // 
+            tn.insert(IQMPOMatElem(lqn, lqn+sqn, j, k, HTerm(c, move(onsite))));
+            }
+        });
     }
 
 
@@ -1137,7 +1281,123 @@ operator<(QNProd const& p1, QNProd const& p2)
 template<typename T>
 using MPOPiece = map<QNProd,Mat<T>>;
 
+//
+// Truncated right singular vectors of the coefficient
+// matrix of one QN sector of a link, as columns of V.
+//
+// The matrix is very sparse, and after permuting its
+// rows and columns it is usually block diagonal: the
+// blocks (connected components of the rows and columns
+// sharing nonzero elements) are decomposed separately
+// and their singular values truncated together, which
+// gives the same result as an SVD of the whole matrix.
+//
+template<typename T>
+Mat<T>
+compressSector(vector<MatElem<T>> const& mat,
+               int minm,
+               int maxm,
+               Real cutoff,
+               int & ncomp)
+    {
+    int nr = 0, nc = 0;
+    for(auto const& elem : mat)
+        {
+        nr = max(nr,1+elem.ind.row);
+        nc = max(nc,1+elem.ind.col);
+        }
+
+    //Union-find over rows (0..nr-1) and columns (nr..nr+nc-1)
+    auto parent = vector<int>(nr+nc);
+    for(auto i : range(parent)) parent[i] = i;
+    auto root = [&parent](int i)
+        {
+        while(parent[i] != i) i = parent[i] = parent[parent[i]];
+        return i;
+        };
+    for(auto const& elem : mat)
+        {
+        auto a = root(elem.ind.row),
+             b = root(nr+elem.ind.col);
+        if(a != b) parent[max(a,b)] = min(a,b);
+        }
+
+    //Local row and column numbering within each component
+    auto comp = vector<int>(nr+nc,-1);
+    auto local = vector<int>(nr+nc);
+    auto nrows_c = vector<int>(),
+         ncols_c = vector<int>();
+    auto cols_c = vector<vector<int>>();
+    for(auto i : range(nr+nc))
+        {
+        auto r = root(i);
+        if(comp[r] == -1)
+            {
+            comp[r] = nrows_c.size();
+            nrows_c.push_back(0);
+            ncols_c.push_back(0);
+            cols_c.emplace_back();
+            }
+        auto c = comp[r];
+        comp[i] = c;
+        if(i < nr) 
+            {
+            local[i] = nrows_c[c]++;
+            }
+        else
+            {
+            local[i] = ncols_c[c]++;
+            cols_c[c].push_back(i-nr);
+            }
+        }
+    ncomp = nrows_c.size();
+
+    auto Ms = vector<Mat<T>>(ncomp);
+    for(auto c : range(ncomp)) Ms[c] = Mat<T>(nrows_c[c],ncols_c[c]);
+    for(auto const& elem : mat)
+        {
+        auto r = elem.ind.row;
+        Ms[comp[r]](local[r],local[nr+elem.ind.col]) = elem.val;
+        }
+
+    struct SingVal
+        {
+        Real p;
+        int comp, n;
+        };
+    auto svals = vector<SingVal>();
+    auto Vs = vector<Mat<T>>(ncomp);
+    for(auto c : range(ncomp))
+        {
+        Mat<T> U;
+        Vector D;
+        SVD(Ms[c],U,D,Vs[c]);
+        //square singular vals for call to truncate
+        for(auto n : range(D)) svals.push_back({sqr(D(n)),c,int(n)});
+        }
+    std::stable_sort(svals.begin(),svals.end(),
+                     [](SingVal const& a, SingVal const& b) { return a.p > b.p; });
+
+    auto P = Vector(svals.size());
+    for(auto n : range(svals)) P(n) = svals[n].p;
+    truncate(P,maxm,minm,cutoff);
+    int m = P.size();
+
+    auto V = Mat<T>(nc,m);
+    for(auto t : range(m))
+        {
+        auto& Vc = Vs[svals[t].comp];
+        auto& cols = cols_c[svals[t].comp];
+        for(auto j : range(cols)) V(cols[j],t) = Vc(j,svals[t].n);
+        }
+    return V;
+    }
+
 // SVD the coefficients matrix on each link and construct the compressed MPO matrix
+//
+// The QN sectors of all links are compressed independently,
+// then the MPO matrices of each site; both steps are split
+// over nthread threads.
 template<typename T>
 void
 compressMPO(SiteSet const& sites,
@@ -1147,84 +1407,103 @@ compressMPO(SiteSet const& sites,
             vector<IQIndex> & links, 
             bool isExpH = false, 
             Complex tau = 0,
-            Args const& args = Args::global())
+            Args const& args = Args::global(),
+            int nthread = 1)
     {
+    PROFILE_SCOPE("AutoMPO compress")
     const int N = sites.N();
     Real eps = 1E-14;
 
     int minm = args.getInt("Minm",1);
     int maxm = args.getInt("Maxm",5000);
     Real cutoff = args.getReal("Cutoff",1E-13);
-    //printfln("Using cutoff = %.2E",cutoff);
-    //printfln("Using minm = %d",minm);
-    //printfln("Using maxm = %d",maxm);
+    auto verbose = args.getBool("Verbose",false);
+
+    //Put in factor of (-tau) if isExpH==true
+    if(isExpH) Error("Need to put in factor of (-tau)");
 
     finalMPO.resize(N);
     links.resize(N+1);
     
-    auto V_n = map<QN, Mat<T>>();
-    
     const QN ZeroQN;
     
     int d0 = isExpH ? 1 : 2;
-    
-    links.at(0) = IQIndex("Hl0",Index("hl0_0",d0),ZeroQN);
 
-    auto max_d = links.at(0).m();
+    //
+    // Compress each QN sector of each link
+    //
+    struct Sector
+        {
+        int n;
+        QN const* qn;
+        Block<T> const* block;
+        int ncomp = 0;
+        Real time = 0;
+        };
+    // V.at(n) are the singular vectors for the link between
+    // sites n and n+1, in the basis of the right partials
+    auto V = vector<map<QN,Mat<T>>>(N+1);
+    auto sectors = vector<Sector>();
     for(int n = 1; n <= N; ++n)
+    for(auto& qb : qbs.at(n-1))
         {
-        //printfln("=== Making compressed MPO at site %d ===",n);
-        //Put in factor of (-tau) if isExpH==true
-        if(isExpH) Error("Need to put in factor of (-tau)");
-
-        auto V_npp = map<QN, Mat<T>>();
-
-        int nsector = 1; //always have ZeroQN sector
-
-        for(auto& qb : qbs.at(n-1) )
+        V.at(n)[qb.first];
+        auto s = Sector{};
+        s.n = n;
+        s.qn = &qb.first;
+        s.block = &qb.second;
+        sectors.push_back(s);
+        }
+    //Largest sectors first for better load balance
+    std::stable_sort(sectors.begin(),sectors.end(),
+                     [](Sector const& a, Sector const& b) 
+                     { return a.block->mat.size() > b.block->mat.size(); });
+        {
+        PROFILE_SCOPE("AutoMPO svd")
+        parallelFor(0,sectors.size(),nthread,[&](int s)
             {
-            auto& qn = qb.first;
-            if(qn != ZeroQN) ++nsector;
-
-            // Convert the block matrix elements to a dense matrix
-            auto M = toMatrix(qb.second.mat);
-
-            auto& V = V_npp[qn];
-
-            Mat<T> U;
-            Vector D;
-            SVD(M,U,D,V);
-
-            //square singular vals for call to truncate
-            for(auto& d : D) d = sqr(d);
-            truncate(D,maxm,minm,cutoff);
-            int m = D.size();
+            auto& S = sectors[s];
+            auto t = cpu_time();
+            V.at(S.n).at(*S.qn) = compressSector(S.block->mat,minm,maxm,cutoff,S.ncomp);
+            S.time = t.sincemark().wall;
+            });
+        }
 
-            int nc = ncols(M);
-            resize(V,nc,m);
-            }
+    auto emptyV = Mat<T>();
+    auto getV = [&V,&emptyV](int n, QN const& q) -> Mat<T> const&
+        {
+        auto it = V.at(n).find(q);
+        return (it == V.at(n).end()) ? emptyV : it->second;
+        };
 
+    links.at(0) = IQIndex("Hl0",Index("hl0_0",d0),ZeroQN);
+    for(int n = 1; n <= N; ++n)
+        {
         int count = 0;
-        auto inqn = stdx::reserve_vector<IndexQN>(nsector);
+        auto inqn = stdx::reserve_vector<IndexQN>(1+qbs.at(n-1).size());
         // Make sure zero QN is first in the list of indices
-        inqn.emplace_back(Index(format("hl%d_%d",n,count++),d0+ncols(V_npp[ZeroQN])),ZeroQN);        
+        inqn.emplace_back(Index(format("hl%d_%d",n,count++),d0+ncols(getV(n,ZeroQN))),ZeroQN);        
         for(auto const& qb : qbs.at(n-1))
             {
             QN const& q = qb.first;
             if(q == ZeroQN) continue; // was already taken care of
-            int m = ncols(V_npp[q]);
+            int m = ncols(getV(n,q));
             inqn.emplace_back(Index(format("hl%d_%d",n,count++),m),q);
             }
         links.at(n) = IQIndex(nameint("Hl",n),move(inqn));
+        }
 
-        //
-        // Construct the compressed MPO
-        //
+    //
+    // Construct the compressed MPO
+    //
+    PROFILE_SCOPE("AutoMPO assemble")
+    parallelFor(1,N+1,nthread,[&](int n)
+        {
         auto& fm = finalMPO.at(n-1);
 
         auto& IdM = fm[QNProd{ZeroQN,SiteTermProd(1,{"Id",n})}];
-        IQIndex& ll = links.at(n-1);
-        IQIndex& rl = links.at(n);
+        IQIndex const& ll = links.at(n-1);
+        IQIndex const& rl = links.at(n);
 
         Index li = findByQN(ll,ZeroQN);
         Index ri = findByQN(rl,ZeroQN);
@@ -1232,6 +1511,12 @@ compressMPO(SiteSet const& sites,
         IdM(0,0) = 1.;
         if(!isExpH) IdM(1,1) = 1.;
 
+        int rowOffset = isExpH ? 0 : 1;
+
+        //Terms crossing site n, collected by MPO matrix
+        //to be transformed together
+        auto crossing = map<QNProd,vector<IQMPOMatElem const*>>();
+
         for(IQMPOMatElem const& elem: tempMPO.at(n-1))
             {
             int j = elem.row;
@@ -1240,7 +1525,8 @@ compressMPO(SiteSet const& sites,
             
             if(isZero(t.coef,eps)) continue;
 
-            auto& M = fm[QNProd{elem.rowqn,t.ops}];
+            auto key = QNProd{elem.rowqn,t.ops};
+            auto& M = fm[key];
 
             if(nrows(M)==0)
                 {
@@ -1249,8 +1535,6 @@ compressMPO(SiteSet const& sites,
                 M = Mat<T>(li.m(),ri.m());
                 }
 
-            int rowOffset = isExpH ? 0 : 1;
-
             //rowShift & colShift account for special identity
             //entries in zero QN block of MPO
             auto rowShift = (elem.rowqn==ZeroQN) ? d0 : 0;
@@ -1264,41 +1548,83 @@ compressMPO(SiteSet const& sites,
                 }
             else if(j==-1)  	// terms starting on site n
                 {
-                auto& V = V_npp[elem.colqn];
-                for(size_t i = 0; i < ncols(V); ++i)
+                auto& Vc = getV(n,elem.colqn);
+                for(size_t i = 0; i < ncols(Vc); ++i)
                     {
-                    auto z = coef*V(k,i);
+                    auto z = coef*Vc(k,i);
                     M(rowOffset,i+colShift) += z;
                     }
                 }
             else if(k==-1) 	// terms ending on site n
                 {
-                auto& V = V_n[elem.rowqn];
-                for(size_t r = 0; r < ncols(V); ++r)
+                auto& Vr = getV(n-1,elem.rowqn);
+                for(size_t r = 0; r < ncols(Vr); ++r)
                     {
-                    auto z = coef*conj(V(j,r));
+                    auto z = coef*conj(Vr(j,r));
                     M(r+rowShift,0) += z;
                     }
                 }
             else 
                 {
-                auto& Vr = V_n[elem.rowqn];
-                auto& Vc = V_npp[elem.colqn];
-                for(size_t r = 0; r < ncols(Vr); ++r)
-                for(size_t c = 0; c < ncols(Vc); ++c) 
-                    {
-                    auto z = coef*conj(Vr(j,r))*Vc(k,c);
-                    M(r+rowShift,c+colShift) += z;
-                    }
+                crossing[key].push_back(&elem);
                 }
             }
 
-        // Store SVD computed at this step for next link
-        V_n = move(V_npp);
-        
-        max_d = max(max_d, links.at(n).m());
+        // M += Vr^dagger * C * Vc where C holds the
+        // coefficients of the crossing terms
+        for(auto& kc : crossing)
+            {
+            auto& first = *kc.second.front();
+            auto& Vr = getV(n-1,first.rowqn);
+            auto& Vc = getV(n,first.colqn);
+            auto rowShift = (first.rowqn==ZeroQN) ? d0 : 0;
+            auto colShift = (first.colqn==ZeroQN) ? d0 : 0;
+
+            auto CVc = Mat<T>(nrows(Vr),ncols(Vc));
+            for(auto pe : kc.second)
+                {
+                auto coef = forceType<T>(pe->val.coef);
+                for(size_t c = 0; c < ncols(Vc); ++c) CVc(pe->row,c) += coef*Vc(pe->col,c);
+                }
+            auto VrD = Mat<T>(ncols(Vr),nrows(Vr));
+            for(size_t r = 0; r < ncols(Vr); ++r)
+            for(size_t j = 0; j < nrows(Vr); ++j)
+                {
+                VrD(r,j) = conj(Vr(j,r));
+                }
+            auto P = Mat<T>(ncols(Vr),ncols(Vc));
+            mult(VrD,CVc,P);
+
+            auto& M = fm[kc.first];
+            for(size_t r = 0; r < nrows(P); ++r)
+            for(size_t c = 0; c < ncols(P); ++c)
+                {
+                M(r+rowShift,c+colShift) += P(r,c);
+                }
+            }
+        });
+
+    if(verbose)
+        {
+        auto time = vector<Real>(N+1,0.);
+        auto nsector = vector<int>(N+1,0);
+        auto maxcomp = vector<int>(N+1,0);
+        auto maxelems = vector<size_t>(N+1,0);
+        for(auto& S : sectors)
+            {
+            time.at(S.n) += S.time;
+            nsector.at(S.n) += 1;
+            maxcomp.at(S.n) = max(maxcomp.at(S.n),S.ncomp);
+            maxelems.at(S.n) = max(maxelems.at(S.n),S.block->mat.size());
+            }
+        println("AutoMPO link bond dimensions:");
+        println("# link     m  sectors  max elems  max blocks  svd time (s)");
+        for(int n = 1; n < N; ++n)
+            {
+            printfln("%6d %5d %8d %10d %11d %13.4f",n,links.at(n).m(),nsector.at(n),
+                     maxelems.at(n),maxcomp.at(n),time.at(n));
+            }
         }
-    //println("Maximal dimension of the MPO is ", max_d);
     }
 
 QN
@@ -1311,6 +1637,7 @@ constructMPOTensors(SiteSet const& sites,
                     vector<IQIndex> const& links, 
                     Args const& args = Args::global())
     {
+    PROFILE_SCOPE("AutoMPO tensors")
     MPOt<Tensor> H(sites);
     int N = sites.N();
 
@@ -1391,25 +1718,26 @@ svdMPO(AutoMPO const& am,
     MPOt<Tensor> H;
 
     auto checkqns = args.getBool("CheckQN",true);
+    auto nthread = args.getInt("NThread",1);
 
     if(is_real)
         {
         auto qbs = vector<QNBlock<Real>>();
         auto tempMPO = vector<IQMatEls>();
-        partitionHTerms(am.sites(),am.terms(),qbs,tempMPO,checkqns);
+        partitionHTerms(am.sites(),am.terms(),qbs,tempMPO,checkqns,nthread);
         auto finalMPO = vector<MPOPiece<Real>>();
         auto links = vector<IQIndex>();
-        compressMPO(am.sites(),qbs,tempMPO,finalMPO,links,isExpH,tau,args);
+        compressMPO(am.sites(),qbs,tempMPO,finalMPO,links,isExpH,tau,args,nthread);
         H = constructMPOTensors<Tensor,Real>(am.sites(),finalMPO,links,args);
         }
     else
         {
         auto qbs = vector<QNBlock<Cplx>>();
         auto tempMPO = vector<IQMatEls>();
-        partitionHTerms(am.sites(),am.terms(),qbs,tempMPO,checkqns);
+        partitionHTerms(am.sites(),am.terms(),qbs,tempMPO,checkqns,nthread);
         auto finalMPO = vector<MPOPiece<Cplx>>();
         auto links = vector<IQIndex>();
-        compressMPO(am.sites(),qbs,tempMPO,finalMPO,links,isExpH,tau,args);
+        compressMPO(am.sites(),qbs,tempMPO,finalMPO,links,isExpH,tau,args,nthread);
         H = constructMPOTensors<Tensor,Cplx>(am.sites(),finalMPO,links,args);
         }
 
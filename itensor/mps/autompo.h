@@ -17,6 +17,16 @@ class AutoMPO;
 // Given an AutoMPO representing a Hamiltonian H,
 // returns an exact IQMPO form of H.
 //
+// Arguments recognized:
+// o "Exact": if true, only allows terms with at most
+//   two operators and does no compression
+// o "Cutoff", "Maxm", "Minm": truncation of the SVD
+//   compression of each QN sector of each link
+// o "NThread": number of threads used to partition the
+//   terms and compress the QN sectors (default: 1)
+// o "Verbose": print the bond dimension, number of QN
+//   sectors and SVD time of each link
+//
 template <typename Tensor>
 MPOt<Tensor>
 toMPO(AutoMPO const& a,
@@ -216,6 +226,12 @@ class AutoMPO
     void
     add(HTerm const& t);
 
+    //Adds many terms at once, combining
+    //duplicates; faster than adding each
+    //term separately for large term sets
+    void
+    add(std::vector<HTerm> const& terms);
+
     void
     reset() { terms_.clear(); }
     };
@@ -169,9 +169,225 @@ dmrg(MPSt<Tensor>& psi,
 
 
 
+//
+// DMRG for the psis.size() lowest eigenstates of H
+// at once, represented by MPS which share all site
+// tensors except the one at site 1 (a "state-averaged"
+// or multi-target MPS basis).
+//
+// Only the environments of H are needed, which are
+// updated once per bond for all the states together.
+// At each bond the states are found one after another
+// by Davidson using H + w*(|0><0| + ... + |n-1><n-1|),
+// where |m> are the states already found at that bond:
+// since these are two-site tensors in the same basis,
+// each projector is a cheap rank-one update in the
+// matrix-vector product. The basis kept at each bond
+// diagonalizes the average of the reduced density 
+// matrices of the states.
+//
+// The basis must be large enough to hold all the 
+// states, so maxm should grow with their number. For
+// IQTensors all the states have the quantum numbers 
+// of the initial MPS.
+//
+// psis.front() is the initial MPS; the other elements
+// of psis are overwritten. Returns the energies of the 
+// states, lowest first.
+//
+//Named Args recognized:
+// Weight - real number w > 0, which should exceed the 
+//          gaps between the states (default 1)
+//
+template <class Tensor>
+std::vector<Real>
+dmrgStates(std::vector<MPSt<Tensor>>& psis,
+           MPOt<Tensor> const& H,
+           Sweeps const& sweeps,
+           Args args = Global::args());
+
+namespace detail {
+
+//H + weight*sum_m |phis[m]><phis[m]| for m < n
+template<class Tensor, class LocalOpT>
+class LocalOpProjected
+    {
+    LocalOpT const& H_;
+    std::vector<Tensor> const& phis_;
+    size_t n_;
+    Real weight_;
+    public:
+
+    LocalOpProjected(LocalOpT const& H,
+                     std::vector<Tensor> const& phis,
+                     size_t n,
+                     Real weight)
+      : H_(H), phis_(phis), n_(n), weight_(weight)
+        { }
+
+    void
+    product(Tensor const& phi, 
+            Tensor & phip) const
+        {
+        H_.product(phi,phip);
+        for(auto m : range(n_))
+            {
+            auto z = weight_*(dag(phis_[m])*phi).cplx();
+            phip += z*phis_[m];
+            }
+        }
+
+    long
+    size() const { return H_.size(); }
+
+    Tensor
+    diag() const { return H_.diag(); }
+    };
+
+} //namespace detail
+
+
+//
+// Two-site estimate of the energy variance <H^2>-<H>^2
+// of an MPS (Hubig, McCulloch and Schollwoeck, 
+// Phys. Rev. B 97, 045125 (2018)).
+//
+// H|psi> is projected onto the states which differ from 
+// psi on one site or on two neighboring sites, using the
+// two-site effective Hamiltonian products of a sweep,
+// so no H^2 MPO or three-layer contraction is needed.
+// The estimate is a lower bound which becomes accurate 
+// as DMRG converges.
+//
+// PH must be at position 1 for psi, with psi's
+// orthogonality center at site 1: the environments
+// to the right are reused and those to the left are
+// built from a left-orthogonalized copy of psi. 
+// PH is copied, so it is left unchanged.
+//
+template<class Tensor, class LocalOpT>
+Real
+twoSiteVariance(MPSt<Tensor> const& psi,
+                LocalOpT PH)
+    {
+    auto N = psi.N();
+    if(N < 2) return 0;
+    if(PH.doWrite()) Error("twoSiteVariance not supported if doWrite(true)");
+
+    auto phi = psi;
+    phi.Aref(1) /= norm(phi.A(1));
+
+    Real var = 0;
+    for(int b = 1; b < N; ++b)
+        {
+        PH.position(b,phi);
+        auto C = phi.A(b)*phi.A(b+1);
+        Tensor HC;
+        PH.product(C,HC);
+
+        //Left-orthonormal basis of site b and the
+        //center matrix of bond b
+        Tensor U,D,V(rightLinkInd(phi,b));
+        svd(phi.A(b),U,D,V,{"Cutoff",1E-28});
+
+        //Projection of H|psi> onto states which differ
+        //from psi on site b, and possibly also on site b+1
+        //(the one- and two-site parts of the variance)
+        auto QL = HC - U*(dag(U)*HC);
+        var += sqr(norm(QL));
+
+        if(b == N-1)
+            {
+            //Site N
+            auto E = (dag(C)*HC).real();
+            var += sqr(norm(dag(U)*HC)) - sqr(E);
+            }
+
+        phi.Aref(b) = U;
+        phi.Aref(b+1) *= D*V;
+        }
+    return var;
+    }
+
+//
+// Two-site energy variance of psi for the Hamiltonian H 
+// (see above), building the environments from scratch
+//
+template<class Tensor>
+Real
+twoSiteVariance(MPSt<Tensor> const& psi,
+                MPOt<Tensor> const& H,
+                Args const& args = Args::global())
+    {
+    auto phi = psi;
+    phi.position(1);
+    auto PH = LocalMPO<Tensor>(H,args);
+    PH.position(1,phi);
+    return twoSiteVariance(phi,PH);
+    }
+
+
+namespace detail {
+
+//Wraps a local operator, counting calls to product
+template<class LocalOpT>
+class ProductCounter
+    {
+    LocalOpT const& op_;
+    mutable long n_ = 0;
+    public:
+
+    explicit
+    ProductCounter(LocalOpT const& op) : op_(op) { }
+
+    template<class Tensor>
+    void
+    product(Tensor const& phi, 
+            Tensor & phip) const
+        { 
+        ++n_;
+        op_.product(phi,phip); 
+        }
+
+    long
+    size() const { return op_.size(); }
+
+    auto
+    diag() const -> decltype(op_.diag()) { return op_.diag(); }
+
+    long
+    count() const { return n_; }
+    };
+
+} //namespace detail
+
 //
 // DMRGWorker
 //
+// With the arg "Variance" set to true, the two-site
+// energy variance is computed at the end of each sweep
+// and passed to the observer as "EnergyVariance".
+//
+// The number of Davidson matrix-vector products done
+// so far in each sweep is passed to the observer as 
+// "DavidsonMatvecs", and the numbers of tensor storage
+// buffers allocated and reused from the storage pool
+// (see itdata/storagepool.h) as "StorageNAlloc",
+// "StorageAllocMB", "StorageNReuse" and "StorageReuseMB"
+// (counted for the thread running the sweep). The default
+// DMRGObserver prints these with the arg "PrintSweepStats".
+//
+// With the arg "AdaptiveDavidson" set to true, the
+// Davidson error goal at each bond is loosened to
+// AdaptiveFactor*sqrt(truncerr) (default factor 1),
+// where truncerr is the truncation error of the last 
+// bond. The energy error left by such a residual is of
+// the order of the truncation error, and the predicted
+// wavefunction of a converged sweep already has about
+// this residual, so few products are done at each bond.
+// MaxIter can be made larger in this mode, since it is
+// only reached at bonds which are far from converged.
+//
 
 template <class Tensor, class LocalOpT>
 Real inline
@@ -193,12 +409,18 @@ DMRGWorker(MPSt<Tensor>& psi,
            DMRGObserver<Tensor>& obs,
            Args args = Global::args())
     {
+    PROFILE_SCOPE("dmrg")
     const bool quiet = args.getBool("Quiet",false);
     const int debug_level = args.getInt("DebugLevel",(quiet ? 0 : 1));
 
     const int N = psi.N();
     Real energy = NAN;
 
+    const bool adaptive = args.getBool("AdaptiveDavidson",false);
+    const Real adapt_factor = args.getReal("AdaptiveFactor",1.);
+    const Real errgoal = args.getReal("ErrGoal",1E-14);
+    Real last_truncerr = 0;
+
     psi.position(1);
 
     args.add("DebugLevel",debug_level);
@@ -206,6 +428,7 @@ DMRGWorker(MPSt<Tensor>& psi,
     
     for(int sw = 1; sw <= sweeps.nsweep(); ++sw)
         {
+        PROFILE_SCOPE("sweep")
         cpu_time sw_time;
         args.add("Sweep",sw);
         args.add("NSweep",sweeps.nsweep());
@@ -229,6 +452,9 @@ DMRGWorker(MPSt<Tensor>& psi,
             PH.doWrite(true,args);
             }
 
+        long nmatvec = 0;
+        auto storage_start = storageStats();
+
         for(int b = 1, ha = 1; ha <= 2; sweepnext(b,ha,N))
             {
             if(!quiet)
@@ -238,11 +464,22 @@ DMRGWorker(MPSt<Tensor>& psi,
 
             PH.position(b,psi);
 
+            //The last svdBond left the singular values on the
+            //site moved to, so this is the transformed wavefunction
+            //of the previous step (White's prediction)
             auto phi = psi.A(b)*psi.A(b+1);
 
-            energy = davidson(PH,phi,args);
+            if(adaptive)
+                {
+                args.add("ErrGoal",std::max(errgoal,adapt_factor*std::sqrt(last_truncerr)));
+                }
+
+            auto CPH = detail::ProductCounter<LocalOpT>(PH);
+            energy = davidson(CPH,phi,args);
+            nmatvec += CPH.count();
             
             auto spec = psi.svdBond(b,phi,(ha==1?Fromleft:Fromright),PH,args);
+            last_truncerr = spec.truncerr();
 
 
             if(!quiet)
@@ -258,10 +495,24 @@ DMRGWorker(MPSt<Tensor>& psi,
 
             obs.lastSpectrum(spec);
 
+            if(b == 1 && ha == 2 && args.getBool("Variance",false))
+                {
+                //psi and PH are now at position 1 with
+                //the environments of the whole sweep
+                if(PH.doWrite()) args.add("EnergyVariance",NAN);
+                else             args.add("EnergyVariance",twoSiteVariance(psi,PH));
+                }
+
             args.add("AtBond",b);
             args.add("HalfSweep",ha);
             args.add("Energy",energy); 
             args.add("Truncerr",spec.truncerr()); 
+            args.add("DavidsonMatvecs",nmatvec);
+            auto storage = storageStats()-storage_start;
+            args.add("StorageNAlloc",storage.nalloc);
+            args.add("StorageAllocMB",storage.alloc_bytes/1E6);
+            args.add("StorageNReuse",storage.nreuse);
+            args.add("StorageReuseMB",storage.reuse_bytes/1E6);
 
             obs.measure(args);
 
@@ -280,6 +531,165 @@ DMRGWorker(MPSt<Tensor>& psi,
     return energy;
     }
 
+template <class Tensor>
+std::vector<Real>
+dmrgStates(std::vector<MPSt<Tensor>>& psis,
+           MPOt<Tensor> const& H,
+           Sweeps const& sweeps,
+           Args args)
+    {
+    PROFILE_SCOPE("dmrg")
+    using IndexT = typename Tensor::index_type;
+    auto nstate = psis.size();
+    if(nstate == 0) Error("dmrgStates: psis must contain an initial MPS");
+    const bool quiet = args.getBool("Quiet",false);
+    const int debug_level = args.getInt("DebugLevel",(quiet ? 0 : 1));
+    const Real weight = args.getReal("Weight",1.);
+    const int plev = 14741;
+
+    auto& psi = psis.front();
+    const int N = psi.N();
+    auto energies = std::vector<Real>(nstate,NAN);
+
+    psi.position(1);
+    LocalMPO<Tensor> PH(H,args);
+    DMRGObserver<Tensor> obs(psi,args);
+
+    args.add("DebugLevel",debug_level);
+
+    //Center tensors of the states: site tensors of
+    //site cpos, which the site tensors of psi at the 
+    //other sites complete to an MPS
+    auto centers = std::vector<Tensor>(nstate);
+    int cpos = 1;
+    bool first = true;
+
+    for(int sw = 1; sw <= sweeps.nsweep(); ++sw)
+        {
+        PROFILE_SCOPE("sweep")
+        cpu_time sw_time;
+        args.add("Sweep",sw);
+        args.add("NSweep",sweeps.nsweep());
+        args.add("Cutoff",sweeps.cutoff(sw));
+        args.add("Minm",sweeps.minm(sw));
+        args.add("Maxm",sweeps.maxm(sw));
+        args.add("MaxIter",sweeps.niter(sw));
+
+        for(int b = 1, ha = 1; ha <= 2; sweepnext(b,ha,N))
+            {
+            if(!quiet)
+                {
+                printfln("Sweep=%d, HS=%d, Bond=%d/%d",sw,ha,b,(N-1));
+                }
+
+            PH.position(b,psi);
+
+            auto phis = std::vector<Tensor>(nstate);
+            if(first)
+                {
+                //Random initial guesses for the excited states
+                phis.front() = psi.A(b)*psi.A(b+1);
+                for(size_t n = 1; n < nstate; ++n)
+                    {
+                    phis[n] = phis.front();
+                    randomize(phis[n]);
+                    }
+                first = false;
+                }
+            else
+                {
+                for(auto n : range(nstate))
+                    {
+                    phis[n] = (cpos == b) ? centers[n]*psi.A(b+1) 
+                                          : psi.A(b)*centers[n];
+                    }
+                }
+
+            for(auto n : range(nstate))
+                {
+                auto PHn = detail::LocalOpProjected<Tensor,LocalMPO<Tensor>>(PH,phis,n,weight);
+                energies[n] = davidson(PHn,phis[n],args);
+                }
+
+            //Indices of the site and link being traced
+            //over, whose site tensors are still those of
+            //the last half-sweep
+            auto j = (ha == 1) ? b : b+1;
+            auto jo = (ha == 1) ? b+1 : b;
+            auto so = findtype(psi.A(jo),Site);
+            auto lo = (ha == 1) ? ((b+1 < N) ? rightLinkInd(psi,b+1) : IndexT())
+                                : ((b > 1) ? leftLinkInd(psi,b) : IndexT());
+
+            //Average reduced density matrix of site j
+            //and the link on its other side
+            Tensor rho;
+            for(auto& phi : phis)
+                {
+                auto phid = lo ? primeExcept(dag(phi),so,lo,plev) 
+                               : primeExcept(dag(phi),so,plev);
+                if(rho) rho += phi*phid;
+                else    rho = phi*phid;
+                }
+            rho /= nstate;
+
+            Tensor U,D;
+            auto spec = diagHermitian(rho,U,D,{args,"IndexType=",Link});
+
+            psi.Aref(j) = dag(U);
+            for(auto n : range(nstate)) centers[n] = U*phis[n];
+            cpos = jo;
+
+            if(!quiet)
+                { 
+                printfln("    Truncated to Cutoff=%.1E, Min_m=%d, Max_m=%d",
+                          sweeps.cutoff(sw),
+                          sweeps.minm(sw), 
+                          sweeps.maxm(sw) );
+                printfln("    Trunc. err=%.1E, States kept: %s",
+                         spec.truncerr(),
+                         showm(commonIndex(U,centers.front(),Link)) );
+                }
+
+            obs.lastSpectrum(spec);
+
+            args.add("AtBond",b);
+            args.add("HalfSweep",ha);
+            args.add("Energy",energies.front()); 
+            args.add("Truncerr",spec.truncerr()); 
+
+            obs.measure(args);
+
+            } //for loop over b
+
+        if(!quiet)
+            {
+            printf("    Energies after sweep %d/%d:",sw,sweeps.nsweep());
+            for(auto E : energies) printf(" %.12f",E);
+            println();
+            }
+
+        auto sm = sw_time.sincemark();
+        printfln("    Sweep %d/%d CPU time = %s (Wall time = %s)",
+                  sw,sweeps.nsweep(),showtime(sm.time),showtime(sm.wall));
+
+        if(obs.checkDone(args)) break;
+    
+        } //for loop over sw
+
+    if(first) return energies;
+
+    //The center tensors are now those of site 1
+    for(auto n : range(nstate))
+        {
+        if(n > 0) psis[n] = psi;
+        psis[n].Aref(1) = centers[n]/norm(centers[n]);
+        psis[n].leftLim(0);
+        psis[n].rightLim(2);
+        }
+
+    return energies;
+    }
+
 } //namespace itensor
 
 
@@ -4,6 +4,7 @@
 //
 #ifndef __ITENSOR_HAMBUILDER_H
 #define __ITENSOR_HAMBUILDER_H
+#include <atomic>
 #include "mpo.h"
 
 #define String std::string
@@ -82,9 +83,8 @@ class HamBuilder
     static int
     hamNumber()
         {
-        static int num_ = 0;
-        ++num_;
-        return num_;
+        static std::atomic<int> num_(0);
+        return ++num_;
         }
 
     };
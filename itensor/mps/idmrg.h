@@ -17,6 +17,11 @@ struct idmrgRVal
     Tensor HR;
     Tensor IL;
     Tensor V;
+    //Statistics of the run (not read or written):
+    //number of iDMRG steps done and of Davidson
+    //matrix-vector products used by them
+    int nstep = 0;
+    long nmatvec = 0;
     };
 
 template<typename Tensor>
@@ -27,6 +32,34 @@ template<typename Tensor>
 void
 write(std::ostream & s, idmrgRVal<Tensor> const& rval);
 
+//
+// Infinite DMRG (McCulloch, arXiv:0804.2509) with two
+// unit cells of psi.N()/2 sites in the center. Each step
+// inserts two new unit cells, starting from a prediction
+// of their wavefunction made from the last step, and 
+// sweeps over them. The environments computed by the 
+// sweep are reused for the edge tensors of the next step.
+//
+// The number of Davidson matrix-vector products of each 
+// step is printed along with the changes of the energy 
+// per site and of the center bond spectrum.
+//
+//Named Args recognized:
+// NUCSweeps - number of sweeps over the center per step
+//             (default 1)
+// EnergyPerSiteErrgoal - stop once the energy per site 
+//             changes by less than this in a step 
+// FidelityErrgoal - stop once 1-F < FidelityErrgoal, where 
+//             F = sum_i sqrt(p_i q_i) is the fidelity of the 
+//             center bond density matrix eigenvalues p and q 
+//             of two successive steps
+// (stopping is only done after an even number of steps,
+// when the unit cells of psi are back in their original
+// order; both errgoals default to 0, meaning unused)
+// OutputLevel - 0 (default) prints a summary of each step,
+//             1 also initial energies and overlaps, 2 also
+//             the output of each sweep
+//
 template <class Tensor>
 idmrgRVal<Tensor>
 idmrg(MPSt<Tensor>      & psi, 
@@ -97,6 +130,83 @@ struct PseudoInvert
         }
     };
 
+//Fidelity sum_i sqrt(p_i q_i) of the normalized
+//eigenvalues p and q of two density matrices 
+//(each sorted in decreasing order)
+Real inline
+spectrumFidelity(Spectrum const& p, 
+                 Spectrum const& q)
+    {
+    auto& pe = p.eigsKept();
+    auto& qe = q.eigsKept();
+    auto n = std::min(pe.size(),qe.size());
+    Real F = 0;
+    for(decltype(n) i = 0; i < n; ++i) F += std::sqrt(pe(i)*qe(i));
+    auto nrm = std::sqrt(sumels(pe)*sumels(qe));
+    return nrm > 0 ? F/nrm : 0.;
+    }
+
+//
+// Edge tensors for the next iDMRG step: sets HL and IL
+// to include the unit cell at sites 1..Nuc of psi, and
+// HR to include sites Nuc+1..2*Nuc. Sites 1..Nuc must
+// be left-orthogonal and Nuc+1..2*Nuc right-orthogonal.
+//
+// PH keeps the environments of the sweep just done,
+// which are still valid for sites Nuc+2..2*Nuc, so only
+// those of sites 1..Nuc+1 are contracted again.
+//
+template <class Tensor>
+void
+idmrgEdges(LocalMPO<Tensor> & PH,
+           MPSt<Tensor> const& psi, 
+           MPOt<Tensor> const& H,
+           Tensor & HL,
+           Tensor & HR,
+           Tensor & IL)
+    {
+    auto Nuc = psi.N()/2;
+    PH.position(Nuc,psi);
+
+    HL = PH.L();
+    HL *= psi.A(Nuc);
+    HL *= H.A(Nuc);
+    HL *= dag(prime(psi.A(Nuc)));
+
+    HR = PH.R();
+    HR *= psi.A(Nuc+1);
+    HR *= H.A(Nuc+1);
+    HR *= dag(prime(psi.A(Nuc+1)));
+
+    for(int j = 1; j <= Nuc; ++j)
+        {
+        IL *= psi.A(j);
+        IL *= H.A(j);
+        IL *= dag(prime(psi.A(j)));
+        }
+    }
+
+//
+// Brings psi to right-orthogonal form with its center
+// at site 1 (without truncating), by a sweep of SVDs of 
+// single site tensors. Much cheaper than orthogonalize()
+// when only the gauge has to be fixed.
+//
+template <class Tensor>
+void
+rightOrthogonalize(MPSt<Tensor> & psi)
+    {
+    for(int j = psi.N(); j > 1; --j)
+        {
+        Tensor U(commonIndex(psi.A(j-1),psi.A(j),Link)),S,V;
+        svd(psi.A(j),U,S,V,{"Cutoff",1E-28});
+        psi.Aref(j) = V;
+        psi.Aref(j-1) *= U*S;
+        }
+    psi.leftLim(0);
+    psi.rightLim(2);
+    }
+
 } //namespace detail
 
 
@@ -117,6 +227,8 @@ idmrg(MPSt<Tensor> & psi,
     auto show_overlap = args.getBool("ShowOverlap",false);
     //inverse_cut is cutoff for computing pseudo inverse 
     auto inverse_cut = args.getReal("InverseCut",1E-8);
+    auto energy_errgoal = args.getReal("EnergyPerSiteErrgoal",0.);
+    auto fidelity_errgoal = args.getReal("FidelityErrgoal",0.);
     auto actual_nucsweeps = nucsweeps;
 
     int N0 = psi.N(); //Number of sites in center
@@ -126,6 +238,7 @@ idmrg(MPSt<Tensor> & psi,
     if(N0 == 2) args.add("CombineMPO",false);
 
     Real energy = NAN;
+    long nmatvec = 0;
 
     auto lastV = last_rval.V;
     Tensor D;
@@ -148,6 +261,7 @@ idmrg(MPSt<Tensor> & psi,
     if(not HR) HR = H.A(N0+1);
 
     int sw = 1;
+    Spectrum spec;
 
     //Start with two unit cells
         { 
@@ -164,10 +278,13 @@ idmrg(MPSt<Tensor> & psi,
         ucsweeps.niter() = sweeps.niter(sw);
         print(ucsweeps);
 
+        auto PH = LocalMPO<Tensor>(H,HL,HR,args);
+
         auto extra_args = Args("Quiet",olevel < 2,
                                "iDMRG_Step",sw,
                                "NSweep",ucsweeps.nsweep());
-        energy = dmrg(psi,H,HL,HR,ucsweeps,obs,args + extra_args);
+        energy = DMRGWorker(psi,PH,ucsweeps,obs,args + extra_args);
+        nmatvec += PH.numProducts();
 
         if(do_randomize)
             {
@@ -177,6 +294,8 @@ idmrg(MPSt<Tensor> & psi,
                 randomize(psi.Aref(j));
                 }
             psi.normalize();
+            //Environments of the sweep no longer apply
+            PH = LocalMPO<Tensor>(H,HL,HR,args);
             }
 
         printfln("\n    Energy per site = %.14f\n",energy/N0);
@@ -188,24 +307,11 @@ idmrg(MPSt<Tensor> & psi,
         args.add("Energy",energy);
         obs.measure(args+Args("AtCenter",true,"NoMeasure",true));
 
-        svd(psi.A(Nuc)*psi.A(Nuc+1),psi.Aref(Nuc),D,psi.Aref(Nuc+1));
+        spec = svd(psi.A(Nuc)*psi.A(Nuc+1),psi.Aref(Nuc),D,psi.Aref(Nuc+1));
         D /= norm(D);
         
         //Prepare MPO for next step
-        for(int j = 1; j <= Nuc; ++j)
-            {
-            HL *= psi.A(j);
-            HL *= H.A(j);
-            HL *= dag(prime(psi.A(j)));
-            IL *= psi.A(j);
-            IL *= H.A(j);
-            IL *= dag(prime(psi.A(j)));
-
-            HR *= psi.A(N0-j+1);
-            HR *= H.A(N0-j+1);
-            HR *= dag(prime(psi.A(N0-j+1)));
-            }
-        //H = HG(sw);
+        detail::idmrgEdges(PH,psi,H,HL,HR,IL);
         swapUnitCells(H);
 
         HL += -energy*IL;
@@ -220,7 +326,7 @@ idmrg(MPSt<Tensor> & psi,
         ++sw;
         }
 
-    Spectrum spec;
+    Real last_energy = NAN;
 
     for(; sw <= sweeps.nsweep(); ++sw)
         {
@@ -252,6 +358,7 @@ idmrg(MPSt<Tensor> & psi,
         
         auto extra_args = Args("Quiet",olevel<2,"NoMeasure",sw%2==0,"iDMRG_Step",sw,"NSweep",ucsweeps.nsweep());
         energy = DMRGWorker(psi,PH,ucsweeps,obs,args + extra_args);
+        nmatvec += PH.numProducts();
 
         if(show_overlap || olevel >= 1)
             {
@@ -280,23 +387,22 @@ idmrg(MPSt<Tensor> & psi,
         obs.measure(args+Args("AtCenter",true,"NoMeasure",true));
 
         D = Tensor();
-        svd(psi.A(Nuc)*psi.A(Nuc+1),psi.Aref(Nuc),D,psi.Aref(Nuc+1),args);
+        auto last_spec = spec;
+        spec = svd(psi.A(Nuc)*psi.A(Nuc+1),psi.Aref(Nuc),D,psi.Aref(Nuc+1),args);
         D /= norm(D);
 
+        //Convergence of the energy per site, and of the
+        //center density matrix from one step to the next
+        auto dE = std::fabs(energy-last_energy)/N0;
+        auto fid_err = last_spec.size() > 0 ? 1-detail::spectrumFidelity(spec,last_spec) : NAN;
+        last_energy = energy;
+        printfln("    dE per site = %.3E, 1-Fidelity = %.3E, Davidson matvecs = %d (%.1f per bond)",
+                 dE,fid_err,PH.numProducts(),PH.numProducts()/(2.*(N0-1)*ucsweeps.nsweep()));
+        auto converged = (energy_errgoal > 0 && dE < energy_errgoal)
+                      || (fidelity_errgoal > 0 && fid_err < fidelity_errgoal);
+
         //Prepare MPO for next step
-        for(int j = 1; j <= Nuc; ++j)
-            {
-            HL *= psi.A(j);
-            HL *= H.A(j);
-            HL *= dag(prime(psi.A(j)));
-            IL *= psi.A(j);
-            IL *= H.A(j);
-            IL *= dag(prime(psi.A(j)));
-
-            HR *= psi.A(N0-j+1);
-            HR *= H.A(N0-j+1);
-            HR *= dag(prime(psi.A(N0-j+1)));
-            }
+        detail::idmrgEdges(PH,psi,H,HL,HR,IL);
         swapUnitCells(H);
 
         HL += -energy*IL;
@@ -306,9 +412,13 @@ idmrg(MPSt<Tensor> & psi,
 
         psi.Aref(N0) *= D;
 
-        if((obs.checkDone(args) && sw%2==0)
+        if(((obs.checkDone(args) || converged) && sw%2==0)
            || sw == sweeps.nsweep()) 
             {
+            if(converged && sw < sweeps.nsweep())
+                {
+                printfln("    iDMRG converged after %d steps (%d Davidson matvecs)",sw,nmatvec);
+                }
             //Convert A's (left-ortho) to B's by moving D (center matrix)
             //through until last V*A_j*D == B_j
             for(int b = N0-1; b >= Nuc+1; --b)
@@ -344,7 +454,7 @@ idmrg(MPSt<Tensor> & psi,
         psi.Aref(Nuc+1) *= lastV;
         psi.Aref(1) *= D;
 
-        psi.orthogonalize();
+        detail::rightOrthogonalize(psi);
         psi.normalize();
 
         } //for loop over sw
@@ -355,6 +465,8 @@ idmrg(MPSt<Tensor> & psi,
     res.HR = HR;
     res.IL = IL;
     res.V = lastV;
+    res.nstep = std::min(sw,sweeps.nsweep());
+    res.nmatvec = nmatvec;
 
     return res;
     }
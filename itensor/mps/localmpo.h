@@ -31,6 +31,15 @@ namespace itensor {
 //  This results in an unprojected region of
 //  num_center sites starting at site j.
 //
+//  With the arg "SparseMPO" set to true, the MPO
+//  tensors are also stored as sparse matrices of
+//  site operators (see sparsempo.h) which are used
+//  for products and environment updates, skipping
+//  the zero and identity entries of each W.
+//  The QN blocks of an IQMPO already skip most
+//  zeros, so this mainly helps ITensor MPOs
+//  with large bond dimension.
+//
 
 template <class Tensor>
 class LocalMPO
@@ -123,6 +132,17 @@ class LocalMPO
     void
     shift(int j, Direction dir, const Tensor& A);
 
+    //
+    // For a LocalMPO made from an MPS Psi, the
+    // two-site tensor <Psi| projected by the edge
+    // tensors at the current position, so that
+    // product(phi) = dag(P)*(P*phi) with P = projector().
+    // Built on first use after each change of position
+    // and reused by every later product.
+    //
+    Tensor const&
+    projector() const;
+
     //
     // Accessor Methods
     //
@@ -130,6 +150,7 @@ class LocalMPO
     void
     reset()
         {
+        proj_ = Tensor();
         LHlim_ = 0;
         RHlim_ = Op_->N()+1;
         }
@@ -138,7 +159,7 @@ class LocalMPO
     L() const { return PH_[LHlim_]; }
     // Replace left edge tensor at current bond
     void
-    L(Tensor const& nL) { PH_[LHlim_] = nL; }
+    L(Tensor const& nL) { PH_[LHlim_] = nL; proj_ = Tensor(); }
     // Replace left edge tensor bordering site j
     // (so that nL includes sites < j)
     void
@@ -149,7 +170,7 @@ class LocalMPO
     R() const { return PH_[RHlim_]; }
     // Replace right edge tensor at current bond
     void
-    R(Tensor const& nR) { PH_[RHlim_] = nR; }
+    R(Tensor const& nR) { PH_[RHlim_] = nR; proj_ = Tensor(); }
     // Replace right edge tensor bordering site j
     // (so that nR includes sites > j)
     void
@@ -200,6 +221,10 @@ class LocalMPO
     int
     rightLim() const { return RHlim_; }
 
+    //Number of calls to product so far
+    long
+    numProducts() const { return nproduct_; }
+
     private:
 
     /////////////////
@@ -208,6 +233,7 @@ class LocalMPO
     //
 
     const MPOt<Tensor>* Op_;
+    SparseMPOt<Tensor> sparse_;
     std::vector<Tensor> PH_;
     int LHlim_,RHlim_;
     int nc_;
@@ -218,6 +244,8 @@ class LocalMPO
     std::string writedir_ = "./";
 
     const MPSt<Tensor>* Psi_;
+    mutable Tensor proj_; //cached projector(), null if not yet built
+    mutable long nproduct_ = 0;
 
     //
     /////////////////
@@ -233,6 +261,17 @@ class LocalMPO
     void
     setLHlim(int val);
 
+    //Point lop_ at the MPO tensors b and b+1
+    void
+    updateLop(int b);
+
+    void
+    initSparse(Args const& args);
+
+    //Environment update E*A*W(j)*dag(prime(A))
+    Tensor
+    envUpdate(Tensor const& E, Tensor const& A, int j, Direction dir) const;
+
     void
     setRHlim(int val);
 
@@ -270,6 +309,7 @@ LocalMPO(const MPOt<Tensor>& H,
     { 
     if(args.defined("NumCenter"))
         numCenter(args.getInt("NumCenter"));
+    initSparse(args);
     }
 
 template <class Tensor>
@@ -301,8 +341,8 @@ LocalMPO(const MPOt<Tensor>& H,
     { 
     PH_[0] = LH;
     PH_[H.N()+1] = RH;
-    if(H.N()==2)
-        lop_.update(Op_->A(1),Op_->A(2),L(),R());
+    initSparse(args);
+    if(H.N()==2) updateLop(1);
     if(args.defined("NumCenter"))
         numCenter(args.getInt("NumCenter"));
     }
@@ -343,7 +383,8 @@ LocalMPO(MPOt<Tensor> const& H,
     { 
     PH_.at(LHlim) = LH;
     PH_.at(RHlim) = RH;
-    if(H.N()==2) lop_.update(Op_->A(1),Op_->A(2),L(),R());
+    initSparse(args);
+    if(H.N()==2) updateLop(1);
     if(args.defined("NumCenter")) numCenter(args.getInt("NumCenter"));
     }
 
@@ -351,6 +392,7 @@ template <class Tensor> inline
 void LocalMPO<Tensor>::
 product(const Tensor& phi, Tensor& phip) const
     {
+    ++nproduct_;
     if(Op_ != 0)
         {
         lop_.product(phi,phip);
@@ -358,13 +400,10 @@ product(const Tensor& phi, Tensor& phip) const
     else 
     if(Psi_ != 0)
         {
-        int b = position();
-        auto othr = (!L() ? dag(prime(Psi_->A(b),Link)) : L()*dag(prime(Psi_->A(b),Link)));
-        auto othrR = (!R() ? dag(prime(Psi_->A(b+1),Link)) : R()*dag(prime(Psi_->A(b+1),Link)));
-        othr *= othrR;
-        auto z = (othr*phi).cplx();
+        auto& P = projector();
+        auto z = (P*phi).cplx();
 
-        phip = dag(othr);
+        phip = dag(P);
         phip *= z;
         }
     else
@@ -373,12 +412,29 @@ product(const Tensor& phi, Tensor& phip) const
         }
     }
 
+template <class Tensor>
+inline Tensor const& LocalMPO<Tensor>::
+projector() const
+    {
+    if(Psi_ == 0) Error("LocalMPO::projector: LocalMPO not made from an MPS");
+    if(!proj_)
+        {
+        int b = position();
+        auto othr = (!L() ? dag(prime(Psi_->A(b),Link)) : L()*dag(prime(Psi_->A(b),Link)));
+        auto othrR = (!R() ? dag(prime(Psi_->A(b+1),Link)) : R()*dag(prime(Psi_->A(b+1),Link)));
+        othr *= othrR;
+        proj_ = othr;
+        }
+    return proj_;
+    }
+
 template <class Tensor>
 void inline LocalMPO<Tensor>::
 L(int j, const Tensor& nL)
     {
     if(LHlim_ > j-1) setLHlim(j-1);
     PH_[LHlim_] = nL;
+    proj_ = Tensor();
     }
 
 template <class Tensor>
@@ -387,6 +443,7 @@ R(int j, const Tensor& nR)
     {
     if(RHlim_ < j+1) setRHlim(j+1);
     PH_[RHlim_] = nR;
+    proj_ = Tensor();
     }
 
 template <class Tensor>
@@ -411,7 +468,7 @@ position(int b, const MPSType& psi)
 
     if(Op_ != 0) //normal MPO case
         {
-        lop_.update(Op_->A(b),Op_->A(b+1),L(),R());
+        updateLop(b);
         }
     }
 
@@ -447,14 +504,11 @@ shift(int j, Direction dir, const Tensor& A)
             Error("Can only shift at LHlim");
             }
         Tensor& E = PH_.at(LHlim_);
-        Tensor& nE = PH_.at(j);
-        nE = E * A;
-        nE *= Op_->A(j);
-        nE *= dag(prime(A));
+        PH_.at(j) = envUpdate(E,A,j,Fromleft);
         setLHlim(j);
         setRHlim(j+nc_+1);
 
-        lop_.update(Op_->A(j+1),Op_->A(j+2),L(),R());
+        updateLop(j+1);
         }
     else //dir == Fromright
         {
@@ -464,14 +518,11 @@ shift(int j, Direction dir, const Tensor& A)
             Error("Can only shift at RHlim_");
             }
         Tensor& E = PH_.at(RHlim_);
-        Tensor& nE = PH_.at(j);
-        nE = E * A;
-        nE *= Op_->A(j);
-        nE *= dag(prime(A));
+        PH_.at(j) = envUpdate(E,A,j,Fromright);
         setLHlim(j-nc_-1);
         setRHlim(j);
 
-        lop_.update(Op_->A(j-1),Op_->A(j),L(),R());
+        updateLop(j-1);
         }
     }
 
@@ -480,6 +531,8 @@ template <class MPSType>
 inline void LocalMPO<Tensor>::
 makeL(const MPSType& psi, int k)
     {
+    if(LHlim_ >= k) return;
+    PROFILE_SCOPE("environment update")
     if(!PH_.empty())
         {
         if(Op_ == 0) //Op is actually an MPS
@@ -497,16 +550,7 @@ makeL(const MPSType& psi, int k)
             while(LHlim_ < k)
                 {
                 auto ll = LHlim_;
-                if(PH_.at(ll))
-                    {
-                    PH_.at(ll+1) = PH_.at(ll)*psi.A(ll+1);
-                    }
-                else
-                    {
-                    PH_.at(ll+1) = psi.A(ll+1);
-                    }
-                PH_.at(ll+1) *= Op_->A(ll+1);
-                PH_.at(ll+1) *= dag(prime(psi.A(ll+1)));
+                PH_.at(ll+1) = envUpdate(PH_.at(ll),psi.A(ll+1),ll+1,Fromleft);
                 setLHlim(ll+1);
                 }
             }
@@ -518,6 +562,8 @@ template <class MPSType>
 inline void LocalMPO<Tensor>::
 makeR(const MPSType& psi, int k)
     {
+    if(RHlim_ <= k) return;
+    PROFILE_SCOPE("environment update")
     if(!PH_.empty())
         {
         if(Op_ == 0) //Op is actually an MPS
@@ -535,32 +581,60 @@ makeR(const MPSType& psi, int k)
             while(RHlim_ > k)
                 {
                 auto rl = RHlim_;
-                //printfln(" Making environment with rl=%d (using H[%d])",rl,rl-1);
-                //Print(PH_.at(rl));
-                //Print(Op_->A(rl-1));
-                //Print(psi.A(rl-1));
-                if(PH_.at(rl))
-                    {
-                    PH_.at(rl-1) = PH_.at(rl)*psi.A(rl-1);
-                    }
-                else
-                    {
-                    PH_.at(rl-1) = psi.A(rl-1);
-                    }
-                PH_.at(rl-1) *= Op_->A(rl-1);
-                PH_.at(rl-1) *= dag(prime(psi.A(rl-1)));
-                //printfln("PH[%d] = \n%s",rl-1,PH_.at(rl-1));
-                //PAUSE
+                PH_.at(rl-1) = envUpdate(PH_.at(rl),psi.A(rl-1),rl-1,Fromright);
                 setRHlim(rl-1);
                 }
             }
         }
     }
 
+template <class Tensor>
+void inline LocalMPO<Tensor>::
+updateLop(int b)
+    {
+    lop_.update(Op_->A(b),Op_->A(b+1),L(),R());
+    if(sparse_) lop_.sparse(sparse_.W(b),sparse_.W(b+1));
+    }
+
+template <class Tensor>
+void inline LocalMPO<Tensor>::
+initSparse(Args const& args)
+    {
+    if(args.getBool("SparseMPO",false)) sparse_ = SparseMPOt<Tensor>(*Op_);
+    }
+
+template <class Tensor>
+Tensor inline LocalMPO<Tensor>::
+envUpdate(Tensor const& E, 
+          Tensor const& A, 
+          int j, 
+          Direction dir) const
+    {
+    if(sparse_)
+        {
+        //Edge tensors are null exactly when W(j)
+        //has no link index on that side
+        auto& W = sparse_.W(j);
+        auto& inI = (dir == Fromleft) ? W.row() : W.col();
+        if(bool(E) == bool(inI)) 
+            {
+            auto nE = sparseEnvUpdate(E,A,W,dir);
+            //Null if every term vanished; the dense
+            //update below gives a zero tensor instead
+            if(nE) return nE;
+            }
+        }
+    auto nE = E ? E*A : A;
+    nE *= Op_->A(j);
+    nE *= dag(prime(A));
+    return nE;
+    }
+
 template <class Tensor>
 void inline LocalMPO<Tensor>::
 setLHlim(int val)
     {
+    proj_ = Tensor();
     if(!do_write_)
         {
         LHlim_ = val;
@@ -590,6 +664,7 @@ template <class Tensor>
 void inline LocalMPO<Tensor>::
 setRHlim(int val)
     {
+    proj_ = Tensor();
     if(!do_write_)
         {
         RHlim_ = val;
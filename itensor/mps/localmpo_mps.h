@@ -133,12 +133,13 @@ product(Tensor const& phi,
     {
     lmpo_.product(phi,phip);
 
-    Tensor outer;
+    //Each |psi><psi| is a rank-one update using 
+    //the projector cached at the current position
     for(auto& M : lmps_)
         {
-        M.product(phi,outer);
-        outer *= weight_;
-        phip += outer;
+        auto& P = M.projector();
+        auto z = weight_*(P*phi).cplx();
+        phip += z*dag(P);
         }
     }
 
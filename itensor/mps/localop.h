@@ -5,6 +5,7 @@
 #ifndef __ITENSOR_LOCAL_OP
 #define __ITENSOR_LOCAL_OP
 #include "itensor/iqtensor.h"
+#include "itensor/mps/sparsempo.h"
 //#include "itensor/util/print_macro.h"
 
 namespace itensor {
@@ -28,6 +29,12 @@ namespace itensor {
 //  can even be null in which case
 //  they will not be used.)
 //
+// If sparse forms of Op1 and Op2 are
+// provided (see sparsempo.h), product
+// slices L and R along the MPO link
+// indices and only applies the nonzero
+// site operators of Op1 and Op2.
+//
 
 
 template <class Tensor>
@@ -37,6 +44,10 @@ class LocalOp
     Tensor const* Op2_;
     Tensor const* L_;
     Tensor const* R_;
+    SparseW<Tensor> const* sW1_ = nullptr;
+    SparseW<Tensor> const* sW2_ = nullptr;
+    mutable std::vector<Tensor> Ls_,
+                                Rs_;
     mutable long size_;
     public:
 
@@ -92,6 +103,15 @@ class LocalOp
            Tensor const& L, 
            Tensor const& R);
 
+    //Use sparse forms of Op1 and Op2 in product
+    //(call after update)
+    void
+    sparse(SparseW<Tensor> const& W1,
+           SparseW<Tensor> const& W2);
+
+    bool
+    isSparse() const { return sW1_ != nullptr; }
+
     Tensor const&
     Op1() const 
         { 
@@ -128,6 +148,11 @@ class LocalOp
     bool
     RIsNull() const;
 
+    private:
+
+    void
+    sparseProduct(Tensor const& phi, Tensor & phip) const;
+
     };
 
 template <class Tensor>
@@ -179,6 +204,10 @@ update(const Tensor& Op1, const Tensor& Op2)
     Op2_ = &Op2;
     L_ = nullptr;
     R_ = nullptr;
+    sW1_ = nullptr;
+    sW2_ = nullptr;
+    Ls_.clear();
+    Rs_.clear();
     size_ = -1;
     }
 
@@ -192,6 +221,20 @@ update(const Tensor& Op1, const Tensor& Op2,
     R_ = &R;
     }
 
+template <class Tensor>
+void inline LocalOp<Tensor>::
+sparse(SparseW<Tensor> const& W1,
+       SparseW<Tensor> const& W2)
+    {
+    //Edge tensors must be null exactly
+    //when the MPO has no link index there
+    if(LIsNull() != !W1.row() || RIsNull() != !W2.col()) return;
+    sW1_ = &W1;
+    sW2_ = &W2;
+    Ls_.clear();
+    Rs_.clear();
+    }
+
 template <class Tensor>
 bool inline LocalOp<Tensor>::
 LIsNull() const
@@ -213,8 +256,15 @@ void inline LocalOp<Tensor>::
 product(Tensor const& phi, 
         Tensor      & phip) const
     {
+    PROFILE_SCOPE("product")
     if(!(*this)) Error("LocalOp is null");
 
+    if(isSparse())
+        {
+        sparseProduct(phi,phip);
+        return;
+        }
+
     auto& Op1 = *Op1_;
     auto& Op2 = *Op2_;
 
@@ -242,6 +292,54 @@ product(Tensor const& phi,
     phip.mapprime(1,0);
     }
 
+//
+// phip = sum_(a,b,c) L_a * Op1_ab * Op2_bc * R_c * phi
+//
+template <class Tensor>
+void inline LocalOp<Tensor>::
+sparseProduct(Tensor const& phi, 
+              Tensor      & phip) const
+    {
+    auto& W1 = *sW1_;
+    auto& W2 = *sW2_;
+
+    //Slices of L and R are reused by all
+    //products until the next update
+    if(!LIsNull() && Ls_.empty()) Ls_ = slices(L(),W1.row());
+    if(!RIsNull() && Rs_.empty()) Rs_ = slices(R(),W2.col());
+
+    auto X = std::vector<Tensor>(W1.nrow());
+    for(auto a : range(X))
+        {
+        if(LIsNull()) X[a] = phi;
+        else if(Ls_.at(a)) X[a] = phi*Ls_.at(a); //m^3 d^2
+        if(detail::noBlocks(X[a])) X[a] = Tensor();
+        }
+
+    auto Y = std::vector<Tensor>(W1.ncol());
+    applyW(W1,X,Y,Fromleft);
+
+    auto Z = std::vector<Tensor>(W2.ncol());
+    applyW(W2,Y,Z,Fromleft);
+
+    phip = Tensor();
+    for(auto c : range(Z))
+        {
+        if(!Z[c]) continue;
+        if(RIsNull()) addIfNonzero(phip,Z[c]);
+        else if(Rs_.at(c)) addIfNonzero(phip,Z[c]*Rs_.at(c)); //m^3 d^2
+        }
+    if(!phip) 
+        {
+        //No nonzero terms
+        phip = phi;
+        phip *= 0.;
+        return;
+        }
+
+    phip.mapprime(1,0);
+    }
+
 template <class Tensor>
 Real inline LocalOp<Tensor>::
 expect(const Tensor& phi) const
@@ -92,42 +92,16 @@ template void MPOt<IQTensor>::
 position(int b, const Args& args);
 */
 
-/*
 template <class Tensor>
 void MPOt<Tensor>::
 orthogonalize(const Args& args)
     {
-    //Do a half-sweep to the right, orthogonalizing each bond
-    //but do not truncate since the basis to the right might not
-    //be ortho (i.e. use the current m).
-    //svd_.useOrigM(true);
-    int orig_maxm = maxm();
-    Real orig_cutoff = cutoff();
-    for(Spectrum& spec : spectrum_)
-        {
-        spec.maxm(MAX_M);
-        spec.cutoff(MIN_CUT);
-        }
-
-    position(1);
-    position(N_);
-
-    //Now basis is ortho, ok to truncate
-    for(Spectrum& spec : spectrum_)
-        {
-        spec.useOrigM(false);
-        spec.maxm(orig_maxm);
-        spec.cutoff(orig_cutoff);
-        }
-    position(1);
-
-    is_ortho_ = true;
+    compressMPO(*this,args);
     }
 template
 void MPOt<ITensor>::orthogonalize(const Args& args);
 template
 void MPOt<IQTensor>::orthogonalize(const Args& args);
-*/
 
 
 template <class Tensor>
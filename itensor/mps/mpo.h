@@ -107,11 +107,11 @@ class MPOt : private MPSt<Tensor>
     void 
     position(int i, const Args& args = Args::global()) { Parent::position(i,args + Args("UseSVD")); }
 
+    //Orthogonalizes and truncates the MPO using
+    //compressMPO (see below), leaving the
+    //orthogonality center at site 1
     void 
-    orthogonalize(Args const& args = Args::global()) 
-        { 
-        Parent::orthogonalize(args + Args("UseSVD")); 
-        }
+    orthogonalize(Args const& args = Args::global());
 
 
     private:
@@ -282,6 +282,61 @@ nmultMPO(MPOType const& Aorig,
          MPOType& res,
          Args args = Args::global());
 
+//
+// Compresses the MPO W in place by an SVD sweep: W is
+// first brought into left-canonical form with an SVD of 
+// each MPO tensor (discarding only singular values which 
+// vanish to machine precision), then each bond is truncated 
+// in a sweep back to site 1, leaving the orthogonality 
+// center there. Each step decomposes a single MPO tensor, 
+// an O(k^3 d^2) cost for bond dimension k and site 
+// dimension d, and IQMPO tensors are decomposed block by block.
+//
+// Returns the achieved relative error ||W_old-W_new||/||W_old||, 
+// estimated from the discarded weights, in the Frobenius
+// (Hilbert-Schmidt) norm. This also bounds the operator norm 
+// of W_old-W_new, which is at most the returned value times 
+// ||W_old|| (Frobenius norm).
+//
+// Arguments recognized:
+//   "Cutoff" (default: 1E-13) - truncation error goal of each bond
+//   "ErrGoal" - requested relative error of the whole MPO; sets
+//               the cutoff of each bond to ErrGoal^2/(N-1)
+//               (or lower if "Cutoff" is also given)
+//   "Maxm", "Minm" - maximum and minimum bond dimensions
+//   "Verbose" (default: false) - print requested and achieved errors
+//
+template<class Tensor>
+Real
+compressMPO(MPOt<Tensor> & W,
+            Args const& args = Args::global());
+
+//
+// Sets res to a compressed approximation of the sum of
+// the MPOs in terms, returning the achieved relative error
+// ||sum-res||/||sum|| in the Frobenius norm.
+//
+// Arguments recognized (in addition to those of 
+// compressMPO(W,args) above):
+//   "Method" (default: "SVD") - 
+//       "SVD": forms the exact sum of the terms, whose bond 
+//              dimension is the sum of theirs, then compresses 
+//              it with an SVD sweep.
+//       "Fit": variationally fits res to the sum without forming
+//              it, by two-site sweeps which cache the environments
+//              of each term. The starting point is res if it has
+//              the right number of sites, otherwise the compressed
+//              first term. The achieved error is computed from the 
+//              norms of the sum and of res, so is only accurate to 
+//              about 1E-7.
+//   "Nsweep" (default: 4) - number of sweeps used by "Fit"
+//
+template<class Tensor>
+Real
+compressMPO(std::vector<MPOt<Tensor>> const& terms,
+            MPOt<Tensor> & res,
+            Args const& args = Args::global());
+
 //
 // Applies an MPO to an MPS using the zip-up method described
 // more fully in Stoudenmire and White, New. J. Phys. 12, 055026 (2010).
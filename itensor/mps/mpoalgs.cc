@@ -89,6 +89,225 @@ void nmultMPO(const MPO& Aorig, const MPO& Borig, MPO& res, Args);
 template
 void nmultMPO(const IQMPO& Aorig, const IQMPO& Borig, IQMPO& res,Args);
 
+//Truncation args for compressMPO: "ErrGoal" is
+//shared equally between the N-1 bonds
+Args
+compressArgs(Args const& args, int N)
+    {
+    auto cutoff = args.getReal("Cutoff",1E-13);
+    if(args.defined("ErrGoal"))
+        {
+        auto bondcut = sqr(args.getReal("ErrGoal"))/std::max(N-1,1);
+        cutoff = args.defined("Cutoff") ? std::min(cutoff,bondcut) : bondcut;
+        }
+    auto targs = Args{"Cutoff",cutoff,"Minm",args.getInt("Minm",1)};
+    if(args.defined("Maxm")) targs.add("Maxm",args.getInt("Maxm"));
+    return targs;
+    }
+
+template<class Tensor>
+void
+reportCompression(MPOt<Tensor> const& W,
+                  Real err,
+                  Args const& args)
+    {
+    if(!args.getBool("Verbose",false)) return;
+    if(args.defined("ErrGoal"))
+        {
+        printfln("compressMPO: requested error %.3E, achieved %.3E, max m %d",
+                 args.getReal("ErrGoal"),err,maxM(W));
+        }
+    else
+        {
+        printfln("compressMPO: achieved error %.3E, max m %d",err,maxM(W));
+        }
+    }
+
+template<class Tensor>
+Real
+compressMPO(MPOt<Tensor> & W,
+            Args const& args)
+    {
+    auto N = W.N();
+    if(N < 2) return 0;
+    if(W.doWrite()) Error("compressMPO not supported if doWrite(true)");
+
+    //Left-canonical form. Only singular values which vanish 
+    //to machine precision are dropped, since the tensors to 
+    //the right are not yet orthonormal.
+    for(auto j : range1(N-1))
+        {
+        Tensor U,D,V(rightLinkInd(W,j));
+        svd(W.A(j),U,D,V,{"Cutoff",1E-28});
+        W.Aref(j) = U;
+        W.Aref(j+1) *= D*V;
+        }
+
+    //Truncate each bond, sweeping back to site 1.
+    //Each truncerr is relative to the weight kept 
+    //by the previous steps.
+    auto targs = compressArgs(args,N);
+    Real err2 = 0,
+         kept = 1;
+    for(int j = N; j > 1; --j)
+        {
+        Tensor U(leftLinkInd(W,j)),D,V;
+        auto spec = svd(W.A(j),U,D,V,targs);
+        W.Aref(j) = V;
+        W.Aref(j-1) *= U*D;
+        err2 += kept*spec.truncerr();
+        kept *= 1-spec.truncerr();
+        }
+    W.leftLim(0);
+    W.rightLim(2);
+
+    auto err = std::sqrt(err2);
+    reportCompression(W,err,args);
+    return err;
+    }
+template
+Real compressMPO(MPO & W, Args const& args);
+template
+Real compressMPO(IQMPO & W, Args const& args);
+
+template<class Tensor>
+Real
+fitMPO(std::vector<MPOt<Tensor>> const& terms,
+       MPOt<Tensor> & res,
+       Args const& args)
+    {
+    auto N = res.N();
+    auto nsweep = args.getInt("Nsweep",4);
+    auto targs = compressArgs(args,N);
+    auto nt = terms.size();
+
+    //Links of res are primed in the environments
+    //so they are distinct from those of the terms
+    int plev = 14741;
+    auto dagR = [&res,plev](int j) { return dag(prime(res.A(j),Link,plev)); };
+
+    //L[t][j] (R[t][j]) is the overlap of sites 1..j (j..N)
+    //of term t with res
+    auto L = vector<vector<Tensor>>(nt,vector<Tensor>(N+2)),
+         R = L;
+    auto extendL = [&](size_t t, int j)
+        {
+        auto E = (j > 1) ? L[t][j-1]*terms[t].A(j) : terms[t].A(j);
+        E *= dagR(j);
+        if(detail::noBlocks(E)) E = Tensor();
+        L[t][j] = E;
+        };
+    auto extendR = [&](size_t t, int j)
+        {
+        auto E = (j < N) ? R[t][j+1]*terms[t].A(j) : terms[t].A(j);
+        E *= dagR(j);
+        if(detail::noBlocks(E)) E = Tensor();
+        R[t][j] = E;
+        };
+    for(auto t : range(nt))
+    for(int j = N; j > 2; --j)
+        {
+        extendR(t,j);
+        }
+
+    for(auto sw : range1(nsweep))
+        {
+        for(int b = 1, ha = 1; ha <= 2; sweepnext(b,ha,N))
+            {
+            //Projection of the sum onto the
+            //basis of res outside sites b,b+1
+            Tensor phi;
+            for(auto t : range(nt))
+                {
+                if((b > 1 && !L[t][b-1]) || (b+1 < N && !R[t][b+2])) continue;
+                auto P = (b > 1) ? L[t][b-1]*terms[t].A(b) : terms[t].A(b);
+                P *= terms[t].A(b+1);
+                if(b+1 < N) P *= R[t][b+2];
+                addIfNonzero(phi,P);
+                }
+            if(!phi) Error("compressMPO: sum of terms is zero");
+            phi.mapprime(plev,0,Link);
+
+            Tensor U = res.A(b),D,V;
+            svd(phi,U,D,V,targs);
+            if(ha == 1)
+                {
+                res.Aref(b) = U;
+                res.Aref(b+1) = D*V;
+                for(auto t : range(nt)) extendL(t,b);
+                }
+            else
+                {
+                res.Aref(b) = U*D;
+                res.Aref(b+1) = V;
+                for(auto t : range(nt)) extendR(t,b+1);
+                }
+            }
+        if(args.getBool("Verbose",false))
+            {
+            printfln("compressMPO: fit sweep %d, max m %d",sw,maxM(res));
+            }
+        }
+    res.leftLim(0);
+    res.rightLim(2);
+
+    //res is the projection of the sum onto a subspace,
+    //so ||sum-res||^2 = ||sum||^2 - ||res||^2
+    Real norm2 = 0;
+    for(auto t1 : range(nt))
+        {
+        norm2 += overlapC(terms[t1],terms[t1]).real();
+        for(auto t2 : range(t1+1,nt))
+            {
+            norm2 += 2*overlapC(terms[t1],terms[t2]).real();
+            }
+        }
+    auto rnorm2 = sqr(norm(res.A(1)));
+    return std::sqrt(std::max(0.,norm2-rnorm2)/norm2);
+    }
+
+template<class Tensor>
+Real
+compressMPO(std::vector<MPOt<Tensor>> const& terms,
+            MPOt<Tensor> & res,
+            Args const& args)
+    {
+    if(terms.empty()) Error("compressMPO: no terms given");
+    auto N = terms.front().N();
+    for(auto& T : terms) if(T.N() != N) Error("compressMPO: terms have different numbers of sites");
+
+    auto method = args.getString("Method","SVD");
+    if(method == "SVD")
+        {
+        res = terms.front();
+        for(auto t : range(1,terms.size())) addExact(res,terms[t]);
+        return compressMPO(res,args);
+        }
+    else if(method == "Fit")
+        {
+        if(N < 2) Error("compressMPO: \"Fit\" method requires at least two sites");
+        if(res.N() != N)
+            {
+            res = terms.front();
+            compressMPO(res,{args,"Verbose",false});
+            }
+        else
+            {
+            //Canonical form with the center at site 1
+            compressMPO(res,{"Cutoff",1E-28});
+            }
+        auto err = fitMPO(terms,res,args);
+        reportCompression(res,err,args);
+        return err;
+        }
+    Error(format("compressMPO: unknown method \"%s\"",method));
+    return 0;
+    }
+template
+Real compressMPO(vector<MPO> const& terms, MPO & res, Args const& args);
+template
+Real compressMPO(vector<IQMPO> const& terms, IQMPO & res, Args const& args);
+
 
 template<class Tensor>
 void 
@@ -263,6 +263,13 @@ addAssumeOrth(MPSType      & L,
               MPSType const& R, 
               Args const& args = Args::global());
 
+//Sets L to the exact sum of L and R (the bond dimensions
+//of the result are the sums of those of L and R)
+template <class MPSType>
+MPSType&
+addExact(MPSType      & L,
+         MPSType const& R);
+
 //void 
 //convertToIQ(const SiteSet& sites, const std::vector<ITensor>& A, 
 //            std::vector<IQTensor>& qA, QN totalq = QN(), Real cut = 1E-12);
@@ -86,14 +86,14 @@ plussers(IQIndex const& l1,
     }
 
 //
-// Adds two MPSs but doesn't attempt to
-// orthogonalize them first
+// Adds two MPSs (or MPOs) exactly, without any
+// truncation: the bond dimensions of the result
+// are the sums of those of L and R
 //
 template <class MPSType>
 MPSType&
-addAssumeOrth(MPSType      & L,
-              MPSType const& R, 
-              Args const& args)
+addExact(MPSType      & L,
+         MPSType const& R)
     {
     using Tensor = typename MPSType::TensorT;
 
@@ -123,8 +123,25 @@ addAssumeOrth(MPSType      & L,
 
     L.noprimelink();
 
-    L.orthogonalize(args);
+    return L;
+    }
+template MPS& addExact(MPS & L,MPS const& R);
+template IQMPS& addExact(IQMPS & L,IQMPS const& R);
+template MPO& addExact(MPO & L,MPO const& R);
+template IQMPO& addExact(IQMPO & L,IQMPO const& R);
 
+//
+// Adds two MPSs but doesn't attempt to
+// orthogonalize them first
+//
+template <class MPSType>
+MPSType&
+addAssumeOrth(MPSType      & L,
+              MPSType const& R, 
+              Args const& args)
+    {
+    addExact(L,R);
+    L.orthogonalize(args);
     return L;
     }
 template MPS& addAssumeOrth(MPS & L,MPS const& R, Args const& args);
@@ -32,6 +32,9 @@ class Z3Site
     IQIndex
     index() const { return s; }
 
+    static constexpr bool
+    cacheOps() { return true; }
+
     IQIndexVal
     state(std::string const& state)
         {
@@ -50,6 +50,9 @@ class HubbardSite
     IQIndex
     index() const { return s; }
 
+    static constexpr bool
+    cacheOps() { return true; }
+
     IQIndexVal
     state(std::string const& state)
         {
@@ -31,6 +31,9 @@ class SpinHalfSite
     IQIndex
     index() const { return s; }
 
+    static constexpr bool
+    cacheOps() { return true; }
+
     IQIndexVal
     state(std::string const& state)
         {
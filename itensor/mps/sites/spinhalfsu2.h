@@ -0,0 +1,103 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#ifndef __ITENSOR_SPINHALFSU2_H
+#define __ITENSOR_SPINHALFSU2_H
+#include "itensor/mps/siteset.h"
+#include "itensor/su2tensor.h"
+#include "itensor/su2.h"
+
+namespace itensor {
+
+//
+// Spin 1/2 sites with SU(2) symmetry: the site
+// index is a single spin 1/2 multiplet, and
+// operators have SU2Dense storage.
+//
+// Operators:
+//  "Id", "S2" - identity and S^2 (rank 2)
+//  "S"        - the spin vector, with a third spin 1
+//               Link index shared by all sites, so that
+//               op(sites,"S",i)*op(sites,"Sdag",j)
+//               is S_i . S_j
+//  "Sdag"     - S with arrows and primes reversed
+//
+// There are no product states |j m>: state()
+// is not defined for these sites.
+//
+
+class SpinHalfSU2Site;
+
+using SpinHalfSU2 = BasicSiteSet<SpinHalfSU2Site>;
+
+class SpinHalfSU2Site
+    {
+    IQIndex s;
+    public:
+
+    SpinHalfSU2Site() { }
+
+    SpinHalfSU2Site(IQIndex I) : s(I) { }
+
+    SpinHalfSU2Site(int n, Args const& args = Args::global())
+        {
+        s = IQIndex{nameint("S=1/2 ",n),
+               Index(nameint("S ",n),1,Site),su2QN(1)};
+        }
+
+    IQIndex
+    index() const { return s; }
+
+    static constexpr bool
+    cacheOps() { return true; }
+
+    IQIndexVal
+    state(std::string const& state)
+        {
+        Error("SpinHalfSU2 sites have no product states (state \"" + state + "\" requested)");
+        return IQIndexVal{};
+        }
+
+	IQTensor
+	op(std::string const& opname,
+	   Args const& args) const
+        {
+        auto sP = prime(s);
+
+        if(opname == "Id" || opname == "S2")
+            {
+            auto is = IQIndexSet(dag(s),sP);
+            auto d = SU2DenseReal(is);
+            d.store.front() = (opname == "Id") ? 1. : 0.75;
+            return IQTensor(std::move(is),std::move(d));
+            }
+        else
+        if(opname == "S")
+            {
+            //The fusion tensor of (dag(s),sP,V) has squared
+            //norm 3, so this element makes the components S_q
+            //satisfy sum_q Tr[S_q S_q^dag] = <1/2||S||1/2>^2
+            static auto const V = IQIndex("S=1 link",Index("v",1,Link),su2QN(2));
+            auto is = IQIndexSet(dag(s),sP,V);
+            auto d = SU2DenseReal(is);
+            d.store.front() = reducedSpin(1)/std::sqrt(3.);
+            return IQTensor(std::move(is),std::move(d));
+            }
+        else
+        if(opname == "Sdag")
+            {
+            return swapPrime(dag(op("S",args)),0,1,Site);
+            }
+        else
+            {
+            Error("Operator \"" + opname + "\" name not recognized");
+            }
+
+        return IQTensor{};
+        }
+    };
+
+} //namespace itensor
+
+#endif
@@ -48,6 +48,9 @@ class SpinlessSite
     IQIndex
     index() const { return s; }
 
+    static constexpr bool
+    cacheOps() { return true; }
+
     IQIndexVal
     state(std::string const& state)
         {
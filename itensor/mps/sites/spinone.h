@@ -46,6 +46,9 @@ class SpinOneSite
     IQIndex
     index() const { return s; }
 
+    static constexpr bool
+    cacheOps() { return true; }
+
     IQIndexVal
     state(std::string const& state)
         {
@@ -4,6 +4,10 @@
 //
 #ifndef __ITENSOR_SITESET_H
 #define __ITENSOR_SITESET_H
+#include <mutex>
+#include <sstream>
+#include <typeinfo>
+#include <unordered_map>
 #include "itensor/iqtensor.h"
 
 namespace itensor {
@@ -26,6 +30,14 @@ namespace itensor {
 class GenericSite;
 struct SiteStore;
 
+//Hit and miss counts of the operator cache of a SiteSet
+struct SiteOpStats
+    {
+    long hits = 0,
+         misses = 0,
+         size = 0; //number of cached operators
+    };
+
 class SiteSet
     {
     std::shared_ptr<SiteStore> sites_;
@@ -60,10 +72,26 @@ class SiteSet
 
     //Get the operator indicated by
     //"opname" located at site i
+    //
+    //For site types declaring
+    //  static constexpr bool cacheOps() { return true; }
+    //(their op() depends only on the site index and the
+    //args passed to it, not on other members or on
+    //Args::global()), operators are built once for each
+    //kind of site, name and args, then cached and shared
+    //by all sites of that kind (and all copies of this
+    //SiteSet). Other site types build each operator on
+    //every call.
     IQTensor
     op(String const& opname, int i,
        Args const& args = Args::global()) const;
 
+    SiteOpStats
+    opCacheStats() const;
+
+    void
+    clearOpCache() const;
+
     void 
     read(std::istream & s) { readType<GenericSite>(s); }
 
@@ -97,6 +125,15 @@ class SiteSet
     void
     init(SiteStore && sites);
 
+    private:
+
+    //Builds the operator "opname" without using the cache
+    IQTensor
+    makeOp(String const& opname, int i,
+           Args const& args) const;
+
+    protected:
+
     template<typename SiteType>
     void
     readType(std::istream & s);
@@ -123,8 +160,28 @@ class SiteBase
 
     IQIndexVal virtual
     state(std::string const& state) = 0;
+
+    //Whether operators of this site can be cached
+    bool virtual
+    cacheOps() const = 0;
     };
 
+namespace detail {
+
+template<typename SiteType>
+auto
+cacheOps(stdx::choice<1>, SiteType const&)
+    -> decltype(SiteType::cacheOps())
+    {
+    return SiteType::cacheOps();
+    }
+
+template<typename SiteType>
+bool
+cacheOps(stdx::choice<2>, SiteType const&) { return false; }
+
+} //namespace detail
+
 //
 // Derived "box" type with virtual methods
 // Wraps any object implementing the "SiteType" interface
@@ -156,6 +213,9 @@ class SiteHolder : public SiteBase
         {
         return s.state(state);
         }
+
+    bool virtual
+    cacheOps() const { return detail::cacheOps(stdx::select_overload{},s); }
     };
 
 class GenericSite
@@ -187,23 +247,73 @@ class GenericSite
     };
 
 
+//
+// Operators cached by SiteStore, keyed by the kind of the
+// site (sites of the same type with identically structured
+// indices are of the same kind), the operator name and the
+// args passed to op() (not Args::global()). Each is stored with the site index
+// it was made for and moved onto the index of the requested
+// site, sharing its storage.
+//
+struct SiteOpCache
+    {
+    struct Key
+        {
+        int kind;
+        std::string opname,
+                    args;
+
+        bool
+        operator==(Key const& o) const 
+            { return kind == o.kind && opname == o.opname && args == o.args; }
+        };
+
+    struct KeyHash
+        {
+        size_t
+        operator()(Key const& k) const
+            {
+            auto h = std::hash<std::string>{}(k.opname);
+            h ^= std::hash<std::string>{}(k.args) + 0x9e3779b9 + (h << 6) + (h >> 2);
+            return h ^ (size_t(k.kind) << 1);
+            }
+        };
+
+    struct Entry
+        {
+        IQIndex site;
+        IQTensor op;
+        };
+
+    std::mutex mutex;
+    std::unordered_map<Key,Entry,KeyHash> ops;
+    SiteOpStats stats;
+    };
+
 struct SiteStore
     {
     using sptr = std::unique_ptr<SiteBase>;
     using storage = std::vector<sptr>;
     private:
     storage sites_;
+    std::vector<int> kind_;
+    std::unique_ptr<SiteOpCache> cache_;
     public:
 
-    SiteStore() { }
+    SiteStore() : cache_(new SiteOpCache()) { }
 
-    SiteStore(int N) : sites_(1+N) { }
+    SiteStore(int N) 
+      : sites_(1+N),
+        kind_(1+N,-1),
+        cache_(new SiteOpCache())
+        { }
 
     template<typename SiteType>
     void
     set(int i, SiteType && s) 
         {
         sites_.at(i) = sptr(new SiteHolder<SiteType>(std::move(s)));
+        setKind(i);
         }
 
     int
@@ -232,8 +342,141 @@ struct SiteStore
         if(not sites_.at(j)) Error("Unassigned site in SiteStore");
         return sites_[j]->op(opname,args);
         }
+
+    //Returns the cached operator for site j,
+    //calling make() to create it if not found
+    template<typename MakeOp>
+    IQTensor
+    cachedOp(int j,
+             std::string const& opname,
+             Args const& args,
+             MakeOp&& make) const;
+
+    SiteOpStats
+    cacheStats() const
+        {
+        std::lock_guard<std::mutex> lock(cache_->mutex);
+        auto stats = cache_->stats;
+        stats.size = cache_->ops.size();
+        return stats;
+        }
+
+    void
+    clearCache() const
+        {
+        std::lock_guard<std::mutex> lock(cache_->mutex);
+        cache_->ops.clear();
+        cache_->stats = SiteOpStats{};
+        }
+
+    private:
+
+    void
+    setKind(int i);
     };
 
+namespace detail {
+
+bool inline
+sameStructure(IQIndex const& I, IQIndex const& J)
+    {
+    if(I.nindex() != J.nindex() || I.m() != J.m() || I.dir() != J.dir()
+       || I.primeLevel() != J.primeLevel() || I.type() != J.type()) return false;
+    for(auto n : range1(I.nindex()))
+        {
+        if(I.index(n).m() != J.index(n).m() || I.qn(n) != J.qn(n)) return false;
+        }
+    return true;
+    }
+
+//Copy of T with its indices matching I (at any prime 
+//level) replaced by J, sharing the storage of T
+IQTensor inline
+moveToIndex(IQTensor T, 
+            IQIndex const& I, 
+            IQIndex const& J)
+    {
+    auto inds = std::vector<IQIndex>{};
+    inds.reserve(T.r());
+    for(auto& K : T.inds())
+        {
+        if(!K.noprimeEquals(I)) 
+            {
+            inds.push_back(K);
+            continue;
+            }
+        auto nK = J;
+        nK.primeLevel(K.primeLevel());
+        if(nK.dir() != K.dir()) nK.dag();
+        inds.push_back(nK);
+        }
+    auto scale = T.scale();
+    return IQTensor(IQIndexSet(std::move(inds)),std::move(T.store()),scale);
+    }
+
+//Key for the values of args passed to op(); 
+//Args::global() (the default) has an empty key
+std::string inline
+argsKey(Args const& args)
+    {
+    if(args.isGlobal() || args.size() == 0) return std::string{};
+    std::ostringstream s;
+    args.write(s);
+    return s.str();
+    }
+
+} //namespace detail
+
+void inline SiteStore::
+setKind(int i)
+    {
+    auto& site = *sites_[i];
+    auto I = site.index();
+    //Compare with the first site of each kind
+    for(auto j : range1(N()))
+        {
+        if(j == i || kind_[j] != j) continue;
+        if(typeid(*sites_[j]) == typeid(site) 
+           && detail::sameStructure(sites_[j]->index(),I))
+            {
+            kind_[i] = kind_[j];
+            return;
+            }
+        }
+    kind_[i] = i;
+    }
+
+template<typename MakeOp>
+IQTensor SiteStore::
+cachedOp(int j,
+         std::string const& opname,
+         Args const& args,
+         MakeOp&& make) const
+    {
+    if(not sites_.at(j)) Error("Unassigned site in SiteStore");
+    if(!sites_[j]->cacheOps()) return make();
+    auto& cache = *cache_;
+    auto key = SiteOpCache::Key{kind_[j],opname,detail::argsKey(args)};
+    auto I = si(j);
+    {
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto it = cache.ops.find(key);
+    if(it != cache.ops.end())
+        {
+        ++cache.stats.hits;
+        auto& e = it->second;
+        if(e.site == I) return e.op;
+        return detail::moveToIndex(e.op,e.site,I);
+        }
+    ++cache.stats.misses;
+    }
+    //The lock is not held while making the operator,
+    //which may request other operators
+    auto op = make();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.ops.emplace(std::move(key),SiteOpCache::Entry{I,op});
+    return op;
+    }
 
 inline SiteSet::
 SiteSet(int N, int d)
@@ -283,6 +526,27 @@ op(String const& opname,
    Args const& args) const
     { 
     if(not *this) Error("Cannot call .op(..) on default-initialized SiteSet");
+    return sites_->cachedOp(i,opname,args,[&]() { return makeOp(opname,i,args); });
+    }
+
+inline SiteOpStats SiteSet::
+opCacheStats() const
+    {
+    if(not *this) return SiteOpStats{};
+    return sites_->cacheStats();
+    }
+
+inline void SiteSet::
+clearOpCache() const
+    {
+    if(*this) sites_->clearCache();
+    }
+
+inline IQTensor SiteSet::
+makeOp(String const& opname, 
+       int i, 
+       Args const& args) const
+    { 
     if(opname == "Id")
         {
         IQIndex s = dag(si(i));
@@ -0,0 +1,421 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#ifndef __ITENSOR_SPARSEMPO_H
+#define __ITENSOR_SPARSEMPO_H
+
+#include <algorithm>
+#include "itensor/iqtensor.h"
+
+namespace itensor {
+
+template <class Tensor>
+class MPOt;
+
+//
+// An MPO tensor W viewed as a sparse matrix over its
+// two link indices whose entries are site operators:
+//
+//   W = sum_(a,b) |a><b| (x) coef_ab O_ab
+//
+// Only nonzero W_ab are stored. Each entry refers to
+// one of a few distinct operators O (entries which
+// are multiples of the same operator, such as the
+// Ntot of long-range density interactions, share it),
+// or to the identity, which is applied by copying
+// (contracting with a delta tensor).
+//
+// Either link index may be null, as for the first and
+// last tensors of a finite MPO; the matrix then has a
+// single row or column.
+//
+template<class Tensor>
+class SparseW
+    {
+    public:
+    using IndexT = typename Tensor::index_type;
+
+    struct Entry
+        {
+        long row = 0,
+             col = 0;
+        int op = -1; //position in ops(), -1 for the identity
+        Cplx coef = 1;
+
+        bool
+        isId() const { return op < 0; }
+        };
+
+    private:
+    IndexT row_,
+           col_,
+           site_;
+    std::vector<Tensor> ops_;
+    Tensor id_;
+    std::vector<Entry> entries_;  //sorted by row, then op
+    std::vector<long> bycol_;     //entries_ positions sorted by col, then op
+    long nid_ = 0;
+    public:
+
+    SparseW() { }
+
+    //row and col are the link indices of W (either may be null),
+    //site is the unprimed site index
+    SparseW(Tensor const& W,
+            IndexT const& row,
+            IndexT const& col,
+            IndexT const& site);
+
+    //Link and site indices as they appear in W
+    IndexT const&
+    row() const { return row_; }
+
+    IndexT const&
+    col() const { return col_; }
+
+    IndexT const&
+    site() const { return site_; }
+
+    long
+    nrow() const { return row_ ? row_.m() : 1; }
+
+    long
+    ncol() const { return col_ ? col_.m() : 1; }
+
+    std::vector<Entry> const&
+    entries() const { return entries_; }
+
+    //Positions in entries() ordered by column
+    std::vector<long> const&
+    entriesByCol() const { return bycol_; }
+
+    long
+    nnz() const { return entries_.size(); }
+
+    //Number of entries proportional to the identity
+    long
+    nidentity() const { return nid_; }
+
+    //Distinct non-identity operators
+    std::vector<Tensor> const&
+    ops() const { return ops_; }
+
+    //Identity operator as a delta tensor, whose product
+    //with a tensor has the same index order as that
+    //with the other operators
+    Tensor const&
+    identity() const { return id_; }
+
+    //Returns entry e applied to T, mapping the
+    //site index of T to its primed version
+    Tensor
+    apply(Entry const& e, Tensor const& T) const
+        {
+        auto res = e.isId() ? prime(T,site_) : T*ops_[e.op];
+        if(e.coef != Cplx(1.)) res *= e.coef;
+        return res;
+        }
+    };
+
+//Slices T at each value of its index I, returning
+//T(I=1), T(I=2), ... as tensors without I. Slices which
+//are zero are returned as null tensors.
+template<class Tensor>
+std::vector<Tensor>
+slices(Tensor const& T,
+       typename Tensor::index_type const& I)
+    {
+    using IndexT = typename Tensor::index_type;
+    auto J = findindex(T,[&I](IndexT const& K) { return K == I; });
+    if(!J) Error("slices: index not found in tensor");
+    auto res = std::vector<Tensor>(J.m());
+    for(auto n : range(J.m()))
+        {
+        res[n] = T*setElt(dag(J)(1+n));
+        if(norm(res[n]) == 0) res[n] = Tensor();
+        }
+    return res;
+    }
+
+namespace detail {
+
+//An IQTensor with no blocks has no well-defined
+//divergence: adding it to other IQTensors, or using
+//it in a contraction, gives wrong results
+bool inline
+noBlocks(ITensor const& T) { return !T; }
+
+bool inline
+noBlocks(IQTensor const& T) { return isEmpty(T); }
+
+} //namespace detail
+
+//Sets S += T, or S = T if S is null.
+//T is skipped if it is null or has no blocks.
+template<class Tensor>
+void
+addIfNonzero(Tensor & S, Tensor const& T)
+    {
+    if(detail::noBlocks(T)) return;
+    if(S) S += T;
+    else  S = T;
+    }
+
+template<class Tensor>
+SparseW<Tensor>::
+SparseW(Tensor const& W,
+        IndexT const& row,
+        IndexT const& col,
+        IndexT const& site)
+    {
+    auto inW = [&W](IndexT const& I)
+        {
+        if(!I) return I;
+        return findindex(W,[&I](IndexT const& K) { return K == I; });
+        };
+    row_ = inW(row);
+    col_ = inW(col);
+    site_ = inW(site);
+    auto sitep = inW(prime(site));
+    if((row && !row_) || (col && !col_) || !site_ || !sitep)
+        {
+        Error("SparseW: index not found in MPO tensor");
+        }
+    id_ = delta(site_,sitep);
+
+    //Elements of each distinct operator, scaled so
+    //that its first nonzero element is 1
+    auto d = site_.m();
+    auto opels = std::vector<std::vector<Cplx>>{};
+
+    auto rowW = row_ ? slices(W,row_) : std::vector<Tensor>{W};
+    for(auto a : range(rowW))
+        {
+        if(!rowW[a]) continue;
+        auto colW = col_ ? slices(rowW[a],col_) : std::vector<Tensor>{rowW[a]};
+        for(auto b : range(colW))
+            {
+            auto& O = colW[b];
+            if(!O) continue;
+            auto el = std::vector<Cplx>(d*d);
+            Real maxel = 0;
+            for(auto i : range(d))
+            for(auto j : range(d))
+                {
+                el[d*i+j] = O.cplx(dag(site_)(1+i),prime(site_)(1+j));
+                maxel = std::max(maxel,std::abs(el[d*i+j]));
+                }
+            auto first = std::find_if(el.begin(),el.end(),[](Cplx z) { return z != Cplx(0.); });
+            if(first == el.end()) continue;
+
+            auto e = Entry{};
+            e.row = a;
+            e.col = b;
+            e.coef = *first;
+            for(auto& z : el) z /= e.coef;
+
+            auto isId = true;
+            for(auto i : range(d))
+            for(auto j : range(d))
+                {
+                isId = isId && (el[d*i+j] == Cplx(i == j ? 1. : 0.));
+                }
+            if(isId)
+                {
+                ++nid_;
+                entries_.push_back(e);
+                continue;
+                }
+
+            //Look for an operator this entry is a multiple of
+            auto tol = 1E-14*maxel/std::abs(e.coef);
+            for(auto n : range(opels))
+                {
+                auto same = true;
+                for(auto k : range(el)) same = same && std::abs(el[k]-opels[n][k]) <= tol;
+                if(same)
+                    {
+                    e.op = n;
+                    break;
+                    }
+                }
+            if(e.isId())
+                {
+                e.op = ops_.size();
+                opels.push_back(el);
+                ops_.push_back(O/e.coef);
+                }
+            entries_.push_back(e);
+            }
+        }
+
+    std::stable_sort(entries_.begin(),entries_.end(),
+                     [](Entry const& x, Entry const& y)
+                     { return x.row < y.row || (x.row == y.row && x.op < y.op); });
+    bycol_.resize(entries_.size());
+    for(auto n : range(bycol_)) bycol_[n] = n;
+    std::stable_sort(bycol_.begin(),bycol_.end(),
+                     [this](long x, long y)
+                     {
+                     auto &ex = entries_[x],
+                          &ey = entries_[y];
+                     return ex.col < ey.col || (ex.col == ey.col && ex.op < ey.op);
+                     });
+    }
+
+//
+// Sets out[b] += sum_a W_ab in[a] (Fromleft) or
+// out[a] += sum_b W_ab in[b] (Fromright), skipping
+// null inputs. Each input is contracted once with
+// each distinct operator in its row (column); entries
+// sharing that operator add scaled copies of the result.
+//
+template<class Tensor>
+void
+applyW(SparseW<Tensor> const& W,
+       std::vector<Tensor> const& in,
+       std::vector<Tensor> & out,
+       Direction dir)
+    {
+    using Entry = typename SparseW<Tensor>::Entry;
+    bool fromleft = (dir == Fromleft);
+    auto& E = W.entries();
+    auto entry = [&](long n) -> Entry const&
+        {
+        return fromleft ? E[n] : E[W.entriesByCol()[n]];
+        };
+    auto src = [fromleft](Entry const& e) { return fromleft ? e.row : e.col; };
+    auto dst = [fromleft](Entry const& e) { return fromleft ? e.col : e.row; };
+
+    Tensor P;
+    for(long n = 0; n < W.nnz(); ++n)
+        {
+        auto& e = entry(n);
+        auto& t = in.at(src(e));
+        if(!t) continue;
+        if(n == 0 || entry(n-1).op != e.op || src(entry(n-1)) != src(e))
+            {
+            P = t*(e.isId() ? W.identity() : W.ops()[e.op]); //m^2 d^3
+            if(detail::noBlocks(P)) P = Tensor();
+            }
+        if(!P) continue;
+        auto Pe = P;
+        if(e.coef != Cplx(1.)) Pe *= e.coef;
+        addIfNonzero(out.at(dst(e)),Pe);
+        }
+    }
+
+//
+// Sparse versions of the environment updates
+//
+//   E*A*W*dag(prime(A))
+//
+// done by LocalMPO. From the left, E carries the row
+// index of W (or is null if W has no row index) and
+// the result carries its column index; from the right
+// the roles are reversed. Returns a null tensor if
+// every term is zero.
+//
+template<class Tensor>
+Tensor
+sparseEnvUpdate(Tensor const& E,
+                Tensor const& A,
+                SparseW<Tensor> const& W,
+                Direction dir)
+    {
+    bool fromleft = (dir == Fromleft);
+    auto& inI = fromleft ? W.row() : W.col();
+    auto& outI = fromleft ? W.col() : W.row();
+    auto nout = fromleft ? W.ncol() : W.nrow();
+    if(bool(E) != bool(inI)) Error("sparseEnvUpdate: edge tensor does not match MPO tensor");
+
+    //T_a = E_a*A for each value a of the incoming link
+    auto T = inI ? slices(E,inI) : std::vector<Tensor>{Tensor()};
+    for(auto& t : T)
+        {
+        if(!inI) t = A;
+        else if(t) t *= A;
+        if(detail::noBlocks(t)) t = Tensor();
+        }
+
+    auto U = std::vector<Tensor>(nout);
+    applyW(W,T,U,dir);
+
+    auto Ad = dag(prime(A));
+    Tensor res;
+    for(auto b : range(U))
+        {
+        if(!U[b]) continue;
+        auto Eb = U[b]*Ad;
+        if(detail::noBlocks(Eb)) continue;
+        if(outI) Eb *= setElt(outI(1+b));
+        addIfNonzero(res,Eb);
+        }
+    return res;
+    }
+
+//
+// An MPO stored as a SparseW for each site, used
+// by LocalMPO (with the arg "SparseMPO") for
+// effective Hamiltonian products and environment
+// updates which loop over the nonzero W_ab only.
+//
+template<class Tensor>
+class SparseMPOt
+    {
+    std::vector<SparseW<Tensor>> W_;
+    public:
+    using IndexT = typename Tensor::index_type;
+
+    SparseMPOt() { }
+
+    explicit
+    SparseMPOt(MPOt<Tensor> const& H);
+
+    int
+    N() const { return int(W_.size())-1; }
+
+    SparseW<Tensor> const&
+    W(int j) const { return W_.at(j); }
+
+    explicit operator bool() const { return !W_.empty(); }
+    };
+
+using SparseMPO = SparseMPOt<ITensor>;
+using SparseIQMPO = SparseMPOt<IQTensor>;
+
+template<class Tensor>
+SparseMPOt<Tensor>::
+SparseMPOt(MPOt<Tensor> const& H)
+    : W_(H.N()+1)
+    {
+    auto N = H.N();
+    auto isLink = [](IndexT const& I) { return I.type() == Link; };
+    for(auto j : range1(N))
+        {
+        auto& W = H.A(j);
+        auto links = std::vector<IndexT>{};
+        for(auto& I : W.inds()) if(isLink(I)) links.push_back(I);
+        if(links.size() > 2) Error("SparseMPO: MPO tensor has more than two link indices");
+
+        //The link shared with the next (previous)
+        //tensor is the column (row) index
+        IndexT row,col;
+        for(auto& I : links)
+            {
+            if(j < N && hasindex(H.A(j+1),I)) col = I;
+            else if(j > 1 && hasindex(H.A(j-1),I)) row = I;
+            else if(j == 1 && N > 1) row = I;
+            else if(j == N && N > 1) col = I;
+            else Error("SparseMPO: cannot determine link index order");
+            }
+
+        auto s = findindex(W,[](IndexT const& I) { return I.type() == Site && I.primeLevel() == 0; });
+        W_.at(j) = SparseW<Tensor>(W,row,col,s);
+        }
+    }
+
+} //namespace itensor
+
+#endif
@@ -6,7 +6,9 @@
 #define __ITENSOR_TEVOL_H
 
 #include "itensor/mps/mpo.h"
+#include "itensor/util/cputime.h"
 #include "itensor/mps/bondgate.h"
+#include "itensor/mps/trotter.h"
 #include "itensor/mps/TEvolObserver.h"
 
 namespace itensor {
@@ -15,9 +17,18 @@ namespace itensor {
 //
 // Evolves an MPS in real or imaginary time by an amount ttotal in steps
 // of tstep using the list of bond gates provided.
+// The gate list can also be a TrotterGates object
+// (see trotter.h) holding the gates of one time step.
+//
+// After each time step the observer is passed the
+// arguments "StepTruncErr" (largest truncation error
+// of the step), "StepMaxm" (largest bond dimension
+// kept during the step) and "StepCPUTime" and
+// "StepWallTime" (time taken by the step in seconds).
 //
 // Arguments recognized:
-//    "Verbose": if true, print useful information to stdout
+//    "Verbose": if true, print useful information to stdout,
+//               including the above after each time step
 //
 template <class Iterable, class Tensor>
 Real
@@ -70,6 +81,15 @@ gateTEvol(Iterable const& gatelist,
     Real tsofar = 0;
     for(int tt = 1; tt <= nt; ++tt)
         {
+        auto step_time = cpu_time();
+        Real truncerr = 0;
+        long maxm = 0;
+        auto record = [&truncerr,&maxm](Spectrum const& spec)
+            {
+            truncerr = std::max(truncerr,spec.truncerr());
+            maxm = std::max(maxm,long(spec.numEigsKept()));
+            };
+
         auto g = gatelist.begin();
         while(g != gatelist.end())
             {
@@ -88,19 +108,19 @@ gateTEvol(Iterable const& gatelist,
                 //before applying current gate
                 if(ni1 >= i2)
                     {
-                    psi.svdBond(i1,AA,Fromleft,args);
+                    record(psi.svdBond(i1,AA,Fromleft,args));
                     psi.position(ni1); //does no work if position already ni1
                     }
                 else
                     {
-                    psi.svdBond(i1,AA,Fromright,args);
+                    record(psi.svdBond(i1,AA,Fromright,args));
                     psi.position(ni2); //does no work if position already ni2
                     }
                 }
             else
                 {
                 //No next gate to analyze, just restore MPS form
-                psi.svdBond(i1,AA,Fromright,args);
+                record(psi.svdBond(i1,AA,Fromright,args));
                 }
             }
 
@@ -111,6 +131,17 @@ gateTEvol(Iterable const& gatelist,
 
         tsofar += tstep;
 
+        auto t = step_time.sincemark();
+        if(verbose)
+            {
+            printfln("Step %d, time %.5f: max trunc. err. %.2E, max m %d, cpu %.3fs, wall %.3fs",
+                     tt,tsofar,truncerr,maxm,t.time,t.wall);
+            }
+
+        args.add("StepTruncErr",truncerr);
+        args.add("StepMaxm",maxm);
+        args.add("StepCPUTime",t.time);
+        args.add("StepWallTime",t.wall);
         args.add("TimeStepNum",tt);
         args.add("Time",tsofar);
         args.add("TotalTime",ttotal);
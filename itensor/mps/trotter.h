@@ -0,0 +1,182 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#ifndef __ITENSOR_TROTTER_H
+#define __ITENSOR_TROTTER_H
+
+#include <map>
+#include "itensor/decomp.h"
+#include "itensor/mps/bondgate.h"
+
+namespace itensor {
+
+template <class Tensor>
+class TrotterGates;
+
+using Trotter = TrotterGates<ITensor>;
+using IQTrotter = TrotterGates<IQTensor>;
+
+//
+// The gates making up one time step of a Trotter
+// decomposition of a static nearest-neighbor
+// Hamiltonian H = sum_b H_b, where H_b acts on
+// sites b and b+1.
+//
+// A time step is built from sweeps over the bonds,
+//
+//   S2(a*tstep) = e^{a tstep H_1/2}...e^{a tstep H_(N-1)/2}
+//                 e^{a tstep H_(N-1)/2}...e^{a tstep H_1/2}
+//
+// which is the second order splitting. The fourth
+// order splitting is Suzuki's
+//
+//   S4(tstep) = S2(p tstep)^2 S2((1-4p) tstep) S2(p tstep)^2
+//
+// with p = 1/(4-4^(1/3)). Adjacent gates on the same
+// bond (at the ends of each sweep) are fused into one
+// gate, so that an order 2 step has 2N-3 gates and an
+// order 4 step 10N-19 gates rather than 2N-2 and
+// 10N-10.
+//
+// Each distinct exponential is computed once, with
+// expHermitian, and shared by every gate using it. A
+// TrotterGates object can be reused for any number of
+// time steps, and passed to gateTEvol in place of a
+// list of BondGates. Since the gates of each sweep
+// act on neighboring bonds in one direction, gateTEvol
+// moves the orthogonality center one site per gate.
+//
+// bondH[b] is the Hamiltonian of bond b, for
+// b = 1,2,...,N-1; bonds whose bondH is null are
+// skipped.
+//
+// Arguments recognized:
+//    "Order": 2 (default) or 4
+//
+template <class Tensor>
+class TrotterGates
+    {
+    public:
+    using GateT = BondGate<Tensor>;
+    using Type = typename GateT::Type;
+    using const_iterator = typename std::vector<GateT>::const_iterator;
+
+    TrotterGates(SiteSet const& sites,
+                 std::vector<Tensor> const& bondH,
+                 Type type,
+                 Real tstep,
+                 Args const& args = Args::global());
+
+    int
+    order() const { return order_; }
+
+    Real
+    tstep() const { return tstep_; }
+
+    Type
+    type() const { return type_; }
+
+    //Gates of one time step, in the order applied
+    std::vector<GateT> const&
+    gates() const { return gates_; }
+
+    //Number of exponentials computed
+    long
+    numExponentials() const { return nexp_; }
+
+    const_iterator
+    begin() const { return gates_.begin(); }
+
+    const_iterator
+    end() const { return gates_.end(); }
+
+    GateT const&
+    front() const { return gates_.front(); }
+
+    GateT const&
+    back() const { return gates_.back(); }
+
+    size_t
+    size() const { return gates_.size(); }
+
+    private:
+
+    int order_ = 2;
+    Real tstep_ = 0;
+    Type type_;
+    std::vector<GateT> gates_;
+    long nexp_ = 0;
+    };
+
+template <class Tensor>
+TrotterGates<Tensor>::
+TrotterGates(SiteSet const& sites,
+             std::vector<Tensor> const& bondH,
+             Type type,
+             Real tstep,
+             Args const& args)
+  : order_(args.getInt("Order",2)),
+    tstep_(tstep),
+    type_(type)
+    {
+    if(!(type_ == GateT::tReal || type_ == GateT::tImag))
+        {
+        Error("TrotterGates: type must be tReal or tImag");
+        }
+
+    //Fractions of tstep of the S2 factors
+    auto fracs = std::vector<Real>{};
+    if(order_ == 2)
+        {
+        fracs = {1.};
+        }
+    else if(order_ == 4)
+        {
+        auto p = 1./(4.-std::pow(4.,1./3));
+        fracs = {p,p,1.-4*p,p,p};
+        }
+    else
+        {
+        Error(format("TrotterGates: Order %d not supported, must be 2 or 4",order_));
+        }
+
+    auto bonds = std::vector<int>{};
+    for(auto b : range1(sites.N()-1))
+        {
+        if(b < int(bondH.size()) && bondH[b]) bonds.push_back(b);
+        }
+    if(bonds.empty()) Error("TrotterGates: no bond Hamiltonians provided");
+
+    //Sequence of (bond,fraction of tstep) with
+    //adjacent factors on the same bond fused
+    auto seq = std::vector<std::pair<int,Real>>{};
+    auto add = [&seq](int b, Real c)
+        {
+        if(!seq.empty() && seq.back().first == b) seq.back().second += c;
+        else                                      seq.emplace_back(b,c);
+        };
+    for(auto a : fracs)
+        {
+        for(auto n : range(bonds)) add(bonds[n],a/2);
+        for(auto n = int(bonds.size())-1; n >= 0; --n) add(bonds[n],a/2);
+        }
+
+    auto cache = std::map<std::pair<int,Real>,Tensor>{};
+    for(auto& bc : seq)
+        {
+        auto it = cache.find(bc);
+        if(it == cache.end())
+            {
+            auto t = Cplx(-bc.second*tstep_,0.);
+            if(type_ == GateT::tReal) t *= Complex_i;
+            it = cache.emplace(bc,expHermitian(bondH[bc.first],t)).first;
+            ++nexp_;
+            }
+        gates_.emplace_back(sites,bc.first,bc.first+1,it->second);
+        }
+    }
+
+} //namespace itensor
+
+#endif
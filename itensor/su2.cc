@@ -0,0 +1,244 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <vector>
+#include "itensor/su2.h"
+#include "itensor/util/range.h"
+
+namespace itensor {
+
+namespace {
+
+//(-1)^n
+Real
+sign(int n) { return (n%2 == 0) ? 1. : -1.; }
+
+//Whether j and m differ by an integer with |m| <= j
+bool
+isProjection(int tj, int tm)
+    {
+    return tj >= 0 && std::abs(tm) <= tj && (tj+tm)%2 == 0;
+    }
+
+//Matrix elements of the raising and lowering operators,
+//<j m+1|J+|j m> and <j m-1|J-|j m>
+Real
+raise(int tj, int tm) { return std::sqrt(0.25*(tj-tm)*(tj+tm+2)); }
+Real
+lower(int tj, int tm) { return std::sqrt(0.25*(tj+tm)*(tj-tm+2)); }
+
+//Coefficients <j1 m1, j2 M-m1|J M> for given j1 and j2 and
+//all J, one vector per J (ordered as su2Fuse(tj1,tj2)) with
+//m1 fastest: element (tJ+tM)/2*(tj1+1)+(tj1+tm1)/2
+//
+//The alternating Racah sums lose precision to cancellation
+//for large spins, and so does the recursion J-|J M> built
+//from J1- + J2- once it runs over many M. Instead |J M> is
+//found from J^2|J M> = J(J+1)|J M>, which in the basis
+//|m1,M-m1> of fixed M is a three-term recursion in m1.
+//It is run from both ends towards the largest coefficient,
+//so that it only grows and each coefficient, however
+//small, keeps a relative precision of a few eps.
+//The sign comes from the lowering operator,
+//<J M-1|J-|J M> > 0, and the highest weight states obey
+//the Condon-Shortley convention <j1 j1, j2 J-j1|J J> > 0.
+//States with M < 0 follow from the symmetry
+//  <j1 -m1, j2 -m2|J -M> = (-1)^(j1+j2-J) <j1 m1, j2 m2|J M>
+std::vector<std::vector<Real>>
+makeCGTables(int tj1, int tj2)
+    {
+    auto n1 = tj1+1;
+    auto Js = su2Fuse(tj1,tj2);
+    auto t = std::vector<std::vector<Real>>(Js.size());
+    for(auto nJ : range(Js)) t[nJ].assign(n1*(Js[nJ]+1),0.);
+    auto el = [&t,&Js,n1,tj1](int tJ, int tm1, int tM) -> Real&
+        {
+        return t[(tJ-Js.front())/2][(tJ+tM)/2*n1+(tj1+tm1)/2];
+        };
+    auto jj = [](int tj) { return 0.25*tj*(tj+2); };
+    auto x = std::vector<Real>{};
+    for(auto tM = Js.back(); tM >= 0; tM -= 2)
+        {
+        auto tmlo = std::max(-tj1,tM-tj2),
+             tmhi = std::min(tj1,tM+tj2);
+        auto n = (tmhi-tmlo)/2+1;
+        //Row a of J^2 - J(J+1) is
+        //  off(a-1) x(a-1) + (diag(a)-J(J+1)) x(a) + off(a) x(a+1)
+        //where x(a) is the coefficient of m1 = tmlo+2a
+        auto diag = [&](int a) { auto tm1 = tmlo+2*a; return jj(tj1)+jj(tj2)+0.5*tm1*(tM-tm1); };
+        auto off = [&](int a) { auto tm1 = tmlo+2*a; return raise(tj1,tm1)*lower(tj2,tM-tm1); };
+        for(auto tJ = tM; tJ <= Js.back(); tJ += 2)
+            {
+            if(tJ < Js.front()) continue;
+            auto lam = jj(tJ);
+            x.assign(n,0.);
+            //Forward from a = 0 while |x| grows
+            x[0] = 1.;
+            int k = 0;
+            while(k+1 < n)
+                {
+                auto next = -((diag(k)-lam)*x[k]+(k > 0 ? off(k-1)*x[k-1] : 0.))/off(k);
+                if(std::fabs(next) < std::fabs(x[k])) break;
+                x[++k] = next;
+                }
+            //Backward from a = n-1 down to k, matched at k
+            if(k+1 < n)
+                {
+                auto y = std::vector<Real>(n-k);
+                y.back() = 1.;
+                for(auto a = n-1; a > k; --a)
+                    {
+                    auto b = a-k;
+                    y[b-1] = -((diag(a)-lam)*y[b]+(a+1 < n ? off(a)*y[b+1] : 0.))/off(a-1);
+                    }
+                auto fac = x[k]/y[0];
+                for(auto a = k+1; a < n; ++a) x[a] = fac*y[a-k];
+                }
+            Real nrm = 0;
+            for(auto v : x) nrm += v*v;
+            nrm = std::sqrt(nrm);
+            auto fac = 1./nrm;
+            if(tJ == tM)
+                {
+                //Here tmhi = tj1
+                if(x[n-1] < 0) fac = -fac;
+                }
+            else
+                {
+                //Sign from the overlap with (J1- + J2-)|J M+1>
+                Real ovl = 0;
+                for(auto a : range(n))
+                    {
+                    auto tm1 = tmlo+2*a,
+                         tm2 = tM-tm1;
+                    if(tm1+2 <= tj1) ovl += x[a]*lower(tj1,tm1+2)*el(tJ,tm1+2,tM+2);
+                    if(tm2+2 <= tj2) ovl += x[a]*lower(tj2,tm2+2)*el(tJ,tm1,tM+2);
+                    }
+                if(ovl < 0) fac = -fac;
+                }
+            for(auto a : range(n)) el(tJ,tmlo+2*a,tM) = fac*x[a];
+            }
+        }
+    for(auto tJ : Js)
+    for(auto tM = 2-tJ%2; tM <= tJ; tM += 2)
+    for(auto tm1 = -tj1; tm1 <= tj1; tm1 += 2)
+        {
+        el(tJ,-tm1,-tM) = sign((tj1+tj2-tJ)/2)*el(tJ,tm1,tM);
+        }
+    return t;
+    }
+
+} //namespace
+
+bool
+isTriangle(int tj1, int tj2, int tj3)
+    {
+    if(tj1 < 0 || tj2 < 0 || tj3 < 0) return false;
+    if((tj1+tj2+tj3)%2 != 0) return false;
+    return tj3 >= std::abs(tj1-tj2) && tj3 <= tj1+tj2;
+    }
+
+std::vector<int>
+su2Fuse(int tj1, int tj2)
+    {
+    auto res = std::vector<int>{};
+    for(auto tJ = std::abs(tj1-tj2); tJ <= tj1+tj2; tJ += 2) res.push_back(tJ);
+    return res;
+    }
+
+Real
+clebschGordan(int tj1, int tm1,
+              int tj2, int tm2,
+              int tJ,  int tM)
+    {
+    if(tm1+tm2 != tM) return 0.;
+    if(!isTriangle(tj1,tj2,tJ)) return 0.;
+    if(!isProjection(tj1,tm1) || !isProjection(tj2,tm2) || !isProjection(tJ,tM)) return 0.;
+    //Tables are cached per thread, so no locking is needed
+    thread_local std::map<std::pair<int,int>,std::vector<std::vector<Real>>> tables;
+    auto key = std::make_pair(tj1,tj2);
+    auto it = tables.find(key);
+    if(it == tables.end()) it = tables.emplace(key,makeCGTables(tj1,tj2)).first;
+    return it->second[(tJ-std::abs(tj1-tj2))/2][(tJ+tM)/2*(tj1+1)+(tj1+tm1)/2];
+    }
+
+Real
+wigner3j(int tj1, int tj2, int tj3,
+         int tm1, int tm2, int tm3)
+    {
+    //(j1 j2 j3; m1 m2 m3) = (-1)^(j1-j2-m3) <j1 m1, j2 m2|j3 -m3>/sqrt(2j3+1)
+    if(tm1+tm2+tm3 != 0) return 0.;
+    if(!isTriangle(tj1,tj2,tj3)) return 0.;
+    return sign((tj1-tj2-tm3)/2)*clebschGordan(tj1,tm1,tj2,tm2,tj3,-tm3)/std::sqrt(tj3+1.);
+    }
+
+Real
+wigner6j(int tj1, int tj2, int tj3,
+         int tj4, int tj5, int tj6)
+    {
+    if(!isTriangle(tj1,tj2,tj3) || !isTriangle(tj1,tj5,tj6)
+    || !isTriangle(tj4,tj2,tj6) || !isTriangle(tj4,tj5,tj3)) return 0.;
+
+    //From the overlap of the two ways of coupling
+    //a = j1, b = j2, d = j4 to total spin e = j5,
+    //
+    //  <(ab)c,d;e|a,(bd)f;e> = (-1)^(a+b+d+e) sqrt((2c+1)(2f+1)) {a b c; d e f}
+    //
+    //evaluated at M = e as a sum of Clebsch-Gordan products
+    auto ta = tj1, tb = tj2, tc = tj3,
+         td = tj4, te = tj5, tf = tj6;
+    Real sum = 0;
+    for(auto tma = -ta; tma <= ta; tma += 2)
+    for(auto tmb = -tb; tmb <= tb; tmb += 2)
+        {
+        auto tmd = te-tma-tmb;
+        if(std::abs(tmd) > td) continue;
+        auto tmc = tma+tmb,
+             tmf = tmb+tmd;
+        if(std::abs(tmc) > tc || std::abs(tmf) > tf) continue;
+        sum += clebschGordan(ta,tma,tb,tmb,tc,tmc)*clebschGordan(tc,tmc,td,tmd,te,te)
+              *clebschGordan(tb,tmb,td,tmd,tf,tmf)*clebschGordan(ta,tma,tf,tmf,te,te);
+        }
+    return sign((ta+tb+td+te)/2)*sum/std::sqrt((tc+1.)*(tf+1.));
+    }
+
+Real
+wigner9j(int tj1, int tj2, int tj3,
+         int tj4, int tj5, int tj6,
+         int tj7, int tj8, int tj9)
+    {
+    //Sum over x of (-1)^(2x) (2x+1) {j1 j4 j7; j8 j9 x}
+    //                               {j2 j5 j8; j4 x j6}
+    //                               {j3 j6 j9; x j1 j2}
+    auto txmin = std::max({std::abs(tj1-tj9),std::abs(tj4-tj8),std::abs(tj2-tj6)}),
+         txmax = std::min({tj1+tj9,tj4+tj8,tj2+tj6});
+    Real sum = 0;
+    for(auto tx = txmin; tx <= txmax; tx += 2)
+        {
+        sum += sign(tx)*(tx+1.)*wigner6j(tj1,tj4,tj7,tj8,tj9,tx)
+                               *wigner6j(tj2,tj5,tj8,tj4,tx,tj6)
+                               *wigner6j(tj3,tj6,tj9,tx,tj1,tj2);
+        }
+    return sum;
+    }
+
+Real
+wignerEckart(int tj,  int tm,
+             int tk,  int tq,
+             int tjp, int tmp)
+    {
+    return sign((tj-tm)/2)*wigner3j(tj,tk,tjp,-tm,tq,tmp);
+    }
+
+Real
+reducedSpin(int tj)
+    {
+    //sqrt[j(j+1)(2j+1)]
+    return std::sqrt(0.25*tj*(tj+2.)*(tj+1.));
+    }
+
+} //namespace itensor
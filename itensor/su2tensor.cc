@@ -0,0 +1,267 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#include <map>
+#include <mutex>
+#include "itensor/su2tensor.h"
+#include "itensor/su2.h"
+#include "itensor/itdata/qdense.h"
+#include "itensor/itdata/qutil.h"
+#include "itensor/util/print_macro.h"
+
+using std::vector;
+using std::move;
+
+namespace itensor {
+
+bool
+isSU2(IQTensor const& T)
+    {
+    if(!T.store()) return false;
+    auto type = doTask(StorageType{},T.store());
+    return type == StorageType::SU2DenseReal
+        || type == StorageType::SU2DenseCplx;
+    }
+
+IQTensor
+randomSU2Tensor(IQIndexSet const& is)
+    {
+    auto dat = SU2DenseReal{is};
+    auto T = IQTensor(is,move(dat));
+    randomize(T);
+    return T;
+    }
+
+IQTensor
+su2Combiner(vector<IQIndex> cinds,
+            Args const& args)
+    {
+    if(cinds.empty()) Error("No indices passed to su2Combiner");
+    auto cname = args.getString("IndexName","cmb");
+    auto itype = getIndexType(args,"IndexType",Link);
+
+    auto cdir = Out;
+    if(args.defined("IndexDir"))
+        {
+        cdir = toArrow(args.getInt("IndexDir"));
+        }
+    else
+        {
+        //Make the combined IQIndex point Out unless
+        //all combined indices have In arrows
+        auto allin = true;
+        for(auto& i : cinds)
+            if(i.dir() != In)
+                {
+                allin = false;
+                break;
+                }
+        if(allin) cdir = In;
+        }
+
+    //Each channel of total spin tJ is a fusion tree
+    //of a set of sectors of the combined indices,
+    //occupying a range of the tJ sector of the
+    //combined index as large as the set of sectors
+    struct Channel
+        {
+        vector<long> block;
+        long tJ = 0;
+        vector<long> tree;
+        long start = 0;
+        long size = 1;
+        };
+    auto channels = vector<Channel>{};
+    auto dims = std::map<long,long>{};
+
+    auto r = cinds.size();
+    auto RB = RangeBuilder(r);
+    for(auto& I : cinds) RB.nextIndex(I.nindex());
+    for(auto I : RB.build())
+        {
+        auto ch = Channel{};
+        long maxJ = 0;
+        auto tj = vector<long>(1+r);
+        for(auto j : range(r))
+            {
+            ch.block.push_back(I[j]);
+            tj[1+j] = su2Spin(cinds[j].qn(1+I[j]));
+            maxJ += tj[1+j];
+            ch.size *= cinds[j][I[j]].m();
+            }
+        for(ch.tJ = maxJ%2; ch.tJ <= maxJ; ch.tJ += 2)
+            {
+            tj.front() = ch.tJ;
+            for(auto& k : su2FusionTrees(tj))
+                {
+                ch.tree = k;
+                ch.start = dims[ch.tJ];
+                dims[ch.tJ] += ch.size;
+                channels.push_back(ch);
+                }
+            }
+        }
+
+    auto cstore = stdx::reserve_vector<IndexQN>(dims.size());
+    auto csector = std::map<long,long>{};
+    for(auto& d : dims)
+        {
+        csector[d.first] = cstore.size();
+        cstore.emplace_back(Index{nameint("c",cstore.size()),d.second,itype},su2QN(d.first));
+        }
+    auto cind = IQIndex{cname,move(cstore),cdir};
+
+    auto newind = IQIndexSetBuilder(1+r);
+    newind.nextIndex(cind);
+    for(auto& I : cinds) newind.nextIndex(dag(I));
+    auto is = newind.build();
+
+    //Elements are normalized so that the combiner
+    //is unitary: the fusion tensors have squared norm
+    //tj+1 of their last index, instead of tJ+1
+    auto C = SU2DenseReal{is};
+    for(auto& ch : channels)
+        {
+        auto label = vector<long>{csector[ch.tJ]};
+        label.insert(label.end(),ch.block.begin(),ch.block.end());
+        label.insert(label.end(),ch.tree.begin(),ch.tree.end());
+        auto* pc = findBlock(C.offsets,label);
+        if(!pc) Error("su2Combiner: missing block");
+        auto dimc = dims[ch.tJ];
+        auto tjlast = su2Spin(cinds.back().qn(1+ch.block.back()));
+        auto el = std::sqrt((ch.tJ+1.)/(tjlast+1.));
+        for(auto l : range(ch.size))
+            {
+            C.store.at(pc->offset+ch.start+l+dimc*l) = el;
+            }
+        }
+
+    return IQTensor{move(is),move(C)};
+    }
+
+IQIndex
+szIndex(IQIndex const& I)
+    {
+    static std::mutex mutex;
+    static std::map<Index::id_type,IQIndex> made;
+
+    auto S = IQIndex{};
+        {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = made.find(I.id());
+        if(it == made.end())
+            {
+            auto store = IQIndex::storage{};
+            for(auto n : range1(I.nindex()))
+                {
+                auto tj = su2Spin(I.qn(n));
+                for(auto tm = tj; tm >= -tj; tm -= 2)
+                    {
+                    store.emplace_back(Index{nameint("Sz",tm),I.index(n).m(),I.type()},QN("Sz=",tm));
+                    }
+                }
+            it = made.emplace(I.id(),IQIndex{I.rawname(),move(store)}).first;
+            }
+        S = it->second;
+        }
+    if(S.dir() != I.dir()) S.dag();
+    S.prime(I.primeLevel());
+    return S;
+    }
+
+struct ToSzBasis
+    {
+    IQIndexSet const& is;
+    IQIndexSet const& szis;
+    LogNum const& scale;
+    ToSzBasis(IQIndexSet const& is_,
+              IQIndexSet const& szis_,
+              LogNum const& scale_)
+      : is(is_), szis(szis_), scale(scale_)
+        { }
+    };
+
+template<typename V>
+IQTensor
+doTask(ToSzBasis & S, SU2Dense<V> const& d)
+    {
+    auto& is = S.is;
+    auto r = is.r();
+    auto Q = QDense<V>{S.szis,QN()};
+    if(r == 0)
+        {
+        Q.store.front() = d.store.front();
+        return IQTensor{S.szis,move(Q),S.scale};
+        }
+
+    //First sector of S.szis[i] made from sector s of is[i]
+    auto start = vector<vector<long>>(r);
+    for(auto i : range(r))
+        {
+        long n = 0;
+        for(auto s : range1(is[i].nindex()))
+            {
+            start[i].push_back(n);
+            n += su2Spin(is[i].qn(s))+1;
+            }
+        }
+
+    auto dir = vector<Arrow>(r);
+    for(auto i : range(r)) dir[i] = is[i].dir();
+
+    auto szblock = Labels(r);
+    for(auto n : range(d.offsets.size()))
+        {
+        auto& bo = d.offsets[n];
+        auto tj = su2Spins(is,bo.block);
+        auto X = su2FusionTensor(tj,dir,vector<long>(bo.block.begin()+r,bo.block.end()));
+        long size = 1;
+        auto RB = RangeBuilder(r);
+        for(auto i : range(r))
+            {
+            RB.nextIndex(tj[i]+1);
+            size *= is[i][bo.block[i]].m();
+            }
+        for(auto I : RB.build())
+            {
+            long x = 0,
+                 str = 1;
+            for(auto i : range(r))
+                {
+                x += I[i]*str;
+                str *= tj[i]+1;
+                }
+            auto val = X[x];
+            if(val == 0.) continue;
+            //Sectors of S.szis are ordered from m = j down to -j
+            for(auto i : range(r)) szblock[i] = start[i][bo.block[i]]+tj[i]-I[i];
+            auto qb = getBlock(Q,S.szis,szblock);
+            if(!qb) Error("toSzBasis: block of QDense storage not found");
+            for(auto l : range(size)) qb[l] += val*d.store[bo.offset+l];
+            }
+        }
+    return IQTensor{S.szis,move(Q),S.scale};
+    }
+
+IQTensor
+toSzBasis(IQTensor const& T)
+    {
+    if(!isSU2(T)) Error("toSzBasis requires an IQTensor with SU2Dense storage");
+    auto szis = IQIndexSetBuilder(T.r());
+    for(auto& I : T.inds()) szis.nextIndex(szIndex(I));
+    auto is = szis.build();
+    return doTask(ToSzBasis{T.inds(),is,T.scale()},T.store());
+    }
+
+template<typename V>
+ITensor
+doTask(ToITensor & T, SU2Dense<V> const& d)
+    {
+    Error("toITensor not defined for SU2Dense storage, use toSzBasis");
+    return ITensor{};
+    }
+template ITensor doTask(ToITensor & T, SU2Dense<Real> const& d);
+template ITensor doTask(ToITensor & T, SU2Dense<Cplx> const& d);
+
+} //namespace itensor
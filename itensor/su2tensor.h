@@ -0,0 +1,89 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#ifndef __ITENSOR_SU2TENSOR_H
+#define __ITENSOR_SU2TENSOR_H
+
+#include "itensor/iqtensor.h"
+#include "itensor/itdata/su2dense.h"
+
+namespace itensor {
+
+//
+// IQTensors with SU(2) symmetry
+//
+// An SU(2) invariant IQTensor has SU2Dense storage
+// and IQIndex sectors labeled by su2QN(tj), each
+// sector holding m() copies of the spin tj/2
+// multiplet. Contraction, addition, norm, dag and
+// svd act on the reduced elements; individual
+// elements |j m> are available through toSzBasis.
+// svd keeps or truncates whole multiplets, so its
+// "Maxm" and "Minm" count multiplets, not states.
+//
+// Example:
+//
+//   auto s = IQIndex("s",Index("s0",2),su2QN(0),
+//                        Index("s1",1),su2QN(2));
+//   auto T = randomSU2Tensor(s,prime(dag(s)));
+//   auto Tsz = toSzBasis(T); //QDense storage
+//
+
+//True if T has SU2Dense storage
+bool
+isSU2(IQTensor const& T);
+
+//SU(2) invariant tensor with random reduced elements
+template<typename... Inds>
+IQTensor
+randomSU2Tensor(IQIndex const& i1, Inds&&... inds);
+
+IQTensor
+randomSU2Tensor(IQIndexSet const& is);
+
+//
+// Unitary SU(2) invariant tensor combining the
+// indices inds into a single index, the first
+// index of the result, whose sectors are the total
+// spins of the combined multiplets.
+// Accepts the same Args as combiner:
+// "IndexName", "IndexType" and "IndexDir".
+//
+IQTensor
+su2Combiner(std::vector<IQIndex> inds,
+            Args const& args = Args::global());
+
+//
+// IQIndex of the states |j m> of the multiplets
+// of I: each sector of I is replaced by sectors
+// with QN("Sz=",tm), tm = tj,tj-2,...,-tj, of the
+// same size. The same IQIndex (up to prime level
+// and arrow) is returned for every copy of I.
+//
+IQIndex
+szIndex(IQIndex const& I);
+
+//Elements of an SU(2) invariant tensor in the
+//basis |j m> of each index (see szIndex), as an
+//IQTensor with QDense storage
+IQTensor
+toSzBasis(IQTensor const& T);
+
+
+///////////////////////////
+//
+// Implementation
+//
+//////////////////////////
+
+template<typename... Inds>
+IQTensor
+randomSU2Tensor(IQIndex const& i1, Inds&&... inds)
+    {
+    return randomSU2Tensor(IQIndexSet{i1,std::forward<Inds>(inds)...});
+    }
+
+} //namespace itensor
+
+#endif
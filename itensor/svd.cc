@@ -36,7 +36,7 @@ svdImpl(ITensor const& A,
         ITensor & V,
         Args const& args)
     {
-    SCOPED_TIMER(7);
+    PROFILE_SCOPE("svd")
     auto do_truncate = args.getBool("Truncate");
     auto thresh = args.getReal("SVDThreshold",1E-3);
     auto cutoff = args.getReal("Cutoff",MIN_CUT);
@@ -56,9 +56,7 @@ svdImpl(ITensor const& A,
     Mat<T> UU,VV;
     Vector DD;
 
-    TIMER_START(6)
     SVD(M,UU,DD,VV,thresh);
-    TIMER_STOP(6)
 
     //conjugate VV so later we can just do
     //U*D*V to reconstruct ITensor A:
@@ -131,6 +129,221 @@ svdImpl(ITensor const& A,
 
 
 
+//
+// SVD of a rank 2 SU(2) invariant tensor: each block of
+// reduced elements is decomposed once for its whole
+// multiplet, and truncation keeps or discards entire
+// multiplets. Maxm and Minm count multiplets, while
+// Cutoff applies to their total weight (2j+1)*s^2.
+//
+template<typename T>
+Spectrum
+su2SvdImpl(IQTensor const& A, 
+           IQIndex const& uI, 
+           IQIndex const& vI,
+           IQTensor & U, 
+           IQTensor & D, 
+           IQTensor & V,
+           Args const& args)
+    {
+    PROFILE_SCOPE("svd")
+    auto do_truncate = args.getBool("Truncate");
+    auto thresh = args.getReal("SVDThreshold",1E-3);
+    auto cutoff = args.getReal("Cutoff",0);
+    auto maxm = args.getInt("Maxm",MAX_INT);
+    auto minm = args.getInt("Minm",1);
+    auto doRelCutoff = args.getBool("DoRelCutoff",true);
+    auto absoluteCutoff = args.getBool("AbsoluteCutoff",false);
+    auto show_eigs = args.getBool("ShowEigs",false);
+    auto lname = args.getString("LeftIndexName","ul");
+    auto rname = args.getString("RightIndexName","vl");
+    auto itype = getIndexType(args,"IndexType",Link);
+    auto litype = getIndexType(args,"LeftIndexType",itype);
+    auto ritype = getIndexType(args,"RightIndexType",itype);
+    auto compute_qn = args.getBool("ComputeQNs",false);
+
+    auto blocks = doTask(GetBlocks<T>{A.inds(),uI,vI},A.store());
+
+    auto Nblock = blocks.size();
+    if(Nblock == 0) throw ResultIsZero("IQTensor has no blocks");
+
+    auto Umats = vector<Mat<T>>(Nblock);
+    auto Vmats = vector<Mat<T>>(Nblock);
+    auto dvecs = vector<Vector>(Nblock);
+
+    struct Multiplet
+        {
+        Real p = 0;
+        long deg = 1;
+        long block = 0;
+        bool
+        operator>(Multiplet const& o) const { return p > o.p; }
+        };
+    auto mults = vector<Multiplet>{};
+
+    for(auto b : range(Nblock))
+        {
+        auto& UU = Umats.at(b);
+        auto& VV = Vmats.at(b);
+        auto& d =  dvecs.at(b);
+
+        SVD(blocks[b].M,UU,d,VV,thresh);
+
+        //conjugate VV so later we can just do
+        //U*D*V to reconstruct ITensor A:
+        conjugate(VV);
+
+        auto deg = su2Spin(uI.qn(1+blocks[b].i1))+1;
+        for(auto sval : d) mults.push_back({sval*sval,deg,long(b)});
+        }
+
+    //Sort multiplets from largest to smallest weight
+    stdx::sort(mults,std::greater<Multiplet>{});
+
+    long nkeep = mults.size();
+    Real truncerr = 0;
+    if(do_truncate)
+        {
+        Real scale = 1.;
+        if(doRelCutoff && !absoluteCutoff)
+            {
+            scale = 0.;
+            for(auto& M : mults) scale += M.deg*M.p;
+            if(scale == 0.) scale = 1.;
+            }
+        while(nkeep > maxm)
+            {
+            --nkeep;
+            truncerr += mults[nkeep].deg*mults[nkeep].p;
+            }
+        while(nkeep > minm)
+            {
+            auto& M = mults[nkeep-1];
+            if(absoluteCutoff ? (M.p >= cutoff) : (truncerr+M.deg*M.p >= cutoff*scale)) break;
+            truncerr += M.deg*M.p;
+            --nkeep;
+            }
+        if(nkeep < 1) nkeep = 1;
+        if(!absoluteCutoff) truncerr /= scale;
+        }
+
+    auto this_m = vector<long>(Nblock,0);
+    auto probs = vector<Real>{};
+    auto qns = vector<QN>{};
+    for(auto n : range(nkeep))
+        {
+        auto& M = mults[n];
+        this_m.at(M.block) += 1;
+        probs.insert(probs.end(),M.deg,M.p);
+        if(compute_qn) qns.insert(qns.end(),M.deg,uI.qn(1+blocks[M.block].i1));
+        }
+    auto nprob = probs.size();
+    auto P = Vector(move(probs),VecRange{nprob});
+
+    if(show_eigs) 
+        {
+        auto showargs = args;
+        showargs.add("Cutoff",cutoff);
+        showargs.add("Maxm",maxm);
+        showargs.add("Minm",minm);
+        showargs.add("Truncate",do_truncate);
+        showargs.add("DoRelCutoff",doRelCutoff);
+        showargs.add("AbsoluteCutoff",absoluteCutoff);
+        showEigs(P,truncerr,A.scale(),showargs);
+        }
+
+    auto Liq = IQIndex::storage{};
+    auto Riq = IQIndex::storage{};
+    for(auto b : range(Nblock))
+        {
+        if(this_m[b] == 0) continue;
+        auto& B = blocks[b];
+        Liq.emplace_back(Index("l",this_m[b],litype),uI.qn(1+B.i1));
+        Riq.emplace_back(Index("r",this_m[b],ritype),vI.qn(1+B.i2));
+        }
+    auto L = IQIndex(lname,move(Liq),uI.dir());
+    auto R = IQIndex(rname,move(Riq),vI.dir());
+
+    auto Uis = IQIndexSet(uI,dag(L));
+    auto Dis = IQIndexSet(L,R);
+    auto Vis = IQIndexSet(vI,dag(R));
+
+    auto Ustore = SU2Dense<T>(Uis);
+    auto Vstore = SU2Dense<T>(Vis);
+    auto Dstore = SU2DenseReal(Dis);
+
+    //U*D*V has the fusion tensor of (uI,vI); if A
+    //stores its indices as (vI,uI) the two differ
+    //by a sign for half-integer spins with equal arrows
+    auto dirs = vector<Arrow>{uI.dir(),vI.dir()};
+    auto transpose = (vI == A.inds().front());
+
+    long n = 0;
+    for(auto b : range(Nblock))
+        {
+        if(this_m[b] == 0) continue;
+        auto& B = blocks[b];
+        auto& UU = Umats.at(b);
+        auto& VV = Vmats.at(b);
+        auto& d = dvecs.at(b);
+        auto m = this_m[b];
+
+        auto pU = findBlock(Ustore.offsets,{B.i1,n});
+        assert(pU != nullptr);
+        auto Uref = makeMatRef(Ustore.data()+pU->offset,Ustore.size()-pU->offset,uI[B.i1].m(),m);
+        reduceCols(UU,m);
+        Uref &= UU;
+
+        auto pD = findBlock(Dstore.offsets,{n,n});
+        assert(pD != nullptr);
+        for(auto j : range(m)) Dstore.store[pD->offset+j+j*m] = std::max(d(j),0.);
+
+        long tj = su2Spin(uI.qn(1+B.i1));
+        Real c = 1.;
+        if(transpose)
+            {
+            auto XD = su2FusionTensor({tj,tj},dirs,{});
+            auto XA = su2FusionTensor({tj,tj},{vI.dir(),uI.dir()},{});
+            c = 0.;
+            for(auto i : range(tj+1))
+            for(auto j : range(tj+1))
+                c += XD[i+(tj+1)*j]*XA[j+(tj+1)*i];
+            c /= tj+1;
+            }
+
+        auto pV = findBlock(Vstore.offsets,{B.i2,n});
+        assert(pV != nullptr);
+        auto Vref = makeMatRef(Vstore.data()+pV->offset,Vstore.size()-pV->offset,vI[B.i2].m(),m);
+        reduceCols(VV,m);
+        if(c < 0) VV *= -1.;
+        Vref &= VV;
+
+        ++n;
+        }
+
+    //Fix sign to make sure D has positive elements
+    Real signfix = (A.scale().sign() == -1) ? -1. : +1.;
+
+    U = IQTensor(Uis,move(Ustore));
+    D = IQTensor(Dis,move(Dstore),A.scale()*signfix);
+    V = IQTensor(Vis,move(Vstore),LogNum{signfix});
+
+    //Originally eigs were found without including scale
+    //so put the scale back in
+    if(A.scale().isFiniteReal())
+        {
+        P *= sqr(A.scale().real0());
+        }
+    else
+        {
+        println("Warning: scale not finite real after svd");
+        }
+
+    if(compute_qn) return Spectrum(move(P),move(qns),{"Truncerr",truncerr});
+
+    return Spectrum(move(P),{"Truncerr",truncerr});
+    } // su2SvdImpl
+
 template<typename T>
 Spectrum
 svdImpl(IQTensor A, 
@@ -141,6 +354,9 @@ svdImpl(IQTensor A,
         IQTensor & V,
         Args const& args)
     {
+    if(isSU2(A)) return su2SvdImpl<T>(A,uI,vI,U,D,V,args);
+
+    PROFILE_SCOPE("svd")
     auto do_truncate = args.getBool("Truncate");
     auto thresh = args.getReal("SVDThreshold",1E-3);
     auto cutoff = args.getReal("Cutoff",0);
@@ -12,6 +12,7 @@
 #include "itensor/tensor/sliceten.h"
 #include "itensor/indexset.h"
 #include "itensor/global.h"
+#include "itensor/itdata/storagepool.h"
 
 using std::vector;
 
@@ -732,7 +733,11 @@ contract(CProps const& p,
     auto Bbufsize = isCplx(B) ? 2ul*Bpsize : Bpsize;
     auto Cbufsize = isCplx(C) ? 2ul*Cpsize : Cpsize;
 
-    auto d = std::vector<Real>(Abufsize+Bbufsize+Cbufsize);
+    //Scratch space for the permuted tensors; only the
+    //part for C is read before being written, by gemm
+    //when beta is nonzero
+    auto d = acquireStorage<Real>(Abufsize+Bbufsize+Cbufsize,UninitStorage{});
+    if(beta != 0) std::fill(d.begin()+Abufsize+Bbufsize,d.end(),0.);
     auto ab = MAKE_SAFE_PTR(d.data(),d.size());
     auto bb = ab+Abufsize;
     auto cb = bb+Bbufsize;
@@ -740,7 +745,7 @@ contract(CProps const& p,
     MatRefc<VA> aref;
     if(p.permuteA())
         {
-        SCOPED_TIMER(12)
+        PROFILE_SCOPE("permute",0,2.*sizeof(VA)*Apsize)
         auto aptr = SAFE_REINTERPRET(VA,ab);
         auto tref = makeTenRef(SAFE_PTR_GET(aptr,Apsize),Apsize,&p.newArange);
         tref &= permute(A,p.PA);
@@ -761,7 +766,7 @@ contract(CProps const& p,
     MatRefc<VB> bref;
     if(p.permuteB())
         {
-        SCOPED_TIMER(13)
+        PROFILE_SCOPE("permute",0,2.*sizeof(VB)*Bpsize)
         auto bptr = SAFE_REINTERPRET(VB,bb);
         auto tref = makeTenRef(SAFE_PTR_GET(bptr,Bpsize),Bpsize,&p.newBrange);
         tref &= permute(B,p.PB);
@@ -799,18 +804,17 @@ contract(CProps const& p,
             }
         }
 
-    START_TIMER(11)
     gemm(aref,bref,cref,alpha,beta);
-    STOP_TIMER(11)
 
     if(p.permuteC())
         {
-        SCOPED_TIMER(14)
+        PROFILE_SCOPE("permute",0,2.*sizeof(VC)*Cpsize)
 #ifdef DEBUG
         if(isTrivial(p.PC)) Error("Calling permute in contract with a trivial permutation");
 #endif
         C &= permute(newC,p.PC);
         }
+    releaseStorage(d);
     }
 
 template<typename R, typename T1, typename T2>
@@ -1103,29 +1107,6 @@ contractloop(TenRefc<IndexSet> A, Labels const& ai,
              Args const& args);
 
 
-////////////////////////////////////////
-
-//All indices of B contracted
-//(A can have some uncontracted indices)
-template<typename RangeT>
-void 
-contractDiagFull(VectorRefc A,         Labels const& ai, 
-                 TenRefc<RangeT> B, Labels const& bi, 
-                 VectorRef          C, Labels const& ci)
-    {
-    Error("contractDiagFull not yet implemented");
-    }
-template
-void 
-contractDiagFull(VectorRefc     A, Labels const& ai, 
-                 TenRefc<Range> B, Labels const& bi, 
-                 VectorRef      C, Labels const& ci);
-template
-void 
-contractDiagFull(VectorRefc        A, Labels const& ai, 
-                 TenRefc<IndexSet> B, Labels const& bi, 
-                 VectorRef         C, Labels const& ci);
-
 ////////////////////////////////////////////
 
 //
@@ -61,6 +61,20 @@ contractDiagPartial(DiagElsA           const& A, Labels const& ai,
                     TenRef<RangeT,VC>  const& C, Labels const& ci,
                     IntArray                  astarts = IntArray{});
 
+//A and B both diagonal, sharing an index
+template<typename DiagElsA, typename DiagElsB, typename VC>
+void 
+contractDiagDiag(DiagElsA   const& A,
+                 DiagElsB   const& B,
+                 VecRef<VC> const& C);
+
+//A and B both diagonal, no common indices
+template<typename DiagElsA, typename DiagElsB, typename VC>
+void 
+contractDiagOuter(DiagElsA   const& A, size_t astride,
+                  DiagElsB   const& B, size_t bstride,
+                  VecRef<VC> const& C, size_t cstart = 0);
+
 //Non-contracting product
 template<class TA, class TB, class TC>
 void 
@@ -275,6 +289,47 @@ contractDiagPartial(DiagElsA           const& A, Labels const& al,
         }
     auto pb = MAKE_SAFE_PTR(B.data(),B.size());
     auto pc = MAKE_SAFE_PTR(C.data(),C.size());
+
+    //The diagonal J runs innermost unless B has an
+    //uncontracted index with a smaller stride, as when
+    //scaling the rows of a matrix U(i,a)*S(a,b). Then
+    //that index runs innermost instead, so B and C are
+    //read and written contiguously
+    auto inner = 0;
+    for(auto i : range(nbu))
+        {
+        if(bustride[i] < bustride[inner]) inner = i;
+        }
+    if(nbu > 0 && size_t(bustride[inner]) < b_cstride)
+        {
+        auto ninner = GC.last[inner]+1;
+        auto bis = bustride[inner],
+             cis = custride[inner];
+        GC.setRange(inner,0,0);
+        for(;GC.notDone();++GC)
+            {
+            size_t coffset = cstart;
+            size_t boffset = bstart;
+            for(auto i : range(nbu))
+                {
+                auto ii = GC[i];
+                boffset += ii*bustride[i];
+                coffset += ii*custride[i];
+                }
+            for(auto J : range(A))
+                {
+                auto a = A(J);
+                auto bJ = boffset+J*b_cstride;
+                auto cJ = coffset+J*c_cstride;
+                for(decltype(ninner) k = 0; k < ninner; ++k)
+                    {
+                    pc[cJ+k*cis] += a*pb[bJ+k*bis];
+                    }
+                }
+            }
+        return;
+        }
+
     for(;GC.notDone();++GC)
         {
         size_t coffset = 0;
@@ -334,6 +389,76 @@ contractDiagFull(DiagElsA           const& A, Labels const& al,
         }
     }
 
+// C = A*B
+//case where A and B are both diagonal and share
+//at least one index, making C diagonal with
+//C(J) = A(J)*B(J), or the sum of A(J)*B(J) over J
+//if all indices are contracted (C.size()==1)
+template<typename DiagElsA, typename DiagElsB, typename VC>
+void 
+contractDiagDiag(DiagElsA   const& A,
+                 DiagElsB   const& B,
+                 VecRef<VC> const& C)
+    {
+    auto n = std::min(A.size(),B.size());
+    if(C.size() == 1)
+        {
+        auto *Cval = C.data();
+        for(decltype(n) J = 0; J < n; ++J)
+            {
+            *Cval += A(J)*B(J);
+            }
+        }
+    else
+        {
+        auto pc = MAKE_SAFE_PTR(C.data(),C.size());
+        for(decltype(n) J = 0; J < n; ++J)
+            {
+            pc[J] += A(J)*B(J);
+            }
+        }
+    }
+
+// C = A*B
+//case where A and B are both diagonal with no
+//common indices: C(i,...,i,j,...,j) = A(i)*B(j)
+//is the element at offset cstart+i*astride+j*bstride
+//of C, astride (bstride) being the sum of the strides
+//in C of the indices of A (B)
+template<typename DiagElsA, typename DiagElsB, typename VC>
+void 
+contractDiagOuter(DiagElsA   const& A, size_t astride,
+                  DiagElsB   const& B, size_t bstride,
+                  VecRef<VC> const& C, size_t cstart)
+    {
+    auto pc = MAKE_SAFE_PTR(C.data(),C.size());
+    //Step through C with the smaller stride innermost
+    if(astride <= bstride)
+        {
+        for(auto j : range(B))
+            {
+            auto b = B(j);
+            auto cj = cstart+j*bstride;
+            for(auto i : range(A))
+                {
+                pc[cj+i*astride] = A(i)*b;
+                }
+            }
+        }
+    else
+        {
+        for(auto i : range(A))
+            {
+            auto a = A(i);
+            auto ci = cstart+i*astride;
+            for(auto j : range(B))
+                {
+                pc[ci+j*bstride] = a*B(j);
+                }
+            }
+        }
+    }
+
 } //namespace itensor
 
 #include "itensor/tensor/contract.ih"
@@ -0,0 +1,155 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#ifndef __ITENSOR_ELEMENTWISE_H
+#define __ITENSOR_ELEMENTWISE_H
+
+#include <algorithm>
+#include <future>
+#include <vector>
+#include "itensor/global.h"
+#include "itensor/types.h"
+
+namespace itensor {
+
+//
+// Multithreaded loops over the elements of tensor
+// storage, for operations such as scaling, conjugation
+// and adding permuted tensors which are bound by memory
+// bandwidth rather than arithmetic.
+//
+// Loops over fewer than elementwiseMinSize elements
+// run serially on the calling thread, since below that
+// starting threads costs more than it saves. Larger
+// loops are split into contiguous chunks processed by
+// up to Global::elementwiseThreads() threads (default 1,
+// which turns the parallel loops off). Loops started
+// from inside a chunk, a parallelRun node or a job of
+// runJobs run serially.
+//
+// Real data is scaled and added by the BLAS routines
+// dscal and daxpy, which are vectorized and usually
+// threaded already, so the kernels here are used for
+// complex, mixed real and complex, and strided data.
+//
+
+const size_t elementwiseMinSize = 1ul << 17;
+
+namespace detail {
+
+bool inline&
+inParallelChunk()
+    {
+    static thread_local bool in = false;
+    return in;
+    }
+
+} //namespace detail
+
+//Calls f(begin,end) for contiguous chunks [begin,end)
+//covering [0,n), in parallel if work (the number of
+//elements the loop processes) is at least
+//elementwiseMinSize. Exceptions thrown by f are
+//rethrown on the calling thread.
+template<typename Func>
+void
+parallelChunks(size_t n,
+               size_t work,
+               Func&& f)
+    {
+    if(n == 0) return;
+    auto nthread = size_t(std::max(1,Global::elementwiseThreads()));
+    nthread = std::min(nthread,n);
+    if(nthread == 1 || work < elementwiseMinSize || detail::inParallelChunk())
+        {
+        f(size_t(0),n);
+        return;
+        }
+    auto chunk = (n+nthread-1)/nthread;
+    auto run = [&f](size_t b, size_t e)
+        {
+        detail::inParallelChunk() = true;
+        try { f(b,e); }
+        catch(...)
+            {
+            detail::inParallelChunk() = false;
+            throw;
+            }
+        detail::inParallelChunk() = false;
+        };
+    auto futs = std::vector<std::future<void>>{};
+    for(auto b = chunk; b < n; b += chunk)
+        {
+        futs.push_back(std::async(std::launch::async,run,b,std::min(n,b+chunk)));
+        }
+    //The calling thread does the first chunk
+    run(0,std::min(n,chunk));
+    for(auto& ft : futs) ft.get();
+    }
+
+template<typename Func>
+void
+parallelChunks(size_t n, Func&& f) { parallelChunks(n,n,std::forward<Func>(f)); }
+
+//x[i] *= a
+template<typename T, typename S>
+void
+scaleElements(T* x, size_t n, S a)
+    {
+    parallelChunks(n,[x,a](size_t b, size_t e)
+        {
+        for(auto i = b; i < e; ++i) x[i] *= a;
+        });
+    }
+
+//x[i] *= a for complex x and a, written out in
+//terms of reals so the compiler can vectorize it
+//(std::complex multiplication checks for NaNs)
+void inline
+scaleElements(Cplx* x, size_t n, Cplx a)
+    {
+    auto* re = reinterpret_cast<Real*>(x);
+    auto ar = a.real(),
+         ai = a.imag();
+    parallelChunks(n,[re,ar,ai](size_t b, size_t e)
+        {
+        for(auto i = 2*b; i < 2*e; i += 2)
+            {
+            auto xr = re[i],
+                 xi = re[i+1];
+            re[i] = ar*xr-ai*xi;
+            re[i+1] = ar*xi+ai*xr;
+            }
+        });
+    }
+
+//x[i] = conj(x[i])
+void inline
+conjElements(Cplx* x, size_t n)
+    {
+    //Negate the imaginary parts, as a loop
+    //over reals the compiler can vectorize
+    auto* im = reinterpret_cast<Real*>(x)+1;
+    parallelChunks(n,[im](size_t b, size_t e)
+        {
+        for(auto i = 2*b; i < 2*e; i += 2) im[i] = -im[i];
+        });
+    }
+
+//op(x[i],y[i]), as transform does for tensors
+//with the same index order
+template<typename T1, typename T2, typename Op>
+void
+transformElements(T1 const* x, T2* y, size_t n, Op op)
+    {
+    parallelChunks(n,[x,y,&op](size_t b, size_t e)
+        {
+        auto bop = op;
+        for(auto i = b; i < e; ++i) bop(x[i],y[i]);
+        });
+    }
+
+} //namespace itensor
+
+#endif
@@ -259,6 +259,13 @@ gemm(MatRefc<VA> A,
         throw std::runtime_error("mult(_add) AxB -> C: matrix C incompatible");
         }
 #endif
+    //Complex multiply-adds count as 4 real ones
+    auto m = double(nrows(A)),
+         k = double(ncols(A)),
+         n = double(ncols(B));
+    auto cfac = isCplx(C) ? 4. : 1.;
+    PROFILE_SCOPE("gemm",2.*cfac*m*n*k,
+                  sizeof(VA)*m*k+sizeof(VB)*k*n+(beta == 0 ? 1. : 2.)*sizeof(common_type<VA,VB>)*m*n)
     if(isTransposed(C))
         {
         //Do C = Bt*At instead of Ct=A*B
@@ -6,9 +6,11 @@
 #define __ITENSOR_TEN_H_
 
 #include "itensor/detail/algs.h"
+#include "itensor/detail/nestedloop.h"
 #include "itensor/tensor/teniter.h"
 #include "itensor/tensor/range.h"
 #include "itensor/tensor/lapack_wrap.h"
+#include "itensor/tensor/elementwise.h"
 
 namespace itensor {
 
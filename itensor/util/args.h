@@ -29,6 +29,10 @@ namespace itensor {
 //   looked up in the global Args object before
 //   either the default is selected or an error
 //   thrown if no default is provided.
+// o A thread can replace the global Args with its
+//   own for a while by creating a ScopedGlobalArgs,
+//   so that independent computations running on
+//   different threads do not share global values.
 // o To have a function accept Args in read-only
 //   mode, use the signature 
 //   func(T1 t1, T2 t2, ..., const Args& args = Args::global());
@@ -145,15 +149,23 @@ class Args
     operator+=(Args const& other);
 
     // Check if this is the global Args object
+    // (of the calling thread or of the process)
     bool
-    isGlobal() const { return (this == &global()); }
+    isGlobal() const { return (this == &global() || this == &processGlobal()); }
 
-    // Access the global Args object
+    // Number of named values defined in this instance
+    // (not counting those only in the global Args)
+    long
+    size() const { return vals_.size(); }
+
+    // Access the global Args object: the one installed
+    // by a ScopedGlobalArgs on the calling thread if
+    // there is one, otherwise that of the process
     static Args&
     global()
         {
-        static Args gos_;
-        return gos_;
+        auto* a = threadGlobal();
+        return a ? *a : processGlobal();
         }
 
     // Read Args object from binary
@@ -166,6 +178,22 @@ class Args
 
     private:
 
+    friend class ScopedGlobalArgs;
+
+    static Args&
+    processGlobal()
+        {
+        static Args gos_;
+        return gos_;
+        }
+
+    static Args*&
+    threadGlobal()
+        {
+        static thread_local Args* tgos_ = nullptr;
+        return tgos_;
+        }
+
     void
     processString(std::string ostring);
 
@@ -307,6 +335,39 @@ operator+(Args args, const char* ostring);
 Args
 operator+(const char* ostring, Args args);
 
+//
+// Gives the calling thread its own global Args for
+// the lifetime of this object: a copy of the global
+// Args seen when it is created, with the values in
+// args added. Changes made through Args::global()
+// or Global::args(...) on this thread then only
+// affect this copy, and other threads do not see it.
+//
+// Scopes may be nested, and must be destroyed on the
+// thread which created them.
+//
+class ScopedGlobalArgs
+    {
+    Args args_;
+    Args* prev_ = nullptr;
+    public:
+
+    explicit
+    ScopedGlobalArgs(Args const& args = Args())
+      : prev_(Args::threadGlobal())
+        {
+        args_ += Args::global();
+        args_ += args;
+        Args::threadGlobal() = &args_;
+        }
+
+    ~ScopedGlobalArgs() { Args::threadGlobal() = prev_; }
+
+    ScopedGlobalArgs(ScopedGlobalArgs const&) = delete;
+    ScopedGlobalArgs&
+    operator=(ScopedGlobalArgs const&) = delete;
+    };
+
 } //namespace itensor
 
 #endif
@@ -0,0 +1,115 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#ifndef __ITENSOR_JOBS_H
+#define __ITENSOR_JOBS_H
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+#include "itensor/global.h"
+#include "itensor/index.h"
+#include "itensor/tensor/elementwise.h"
+
+namespace itensor {
+
+//
+// Run many independent computations, such as the
+// points of a parameter sweep, on a pool of threads
+// in one process.
+//
+// runJobs(njobs,f,args) calls f(job) once for each
+// job = 0,1,...,njobs-1. The calls are spread over
+// the threads of the pool, each thread taking the next
+// job not yet started when it finishes one. Returns
+// when all jobs have finished; if a job throws, no new
+// jobs are started and its exception is rethrown.
+//
+// Every job runs with its own copy of the global Args
+// of the calling thread (see ScopedGlobalArgs), so jobs
+// can set global values without affecting each other,
+// and with the debug flags and random number generator
+// of its thread. If "Seed" is non-zero each job first
+// calls seedRNG(Seed+job) and seeds the IDs of the Index
+// objects it creates with Seed+job (see ScopedIndexIDs),
+// making the random numbers and Index IDs of a job
+// independent of the thread it runs on.
+//
+// Since the jobs already occupy all threads of the
+// pool, the element-wise loops of tensor/elementwise.h
+// and the threaded parts of toMPO run serially inside
+// jobs, and the global Args of each job have "NThread"
+// set to 1. Storage buffers are recycled through the
+// pool of each thread (see itdata/storagepool.h), so
+// jobs do not contend for it. Multithreaded BLAS should
+// be limited to one thread (for example by setting
+// OPENBLAS_NUM_THREADS=1 or MKL_NUM_THREADS=1).
+//
+// Named arguments recognized:
+//  "Threads" (default: std::thread::hardware_concurrency())
+//      Number of threads in the pool (at most njobs)
+//  "Seed" (default: 0) Seed of the random numbers of job 0
+//
+
+template <typename Func>
+void
+runJobs(int njobs,
+        Func&& f,
+        Args const& args = Args::global())
+    {
+    if(njobs <= 0) return;
+    auto nthread = int(args.getInt("Threads",int(std::thread::hardware_concurrency())));
+    nthread = std::max(1,std::min(nthread,njobs));
+    auto seed = int(args.getInt("Seed",0));
+
+    auto base = Args();
+    base += Args::global();
+    base.add("NThread",1);
+
+    std::atomic<int> next(0);
+    std::atomic<bool> failed(false);
+    auto errors = std::vector<std::exception_ptr>(nthread);
+    auto run = [&](int n)
+        {
+        auto& serial = detail::inParallelChunk();
+        auto saved_serial = serial;
+        serial = (nthread > 1);
+        try
+            {
+            while(!failed)
+                {
+                auto job = next++;
+                if(job >= njobs) break;
+                ScopedGlobalArgs scope(base);
+                ScopedIndexIDs ids(seed != 0 ? seed+job : 0);
+                if(seed != 0) seedRNG(seed+job);
+                f(job);
+                }
+            }
+        catch(...)
+            {
+            errors.at(n) = std::current_exception();
+            failed = true;
+            }
+        serial = saved_serial;
+        };
+    auto threads = std::vector<std::thread>();
+    threads.reserve(nthread-1);
+    for(int n = 1; n < nthread; ++n)
+        {
+        threads.emplace_back(run,n);
+        }
+    run(0);
+    for(auto& t : threads) t.join();
+    for(auto& e : errors)
+        {
+        if(e) std::rethrow_exception(e);
+        }
+    }
+
+} //namespace itensor
+
+#endif
@@ -0,0 +1,624 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#ifndef __ITENSOR_PARALLEL_THREADS_H
+#define __ITENSOR_PARALLEL_THREADS_H
+
+#include <sstream>
+#include <vector>
+#include <deque>
+#include <map>
+#include <tuple>
+#include <memory>
+#include <functional>
+#include <typeindex>
+#include <type_traits>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include "itensor/util/readwrite.h"
+#include "itensor/util/args.h"
+#include "itensor/tensor/elementwise.h"
+
+//
+// In-process (shared memory) backend for parallel.h
+//
+// Each "node" is a thread created by parallelRun.
+// Messages hold a reference-counted copy of the object
+// sent, so for example an ITensor is passed by sharing
+// its storage (which is copy-on-write) rather than
+// by writing and re-reading its data.
+//
+// Objects are only serialized when the type received
+// differs from the type sent, or when sending or
+// receiving a std::stringstream.
+//
+
+namespace itensor {
+
+class Environment;
+class MailBox;
+
+template <class T>
+void
+broadcast(Environment const& env, T & obj);
+
+template <class T, class... Rest>
+void
+broadcast(Environment const& env, T & obj, Rest &... rest);
+
+template <typename T>
+void
+scatterVector(Environment const& env, std::vector<T> &v);
+
+double
+sum(Environment const& env, double r);
+
+//
+// Run f(env) on nnodes threads, each having its own
+// Environment with rank 0,1,...,nnodes-1.
+// Returns when all threads have finished. If any thread
+// throws, the other threads are released from blocking
+// communication calls and the first exception is rethrown.
+//
+template <typename Func>
+void
+parallelRun(int nnodes,
+            Func&& f,
+            Args const& args = Args::global());
+
+namespace detail {
+
+struct Message
+    {
+    std::type_index type = std::type_index(typeid(void));
+    std::shared_ptr<const void> obj;
+    std::function<void(std::ostream&)> write;
+    };
+
+template <typename T>
+Message
+makeMessage(T const& obj)
+    {
+    Message m;
+    m.type = std::type_index(typeid(T));
+    auto pobj = std::make_shared<T>(obj);
+    m.write = [pobj](std::ostream& s) { itensor::write(s,*pobj); };
+    m.obj = std::move(pobj);
+    return m;
+    }
+
+//Raw bytes, as sent by send(std::stringstream)
+//and Environment::broadcast(std::stringstream);
+//its type is never equal to a received type
+inline Message
+makeStreamMessage(std::string bytes)
+    {
+    Message m;
+    auto pbytes = std::make_shared<std::string>(std::move(bytes));
+    m.write = [pbytes](std::ostream& s) { s.write(pbytes->data(),pbytes->size()); };
+    return m;
+    }
+
+template <typename T>
+void
+readMessage(Message const& m, T & obj)
+    {
+    if(m.obj && m.type == std::type_index(typeid(T)))
+        {
+        obj = *std::static_pointer_cast<const T>(m.obj);
+        return;
+        }
+    std::stringstream data;
+    m.write(data);
+    itensor::read(data,obj);
+    }
+
+class ThreadWorld
+    {
+    public:
+    using Key = std::tuple<int,int,int>;
+    private:
+    int nnodes_ = 1;
+    bool failed_ = false;
+    int bar_count_ = 0;
+    long bar_gen_ = 0;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::map<Key,std::deque<Message>> queues_;
+    public:
+
+    explicit
+    ThreadWorld(int nnodes) : nnodes_(nnodes) { }
+
+    int
+    nnodes() const { return nnodes_; }
+
+    void
+    post(int from, int to, int tag, Message m)
+        {
+            {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queues_[Key(from,to,tag)].push_back(std::move(m));
+            }
+        cond_.notify_all();
+        }
+
+    Message
+    take(int from, int to, int tag)
+        {
+        auto key = Key(from,to,tag);
+        std::unique_lock<std::mutex> lock(mutex_);
+        //Look the queue up after every wakeup: another
+        //receiver may have emptied and erased it meanwhile
+        auto it = queues_.end();
+        cond_.wait(lock,[&]
+            {
+            it = queues_.find(key);
+            return failed_ || (it != queues_.end() && !it->second.empty());
+            });
+        checkFailed();
+        auto& q = it->second;
+        auto m = std::move(q.front());
+        q.pop_front();
+        if(q.empty()) queues_.erase(it);
+        return m;
+        }
+
+    void
+    barrier()
+        {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto gen = bar_gen_;
+        if(++bar_count_ == nnodes_)
+            {
+            bar_count_ = 0;
+            ++bar_gen_;
+            cond_.notify_all();
+            return;
+            }
+        cond_.wait(lock,[gen,this]{ return failed_ || gen != bar_gen_; });
+        checkFailed();
+        }
+
+    void
+    fail()
+        {
+            {
+            std::lock_guard<std::mutex> lock(mutex_);
+            failed_ = true;
+            }
+        cond_.notify_all();
+        }
+
+    private:
+
+    void
+    checkFailed() const
+        {
+        if(failed_) throw ITError("parallelRun: another node threw an exception");
+        }
+    };
+
+} //namespace detail
+
+class Environment
+    {
+    int rank_,
+        nnodes_;
+    std::shared_ptr<detail::ThreadWorld> world_;
+    mutable std::vector<int> tags_;
+    mutable int ctag_ = 0;
+    public:
+
+    //Single-node environment, so that drivers written
+    //for MPI run unchanged (but serially)
+    Environment(int argc, char* argv[],
+                Args const& args = Args::global());
+
+    Environment(std::shared_ptr<detail::ThreadWorld> world,
+                int rank);
+
+    //
+    // Information about nodes
+    //
+
+    int
+    rank() const { return rank_; }
+
+    int
+    nnodes() const { return nnodes_; }
+
+    bool
+    firstNode() const { return rank_ == 0; }
+    bool
+    lastNode() const { return rank_ == nnodes_-1; }
+
+    int
+    lnode() const { return (rank_ == 0 ? nnodes_-1 : rank_-1); }
+    int
+    rnode() const { return (rank_ == nnodes_-1 ? 0 : rank_+1); }
+
+    //
+    // Communication and flow control
+    //
+
+    void
+    broadcast(std::stringstream& data) const;
+
+    void
+    barrier() const { world_->barrier(); }
+
+    void
+    abort(int code) const { std::cout.flush(); std::_Exit(code); }
+
+    //
+    // Backend details used by MailBox and collectives
+    //
+
+    detail::ThreadWorld&
+    world() const { return *world_; }
+
+    //Tag for the next MailBox connecting to other_node
+    int
+    newTag(int other_node) const { return ++tags_.at(other_node); }
+
+    //Tag for the next collective operation;
+    //negative so it never matches a MailBox tag
+    int
+    collectiveTag() const { return -(++ctag_); }
+
+    private:
+
+    //Make this class non-copyable
+    void operator=(Environment const&);
+    Environment(Environment const&);
+
+    public:
+
+    //Deprecated methods: kept here for backwards compatibility
+
+    template <class T>
+    void
+    broadcast(T& obj) const;
+
+    template <class T, class... Rest>
+    void
+    broadcast(T & obj, Rest &... rest) const;
+
+    };
+
+class MailBox
+    {
+    Environment const* env_;
+    int other_node_;
+    int tag_;
+    public:
+
+    MailBox();
+
+    MailBox(Environment const& env,
+            int other_node,
+            Args const& args = Args::global());
+
+    //
+    // Accessor methods
+    //
+
+    explicit operator bool() const { return env_ != nullptr; }
+
+    int
+    rank() const { checkValid(); return env_->rank(); }
+
+    int
+    nnodes() const { checkValid(); return env_->nnodes(); }
+
+    int
+    tag() const { return tag_; }
+
+    //
+    // Communication methods
+    //
+
+    template <class T>
+    void
+    receive(T& obj);
+    template <class T, typename... Args>
+    T
+    receive(Args&&... args);
+    void
+    receive(std::stringstream& data);
+
+    template <class T> void
+    send(T const& obj);
+    void
+    send(std::stringstream const& data);
+
+    template <class T>
+    void
+    broadcast(T& obj) const { checkValid(); env_->broadcast(obj); }
+
+    private:
+
+    void
+    checkValid() const
+        {
+        if(env_==nullptr) throw std::runtime_error("MailBox object is default initialized.");
+        }
+
+    detail::Message
+    take() const
+        {
+        checkValid();
+        return env_->world().take(other_node_,env_->rank(),tag_);
+        }
+
+    void
+    post(detail::Message m) const
+        {
+        checkValid();
+        env_->world().post(env_->rank(),other_node_,tag_,std::move(m));
+        }
+
+    }; //class MailBox
+
+inline Environment::
+Environment(int argc, char* argv[],
+            Args const& args)
+    : Environment(std::make_shared<detail::ThreadWorld>(1),0)
+    { }
+
+inline Environment::
+Environment(std::shared_ptr<detail::ThreadWorld> world,
+            int rank)
+    : rank_(rank),
+      nnodes_(world->nnodes()),
+      world_(std::move(world)),
+      tags_(nnodes_,0)
+    { }
+
+void inline Environment::
+broadcast(std::stringstream& data) const
+    {
+    if(nnodes_ == 1) return;
+    const int root = 0;
+    auto ctag = collectiveTag();
+    if(rank_ == root)
+        {
+        auto m = detail::makeStreamMessage(data.str());
+        for(int n = 0; n < nnodes_; ++n)
+            {
+            if(n != root) world_->post(root,n,ctag,m);
+            }
+        }
+    else
+        {
+        auto m = world_->take(root,rank_,ctag);
+        m.write(data);
+        }
+    }
+
+template <class T>
+void
+broadcast(Environment const& env, T & obj)
+    {
+    if(env.nnodes() == 1) return;
+    const int root = 0;
+    auto ctag = env.collectiveTag();
+    if(env.rank() == root)
+        {
+        //All receivers share one handle to a copy of obj
+        auto m = detail::makeMessage(obj);
+        for(int n = 0; n < env.nnodes(); ++n)
+            {
+            if(n != root) env.world().post(root,n,ctag,m);
+            }
+        }
+    else
+        {
+        detail::readMessage(env.world().take(root,env.rank(),ctag),obj);
+        }
+    }
+
+template <class T, class... Rest>
+void
+broadcast(Environment const& env, T & obj, Rest &... rest)
+    {
+    broadcast(env,obj);
+    broadcast(env,rest...);
+    }
+
+template <class T>
+void Environment::
+broadcast(T& obj) const
+    {
+    itensor::broadcast<T>(*this,obj);
+    }
+
+template <class T, class... Rest>
+void Environment::
+broadcast(T & obj, Rest &... rest) const
+    {
+    itensor::broadcast(*this,obj,rest...);
+    }
+
+template <typename T>
+void
+scatterVector(Environment const& env, std::vector<T> &v)
+    {
+    if(env.nnodes() == 1) return;
+    const int root = 0;
+
+    if(env.firstNode())
+        {
+        auto nnodes = env.nnodes();
+        auto n = v.size();
+        auto blockSizes = std::vector<long>(nnodes);
+        long blockSize = n / nnodes;
+
+        for(int i = 0; i < nnodes; i++) blockSizes[i] = blockSize;
+
+        if (n % nnodes != 0)
+            {
+            for(long i = 0; i < long(n % nnodes); i++) ++blockSizes[i];
+            }
+
+        auto itp = blockSizes[0];
+        for (int i = 1; i < nnodes; ++i)
+            {
+            MailBox mailbox(env,i);
+            mailbox.send(std::vector<T>(v.begin()+itp,v.begin()+itp+blockSizes[i]));
+            itp += blockSizes[i];
+            }
+        v.resize(blockSizes[0]);
+        }
+    else
+        {
+        MailBox mailbox(env,root);
+        mailbox.receive(v);
+        }
+    }
+
+double inline
+sum(Environment const& env, double r)
+    {
+    if(env.nnodes() == 1) return r;
+    const int root = 0;
+    auto ctag = env.collectiveTag();
+    double res = 0;
+    if(env.rank() == root)
+        {
+        res = r;
+        for(int n = 0; n < env.nnodes(); ++n)
+            {
+            if(n == root) continue;
+            double rn = 0;
+            detail::readMessage(env.world().take(n,root,ctag),rn);
+            res += rn;
+            }
+        }
+    else
+        {
+        env.world().post(env.rank(),root,ctag,detail::makeMessage(r));
+        }
+    return res;
+    }
+
+template <typename Func>
+void
+parallelRun(int nnodes,
+            Func&& f,
+            Args const& args)
+    {
+    if(nnodes < 1) throw std::runtime_error("parallelRun: nnodes must be at least 1");
+    auto world = std::make_shared<detail::ThreadWorld>(nnodes);
+    auto errors = std::vector<std::exception_ptr>(nnodes);
+    //Like separate processes, each node starts
+    //with its own copy of the global Args
+    auto base = Args();
+    base += Args::global();
+    auto run = [&](int rank)
+        {
+        //Nodes already run in parallel, so loops
+        //inside them do not start more threads
+        auto& serial = detail::inParallelChunk();
+        auto saved_serial = serial;
+        serial = (nnodes > 1);
+        try
+            {
+            ScopedGlobalArgs scope(base);
+            Environment env(world,rank);
+            f(env);
+            }
+        catch(...)
+            {
+            errors.at(rank) = std::current_exception();
+            world->fail();
+            }
+        serial = saved_serial;
+        };
+    auto threads = std::vector<std::thread>();
+    threads.reserve(nnodes-1);
+    for(int rank = 1; rank < nnodes; ++rank)
+        {
+        threads.emplace_back(run,rank);
+        }
+    run(0);
+    for(auto& t : threads) t.join();
+    for(auto& e : errors)
+        {
+        if(e) std::rethrow_exception(e);
+        }
+    }
+
+//
+// MailBox
+//
+
+
+inline MailBox::
+MailBox()
+    :
+    env_(nullptr),
+    other_node_(-1),
+    tag_(0)
+    {
+    }
+
+inline MailBox::
+MailBox(Environment const& env,
+        int other_node,
+        Args const& args)
+    :
+    env_(&env),
+    other_node_(other_node),
+    tag_(0)
+    {
+    if(other_node_ < 0 || other_node_ >= env_->nnodes())
+        {
+        std::cout << "\n\nNode " << env_->rank() << ": other_node = " << other_node_ << " out of range." << std::endl;
+        throw std::runtime_error("other_node out of range");
+        }
+    tag_ = env_->newTag(other_node_);
+    }
+
+void inline MailBox::
+receive(std::stringstream& data)
+    {
+    take().write(data);
+    }
+
+template <class T>
+void MailBox::
+receive(T& obj)
+    {
+    detail::readMessage(take(),obj);
+    }
+
+template <class T, typename... Args>
+T MailBox::
+receive(Args&&... args)
+    {
+    T obj(std::forward<Args>(args)...);
+    detail::readMessage(take(),obj);
+    return obj;
+    }
+
+void inline MailBox::
+send(std::stringstream const& data)
+    {
+    post(detail::makeStreamMessage(data.str()));
+    }
+
+template <class T>
+void inline MailBox::
+send(T const& obj)
+    {
+    post(detail::makeMessage(obj));
+    }
+
+} //namespace itensor
+
+#endif
@@ -0,0 +1,399 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include "itensor/util/profile.h"
+#include "itensor/util/print.h"
+#include "itensor/util/range.h"
+
+namespace itensor {
+
+using clock_type = std::chrono::steady_clock;
+
+namespace detail {
+
+struct ProfileNode
+    {
+    const char* name = "";
+    ProfileNode* parent = nullptr;
+    std::vector<std::unique_ptr<ProfileNode>> children;
+    long count = 0;
+    double time = 0,
+           flops = 0,
+           bytes = 0;
+
+    ProfileNode() { }
+
+    ProfileNode(const char* name_, ProfileNode* parent_)
+      : name(name_),
+        parent(parent_)
+        { }
+
+    ProfileNode*
+    child(const char* cname)
+        {
+        //Names are usually string literals, so
+        //compare pointers before contents
+        for(auto& c : children) if(c->name == cname) return c.get();
+        for(auto& c : children) if(std::strcmp(c->name,cname) == 0) return c.get();
+        children.emplace_back(new ProfileNode(cname,this));
+        return children.back().get();
+        }
+
+    void
+    clear()
+        {
+        count = 0;
+        time = flops = bytes = 0;
+        for(auto& c : children) c->clear();
+        }
+    };
+
+struct ProfileEvent
+    {
+    const char* name;
+    double start; //microseconds since profileEpoch
+    double dur;
+    double flops;
+    double bytes;
+    };
+
+struct ProfileThread
+    {
+    int id = 0;
+    ProfileNode root;
+    ProfileNode* current = &root;
+    std::vector<ProfileEvent> events;
+    long dropped = 0;
+    };
+
+struct ProfileRegistry
+    {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ProfileThread>> threads;
+    clock_type::time_point epoch = clock_type::now();
+    };
+
+ProfileRegistry&
+profileRegistry()
+    {
+    static ProfileRegistry registry_;
+    return registry_;
+    }
+
+//Thread data is owned by the registry so
+//it outlives the thread that recorded it
+ProfileThread&
+profileThread()
+    {
+    thread_local std::shared_ptr<ProfileThread> thread_;
+    if(!thread_)
+        {
+        auto& reg = profileRegistry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        thread_ = std::make_shared<ProfileThread>();
+        thread_->id = reg.threads.size();
+        reg.threads.push_back(thread_);
+        }
+    return *thread_;
+    }
+
+ProfileRegion
+toRegion(ProfileNode const& n)
+    {
+    auto R = ProfileRegion(n.name);
+    R.count = n.count;
+    R.time = n.time;
+    R.flops = n.flops;
+    R.bytes = n.bytes;
+    for(auto& c : n.children)
+        {
+        if(c->count > 0) R.children.push_back(toRegion(*c));
+        }
+    return R;
+    }
+
+void
+merge(ProfileRegion & to, ProfileRegion const& from)
+    {
+    to.count += from.count;
+    to.time += from.time;
+    to.flops += from.flops;
+    to.bytes += from.bytes;
+    for(auto& fc : from.children)
+        {
+        auto it = std::find_if(to.children.begin(),to.children.end(),
+                               [&fc](ProfileRegion const& tc) { return tc.name == fc.name; });
+        if(it == to.children.end())
+            {
+            to.children.push_back(fc);
+            }
+        else
+            {
+            merge(*it,fc);
+            }
+        }
+    }
+
+void
+sumChildren(ProfileRegion & R)
+    {
+    R.time = R.flops = R.bytes = 0;
+    for(auto& c : R.children)
+        {
+        R.time += c.time;
+        R.flops += c.flops;
+        R.bytes += c.bytes;
+        }
+    }
+
+void
+writeEscaped(std::ostream& s, std::string const& str)
+    {
+    s << '"';
+    for(auto c : str)
+        {
+        if(c == '"' || c == '\\') s << '\\';
+        s << c;
+        }
+    s << '"';
+    }
+
+void
+writeRegionJSON(std::ostream& s, ProfileRegion const& R)
+    {
+    s << "{\"name\":";
+    writeEscaped(s,R.name);
+    s << format(",\"count\":%d,\"time\":%.9g,\"flops\":%.9g,\"bytes\":%.9g,\"children\":[",
+                R.count,R.time,R.flops,R.bytes);
+    for(auto n : range(R.children))
+        {
+        if(n > 0) s << ",";
+        writeRegionJSON(s,R.children[n]);
+        }
+    s << "]}";
+    }
+
+void
+printRegion(std::ostream& s, ProfileRegion const& R, int depth, double total)
+    {
+    auto name = std::string(2*depth,' ')+R.name;
+    auto pct = total > 0 ? 100*R.time/total : 0.;
+    auto gflops = R.time > 0 ? 1E-9*R.flops/R.time : 0.;
+    auto gbytes = R.time > 0 ? 1E-9*R.bytes/R.time : 0.;
+    s << format("\n%-30s %10d %12.4f %6.1f%% %10.3f %10.3f",name,R.count,R.time,pct,gflops,gbytes);
+    for(auto& c : R.children) printRegion(s,c,depth+1,total);
+    }
+
+//Writes profiling output on exit when requested
+//by the ITENSOR_PROFILE and ITENSOR_PROFILE_JSON
+//environment variables
+struct ProfileFromEnv
+    {
+    std::string trace_file,
+                json_file;
+
+    ProfileFromEnv()
+        {
+        //Construct registry first so it is destroyed after us
+        profileRegistry();
+        if(auto f = std::getenv("ITENSOR_PROFILE")) trace_file = f;
+        if(auto f = std::getenv("ITENSOR_PROFILE_JSON")) json_file = f;
+        if(!trace_file.empty() || !json_file.empty()) profiling() = true;
+        }
+
+    ~ProfileFromEnv()
+        {
+        if(!trace_file.empty())
+            {
+            std::ofstream f(trace_file);
+            writeChromeTrace(f);
+            }
+        if(!json_file.empty())
+            {
+            std::ofstream f(json_file);
+            writeProfileJSON(f);
+            }
+        }
+    };
+
+ProfileFromEnv profile_from_env_;
+
+} //namespace detail
+
+bool&
+profileTrace()
+    {
+    static bool trace_ = true;
+    return trace_;
+    }
+
+long&
+profileMaxEvents()
+    {
+    static long max_events_ = 1000000;
+    return max_events_;
+    }
+
+void ProfileScope::
+begin(const char* name, double flops, double bytes)
+    {
+    auto& T = detail::profileThread();
+    node_ = T.current->child(name);
+    T.current = node_;
+    flops_ = flops;
+    bytes_ = bytes;
+    start_ = clock_type::now();
+    }
+
+void ProfileScope::
+end()
+    {
+    auto stop = clock_type::now();
+    auto& T = detail::profileThread();
+    auto dur = std::chrono::duration<double>(stop-start_).count();
+    node_->count += 1;
+    node_->time += dur;
+    node_->flops += flops_;
+    node_->bytes += bytes_;
+    T.current = node_->parent;
+    if(profileTrace())
+        {
+        if(long(T.events.size()) < profileMaxEvents())
+            {
+            auto& epoch = detail::profileRegistry().epoch;
+            auto us = std::chrono::duration<double,std::micro>(start_-epoch).count();
+            T.events.push_back({node_->name,us,1E6*dur,flops_,bytes_});
+            }
+        else
+            {
+            T.dropped += 1;
+            }
+        }
+    node_ = nullptr;
+    }
+
+double ProfileRegion::
+selfTime() const
+    {
+    auto t = time;
+    for(auto& c : children) t -= c.time;
+    return t;
+    }
+
+ProfileRegion const* ProfileRegion::
+find(std::string const& path) const
+    {
+    auto slash = path.find('/');
+    auto first = path.substr(0,slash);
+    for(auto& c : children) if(c.name == first)
+        {
+        if(slash == std::string::npos) return &c;
+        return c.find(path.substr(slash+1));
+        }
+    return nullptr;
+    }
+
+std::vector<ProfileRegion>
+profileThreads()
+    {
+    auto& reg = detail::profileRegistry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    auto res = std::vector<ProfileRegion>();
+    for(auto& T : reg.threads)
+        {
+        auto R = detail::toRegion(T->root);
+        R.name = format("thread %d",T->id);
+        detail::sumChildren(R);
+        res.push_back(std::move(R));
+        }
+    return res;
+    }
+
+ProfileRegion
+profileRegions()
+    {
+    auto R = ProfileRegion("all threads");
+    for(auto& T : profileThreads()) detail::merge(R,T);
+    R.count = 0;
+    detail::sumChildren(R);
+    return R;
+    }
+
+void
+profileReset()
+    {
+    auto& reg = detail::profileRegistry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    //Keep the nodes themselves since open scopes
+    //may still refer to them
+    for(auto& T : reg.threads)
+        {
+        T->root.clear();
+        T->events.clear();
+        T->dropped = 0;
+        }
+    reg.epoch = clock_type::now();
+    }
+
+void
+writeProfileJSON(std::ostream& s)
+    {
+    s << "{\"threads\":[";
+    auto threads = profileThreads();
+    for(auto n : range(threads))
+        {
+        if(n > 0) s << ",\n";
+        detail::writeRegionJSON(s,threads[n]);
+        }
+    s << "]}\n";
+    }
+
+void
+writeChromeTrace(std::ostream& s)
+    {
+    auto& reg = detail::profileRegistry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    s << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for(auto& T : reg.threads)
+        {
+        if(!first) s << ",";
+        first = false;
+        s << format("\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,"
+                    "\"args\":{\"name\":\"thread %d\"}}",T->id,T->id);
+        for(auto& e : T->events)
+            {
+            s << ",\n{\"name\":";
+            detail::writeEscaped(s,e.name);
+            s << format(",\"ph\":\"X\",\"pid\":0,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,"
+                        "\"args\":{\"flops\":%.9g,\"bytes\":%.9g}}",
+                        T->id,e.start,e.dur,e.flops,e.bytes);
+            }
+        if(T->dropped > 0)
+            {
+            s << format(",\n{\"name\":\"%d events dropped\",\"ph\":\"i\",\"s\":\"t\","
+                        "\"pid\":0,\"tid\":%d,\"ts\":0}",T->dropped,T->id);
+            }
+        }
+    s << "\n]}\n";
+    }
+
+std::ostream&
+operator<<(std::ostream& s, ProfileRegion const& R)
+    {
+    s << "-----------------------------------------------------------------------------------";
+    s << format("\n%-30s %10s %12s %7s %10s %10s","Region","Count","Time (s)","%","GFLOP/s","GB/s");
+    for(auto& c : R.children) detail::printRegion(s,c,0,R.time);
+    s << "\n-----------------------------------------------------------------------------------";
+    return s;
+    }
+
+} //namespace itensor
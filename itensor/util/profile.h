@@ -0,0 +1,177 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#ifndef __ITENSOR_PROFILE_H
+#define __ITENSOR_PROFILE_H
+
+#include <chrono>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+//
+// Named, hierarchical profiling scopes which are
+// switched on at runtime:
+//
+//   PROFILE_SCOPE("contract")
+//   PROFILE_SCOPE("gemm",flops,bytes)
+//
+// A scope opened while another is active on the same
+// thread becomes its child, so each thread records a
+// tree of regions with call counts, wall time,
+// flop counts and bytes moved.
+//
+// Names should be string literals since only
+// the pointer is stored.
+//
+// When profiling() is false (the default) a scope
+// costs a single branch.
+//
+// Profiling can be turned on without recompiling by
+// setting environment variables before running:
+//   ITENSOR_PROFILE=file       writes a Chrome trace
+//                              (chrome://tracing) on exit
+//   ITENSOR_PROFILE_JSON=file  writes the region tree
+//                              as JSON on exit
+//
+
+#define PROFILE_CONCAT_IMPL(A,B) A##B
+#define PROFILE_CONCAT(A,B) PROFILE_CONCAT_IMPL(A,B)
+#define PROFILE_SCOPE(...) itensor::ProfileScope PROFILE_CONCAT(profile_scope_instance_,__LINE__)(__VA_ARGS__);
+
+namespace itensor {
+
+namespace detail {
+struct ProfileNode;
+}
+
+//Runtime switch for all profiling scopes
+inline bool&
+profiling()
+    {
+    static bool profiling_ = false;
+    return profiling_;
+    }
+
+//Whether to also record individual scope
+//begin/end events for the Chrome trace output
+//(region totals are always recorded)
+bool&
+profileTrace();
+
+//Maximum number of trace events kept per thread;
+//later events are dropped but still counted
+//in the region totals
+long&
+profileMaxEvents();
+
+class ProfileScope
+    {
+    using clock_type = std::chrono::steady_clock;
+    detail::ProfileNode* node_ = nullptr;
+    clock_type::time_point start_;
+    double flops_ = 0,
+           bytes_ = 0;
+    public:
+
+    explicit
+    ProfileScope(const char* name,
+                 double flops = 0,
+                 double bytes = 0)
+        {
+        if(profiling()) begin(name,flops,bytes);
+        }
+
+    ProfileScope(ProfileScope const&) = delete;
+
+    ProfileScope&
+    operator=(ProfileScope const&) = delete;
+
+    ~ProfileScope()
+        {
+        if(node_) end();
+        }
+
+    bool
+    active() const { return node_ != nullptr; }
+
+    //Add to the work attributed to this scope
+    //(useful when it is only known at the end)
+    void
+    addFlops(double f) { flops_ += f; }
+
+    void
+    addBytes(double b) { bytes_ += b; }
+
+    private:
+
+    void
+    begin(const char* name, double flops, double bytes);
+
+    void
+    end();
+    };
+
+//
+// Region totals, as returned by profileRegions()
+//
+struct ProfileRegion
+    {
+    std::string name;
+    long count = 0;
+    double time = 0; //wall time in seconds, including children
+    double flops = 0;
+    double bytes = 0;
+    std::vector<ProfileRegion> children;
+
+    ProfileRegion() { }
+
+    explicit
+    ProfileRegion(std::string name_) : name(std::move(name_)) { }
+
+    //Wall time not spent in child regions
+    double
+    selfTime() const;
+
+    //Returns a pointer to the child region (or
+    //descendant, for a path "contract/gemm")
+    //with the given name, or nullptr if none
+    ProfileRegion const*
+    find(std::string const& path) const;
+    };
+
+//Region tree of each thread which has recorded
+//profiling data, in the order threads first
+//entered a profiling scope. The root of each
+//tree is named "thread N"; its time is the sum
+//of its top-level regions.
+std::vector<ProfileRegion>
+profileThreads();
+
+//Region trees of all threads merged by name
+ProfileRegion
+profileRegions();
+
+//Clear all recorded data, keeping profiling()
+//on or off. Should not be called while other
+//threads are inside profiling scopes.
+void
+profileReset();
+
+//Region trees of all threads as JSON
+void
+writeProfileJSON(std::ostream& s);
+
+//Recorded events in the Chrome trace event format,
+//viewable in chrome://tracing or Perfetto
+void
+writeChromeTrace(std::ostream& s);
+
+//Prints the merged region tree as a table
+std::ostream&
+operator<<(std::ostream& s, ProfileRegion const& R);
+
+} //namespace itensor
+
+#endif
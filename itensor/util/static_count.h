@@ -1,6 +1,7 @@
 #ifndef __ITENSOR_STATIC_COUNT_H__
 #define __ITENSOR_STATIC_COUNT_H__
 
+#include <atomic>
 #include "itensor/util/print.h"
 
 namespace itensor {
@@ -13,17 +14,21 @@ namespace itensor {
 //    //will automatically print "Incremented ## times"
 //    //when program ends
 //
+//  The count may be incremented from several threads.
+//
 
 struct StaticCount
     {
-    long count = 0;
+    std::atomic<long> count;
     const char* fstring = "";
 
-    StaticCount(const char* fstring_) : fstring(fstring_) { }
+    StaticCount(const char* fstring_) : count(0), fstring(fstring_) { }
+
+    StaticCount(StaticCount const& other) : count(other.count.load()), fstring(other.fstring) { }
 
     ~StaticCount()
         {
-        printfln(fstring,count);
+        printfln(fstring,count.load());
         }
 
     void
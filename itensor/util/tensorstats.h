@@ -6,6 +6,7 @@
 #define __ITENSOR_TENSORSTATS_H
 
 #include <cmath>
+#include <mutex>
 #include "itensor/util/stdx.h"
 #include "itensor/util/print.h"
 #include "itensor/itensor_interface.h"
@@ -99,11 +100,21 @@ global_tstats()
     return gts;
     }
 
+inline std::mutex&
+tstats_mutex()
+    {
+    static std::mutex m;
+    return m;
+    }
+
+//Safe to call from several threads
 template<typename... VArgs>
 void
 tstats(VArgs&&... vargs)
     {
-    global_tstats().emplace_back(std::forward<VArgs&&>(vargs)...);
+    auto ts = TStats(std::forward<VArgs&&>(vargs)...);
+    std::lock_guard<std::mutex> lock(tstats_mutex());
+    global_tstats().push_back(ts);
     }
 
 inline std::ostream&
@@ -5,10 +5,17 @@
 #ifndef __ITENSOR_TIMERS_H
 #define __ITENSOR_TIMERS_H
 
+#include <array>
 #include <chrono>
 #include <cmath>
+#include <mutex>
 #include "itensor/util/stdx.h"
 #include "itensor/util/print.h"
+#include "itensor/util/profile.h"
+
+//Library code uses the named runtime scopes
+//of profile.h; the numbered timers below are
+//kept for timing user code
 
 //#define COLLECT_TIMES
 
@@ -86,6 +93,19 @@ struct Timers
     void
     printOnExit(bool val) { print_on_exit_ = val; }
 
+    //Adds the times and counts of T
+    Timers&
+    operator+=(Timers const& T)
+        {
+        for(size_type n = 0; n < NTimer; ++n)
+            {
+            timer_[n] += T.timer_[n];
+            timer2_[n] += T.timer2_[n];
+            count_[n] += T.count_[n];
+            }
+        return *this;
+        }
+
     size_type constexpr
     size() const { return NTimer; }
 
@@ -148,11 +168,45 @@ struct Timers
 
     };
 
+namespace detail {
+
+//Times of all threads, added in as each thread
+//exits and printed once at the end of the program
+inline GlobalTimer &
+mergedTimers()
+    {
+    static GlobalTimer merged_(true);
+    return merged_;
+    }
+
+inline std::mutex &
+mergedTimersMutex()
+    {
+    static std::mutex m;
+    return m;
+    }
+
+struct ThreadTimers
+    {
+    GlobalTimer T;
+    //Creates the merged timers first, so they
+    //are destroyed after those of every thread
+    ThreadTimers() { mergedTimers(); mergedTimersMutex(); }
+    ~ThreadTimers()
+        {
+        std::lock_guard<std::mutex> lock(mergedTimersMutex());
+        mergedTimers() += T;
+        }
+    };
+
+} //namespace detail
+
+//Timers of the calling thread
 inline GlobalTimer & 
 timers()
     {
-    static GlobalTimer timers_(true);
-    return timers_;
+    static thread_local detail::ThreadTimers timers_;
+    return timers_.T;
     }
 
 struct ScopedTimer
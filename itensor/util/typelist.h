@@ -7,8 +7,6 @@
 
 //
 // Ideas for improvement:
-// o Add indexOf (returns index of type T if containsType<TList,T>==true,
-//   such that getType<TList,indexOf<TList,T>()> == T)
 // o Add insert
 //
 
@@ -156,6 +154,33 @@ struct GetType<TL,n,false>
 template<typename TList, size_t n>
 using getType = typename detail::GetType<TList,n,n < TList::size()>::Result;
 
+namespace detail {
+template<typename TL, typename T>
+struct IndexOf
+    {
+    static constexpr int next = IndexOf<popFront<TL>,T>::value;
+    static constexpr int value = std::is_same<frontType<TL>,T>::value 
+                               ? 0
+                               : (next < 0 ? -1 : 1+next);
+    };
+template<typename T>
+struct IndexOf<TypeList<>,T>
+    {
+    static constexpr int value = -1;
+    };
+} //namespace detail
+
+//
+// indexOf
+//
+// Position of type T in TList, such that
+// getType<TList,indexOf<TList,T>()> == T
+// (equals -1 if T is not in TList)
+//
+template<typename TList, typename T>
+constexpr int
+indexOf() { return detail::IndexOf<TList,T>::value; }
+
 } //namespace itensor
 
 #endif
@@ -0,0 +1,84 @@
+#include <chrono>
+#include "itensor/all.h"
+#include "itensor/util/jobs.h"
+
+using namespace itensor;
+
+//
+// Ground state energy of the J1-J2 Heisenberg chain
+// for many values of J2, each J2 being a separate DMRG
+// job. The jobs run at the same time on a pool of
+// threads, so one process can use all cores of a node.
+//
+// Usage: dmrg_jobs [nthreads] [njobs]
+//
+// For the jobs to scale with the number of threads,
+// limit BLAS to one thread, e.g. OPENBLAS_NUM_THREADS=1
+//
+
+int
+main(int argc, char* argv[])
+    {
+    int nthreads = (argc > 1) ? std::atoi(argv[1]) : int(std::thread::hardware_concurrency());
+    int njobs = (argc > 2) ? std::atoi(argv[2]) : 16;
+    int N = 40;
+
+    //
+    // The site set is shared (read-only) by all jobs
+    //
+    auto sites = SpinHalf(N);
+
+    auto J2s = std::vector<Real>(njobs);
+    for(auto n : range(njobs)) J2s[n] = 0.5*n/std::max(1,njobs-1);
+    auto energies = std::vector<Real>(njobs);
+
+    auto start = std::chrono::steady_clock::now();
+
+    runJobs(njobs,[&](int job)
+        {
+        auto J2 = J2s[job];
+
+        auto ampo = AutoMPO(sites);
+        for(int j = 1; j < N; ++j)
+            {
+            ampo += 0.5,"S+",j,"S-",j+1;
+            ampo += 0.5,"S-",j,"S+",j+1;
+            ampo +=     "Sz",j,"Sz",j+1;
+            }
+        for(int j = 1; j < N-1; ++j)
+            {
+            ampo += 0.5*J2,"S+",j,"S-",j+2;
+            ampo += 0.5*J2,"S-",j,"S+",j+2;
+            ampo +=     J2,"Sz",j,"Sz",j+2;
+            }
+        auto H = IQMPO(ampo);
+
+        auto state = InitState(sites);
+        for(int i = 1; i <= N; ++i)
+            state.set(i,(i%2==1 ? "Up" : "Dn"));
+        auto psi = IQMPS(state);
+
+        auto sweeps = Sweeps(5);
+        sweeps.maxm() = 10,20,40,80,80;
+        sweeps.cutoff() = 1E-9;
+        sweeps.niter() = 2;
+        sweeps.noise() = 1E-7,1E-8,0.0;
+
+        //Global args set here only affect this job
+        Global::args("Quiet",true);
+
+        energies[job] = dmrg(psi,H,sweeps);
+        },
+        Args("Threads",nthreads,"Seed",1));
+
+    std::chrono::duration<double> time = std::chrono::steady_clock::now()-start;
+
+    println("\n    J2        Energy");
+    for(auto n : range(njobs))
+        {
+        printfln("%6.3f  %.10f",J2s[n],energies[n]);
+        }
+    printfln("\n%d jobs on %d threads: %.2f s",njobs,nthreads,time.count());
+
+    return 0;
+    }
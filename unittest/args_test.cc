@@ -1,5 +1,6 @@
 #include "test.h"
 
+#include <thread>
 #include "itensor/global.h"
 
 using namespace std;
@@ -160,5 +161,32 @@ SECTION("Read/Write")
     CHECK(o2.getString("Name") == "name");
     }
 
-}
+SECTION("ScopedGlobalArgs")
+    {
+    Global::args("ScopeTest",1);
+        {
+        ScopedGlobalArgs scope(Args("ScopeOnly",true));
+        CHECK(Args::global().getInt("ScopeTest") == 1);
+        CHECK(Args::global().getBool("ScopeOnly"));
+        Global::args("ScopeTest",2);
+        CHECK(Args().getInt("ScopeTest") == 2);
+
+        //Other threads keep seeing the process-wide values
+        int other = 0;
+        auto t = std::thread([&other] { other = Args::global().getInt("ScopeTest"); });
+        t.join();
+        CHECK(other == 1);
+
+            {
+            ScopedGlobalArgs inner;
+            Global::args("ScopeTest",3);
+            CHECK(Args::global().getInt("ScopeTest") == 3);
+            }
+        CHECK(Args::global().getInt("ScopeTest") == 2);
+        }
+    CHECK(Args::global().getInt("ScopeTest") == 1);
+    CHECK(!Args::global().defined("ScopeOnly"));
+    Args::global().remove("ScopeTest");
+    }
 
+}
@@ -621,4 +621,57 @@ SECTION("Spinless")
     }
 
 
+SECTION("Batch Add and NThread")
+    {
+    auto N = 6;
+    auto sites = Spinless(N);
+    auto terms = std::vector<HTerm>{};
+    for(auto i : range1(N))
+    for(auto j : range1(N))
+        {
+        auto h = HTerm(0.1*i-0.07*j,{});
+        h.add("Cdag",i);
+        h.add("C",j);
+        terms.push_back(h);
+        }
+    for(auto i : range1(N-1))
+        {
+        auto h = HTerm(0.3+0.1*i,{});
+        h.add("N",i);
+        h.add("N",i+1);
+        terms.push_back(h);
+        }
+    //Duplicate of a term above
+    terms.push_back(terms.front());
+
+    auto ampo1 = AutoMPO(sites);
+    for(auto& h : terms) ampo1.add(h);
+    auto ampo2 = AutoMPO(sites);
+    ampo2.add(std::vector<HTerm>(terms.begin(),terms.begin()+10));
+    ampo2.add(std::vector<HTerm>(terms.begin()+10,terms.end()));
+    CHECK(ampo1.size() == ampo2.size());
+    auto it2 = ampo2.terms().begin();
+    for(auto& h : ampo1.terms())
+        {
+        CHECK(h.ops == it2->ops);
+        CHECK(abs(h.coef-it2->coef) < 1E-12);
+        ++it2;
+        }
+
+    auto H1 = toMPO<IQTensor>(ampo1,{"Exact",false,"NThread",1});
+    auto H3 = toMPO<IQTensor>(ampo2,{"Exact",false,"NThread",3});
+    auto state = InitState(sites,"Emp");
+    state.set(2,"Occ");
+    state.set(3,"Occ");
+    state.set(5,"Occ");
+    auto psi = IQMPS(state);
+    auto state2 = state;
+    state2.set(5,"Emp");
+    state2.set(6,"Occ");
+    auto psi2 = IQMPS(state2);
+    CHECK_CLOSE(overlap(psi,H1,psi),overlap(psi,H3,psi));
+    CHECK_CLOSE(overlap(psi2,H1,psi),overlap(psi2,H3,psi));
+    CHECK_CLOSE(overlap(psi2,H1,psi),0.6-0.35);
+    }
+
 }
@@ -1,6 +1,7 @@
 #include "test.h"
-#include "bondgate.h"
-#include "sites/spinhalf.h"
+#include "itensor/mps/bondgate.h"
+#include "itensor/mps/tevol.h"
+#include "itensor/mps/sites/spinhalf.h"
 
 using std::vector;
 using namespace itensor;
@@ -35,11 +36,11 @@ SECTION("SwapGate")
     {
     Gate sw12(sites,1,2);
     ITensor id = multSiteOps(sw12.gate(),sw12.gate());
-    CHECK((id-sites.op("Id",1)*sites.op("Id",2)).norm() < 1E-12);
+    CHECK(norm(id-toITensor(sites.op("Id",1)*sites.op("Id",2))) < 1E-12);
 
     IQGate qsw12(sites,1,2);
     IQTensor qid = multSiteOps(qsw12.gate(),qsw12.gate());
-    CHECK((qid-sites.op("Id",1)*sites.op("Id",2)).norm() < 1E-12);
+    CHECK(norm(qid-sites.op("Id",1)*sites.op("Id",2)) < 1E-12);
     }
 
 SECTION("ImagTimeGates")
@@ -99,3 +100,67 @@ SECTION("RealTimeGate")
     }
 
 }
+
+TEST_CASE("TrotterGates")
+{
+const int N = 8;
+SpinHalf sites(N);
+
+auto H = vector<ITensor>(N);
+for(int b = 1; b < N; ++b)
+    {
+    H.at(b) =  sites.op("Sz",b)*sites.op("Sz",b+1);
+    H.at(b) += sites.op("Sm",b)*sites.op("Sp",b+1) * 0.5;
+    H.at(b) += sites.op("Sp",b)*sites.op("Sm",b+1) * 0.5;
+    }
+
+auto state = InitState(sites);
+for(int j = 1; j <= N; ++j) state.set(j,j%2==1 ? "Up" : "Dn");
+
+auto args = Args("Cutoff",1E-14,"Maxm",500,"ShowPercent",false);
+const Real tstep = 0.1,
+           ttotal = 1.;
+
+SECTION("Fused Gates")
+    {
+    auto T2 = Trotter(sites,H,Gate::tImag,tstep);
+    CHECK(T2.order() == 2);
+    CHECK(T2.size() == size_t(2*N-3));
+    CHECK(T2.numExponentials() == N-1);
+
+    //The exponentials agree with BondGate's
+    auto g = Gate(sites,1,2,Gate::tImag,tstep/2,H.at(1));
+    CHECK(norm(T2.front().gate()-g.gate()) < 1E-12);
+
+    auto T4 = Trotter(sites,H,Gate::tImag,tstep,{"Order",4});
+    CHECK(T4.size() == size_t(10*N-19));
+
+    //Same state as from the unfused second order gates
+    auto gates = vector<Gate>{};
+    for(int b = 1; b < N; ++b) gates.push_back(Gate(sites,b,b+1,Gate::tImag,tstep/2,H.at(b)));
+    for(int b = N-1; b >= 1; --b) gates.push_back(Gate(sites,b,b+1,Gate::tImag,tstep/2,H.at(b)));
+
+    auto psi1 = MPS(state);
+    gateTEvol(gates,ttotal,tstep,psi1,args);
+    auto psi2 = MPS(state);
+    gateTEvol(T2,ttotal,tstep,psi2,args);
+    CHECK(std::fabs(overlap(psi1,psi2)-1.) < 1E-10);
+    }
+
+SECTION("Fourth Order")
+    {
+    auto exact = MPS(state);
+    gateTEvol(Trotter(sites,H,Gate::tReal,tstep/10,{"Order",4}),ttotal,tstep/10,exact,args);
+
+    auto error = [&](int order)
+        {
+        auto psi = MPS(state);
+        gateTEvol(Trotter(sites,H,Gate::tReal,tstep,{"Order",order}),ttotal,tstep,psi,args);
+        return 1.-std::abs(overlapC(exact,psi));
+        };
+    auto err2 = error(2),
+         err4 = error(4);
+    CHECK(err2 > 1E-8);
+    CHECK(err4 < err2/100);
+    }
+}
@@ -231,6 +231,35 @@ SECTION("IQTensor denmatDecomp")
             CHECK(eig >= 0.);
             }
         }
+
+    SECTION("Test 2")
+        {
+        //Indices to combine are adjacent on AA but in
+        //the opposite order on the tensors A1 and A2
+        IQIndex S1("S1",Index("s1+",1,Site),QN(+1),
+                        Index("s1-",1,Site),QN(-1));
+        IQIndex S2("S2",Index("s2+",1,Site),QN(+1),
+                        Index("s2-",1,Site),QN(-1));
+        IQIndex L1("L1",Index("l1+1",3),QN(+1),
+                        Index("l1 0",4),QN( 0),
+                        Index("l1-1",3),QN(-1));
+        IQIndex L2("L2",Index("l2+2",2),QN(+2),
+                        Index("l2 0",6),QN( 0),
+                        Index("l2-2",2),QN(-2));
+
+        auto AA = randomTensor(QN(),S1,L1,L2,S2);
+        AA *= 1./norm(AA);
+        auto mid = IQIndex("mid",Index("mid",1),QN());
+        auto A1 = IQTensor(L1,S1,mid),
+             A2 = IQTensor(dag(mid),S2,L2);
+        denmatDecomp(AA,A1,A2,Fromleft);
+        CHECK(hasindex(A1,L1));
+        CHECK(hasindex(A1,S1));
+        CHECK(norm(AA-A1*A2) < 1E-11);
+
+        denmatDecomp(AA,A1,A2,Fromright);
+        CHECK(norm(AA-A1*A2) < 1E-11);
+        }
     }
 
 SECTION("ITensor diagHermitian")
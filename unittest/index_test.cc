@@ -1,4 +1,5 @@
 #include "test.h"
+#include <set>
 #include "itensor/index.h"
 #include "itensor/util/print_macro.h"
 
@@ -70,4 +71,47 @@ TEST_CASE("IndexTest")
         CHECK(i2.type() == i.type());
         CHECK(i2.primeLevel() == 0);
         }
+    
+    SECTION("Seeded IDs")
+        {
+        auto ids = [](unsigned long seed)
+            {
+            ScopedIndexIDs scope(seed);
+            auto res = std::vector<Index::id_type>{};
+            for(int n = 0; n < 100; ++n) res.push_back(Index("i").id());
+            return res;
+            };
+        auto a = ids(5),
+             b = ids(5),
+             c = ids(6);
+        CHECK(a == b);
+        auto all = std::set<Index::id_type>(a.begin(),a.end());
+        all.insert(c.begin(),c.end());
+        CHECK(all.size() == 200);
+        CHECK(all.count(0) == 0);
+
+        //Default IDs resume after the scope
+        auto j = Index("j");
+        CHECK(j);
+        CHECK(all.count(j.id()) == 0);
+        }
+
+    SECTION("Unique IDs Across Threads")
+        {
+        int nthread = 4,
+            nid = 3*int(Index::IDGenerator::blockSize)/2;
+        auto ids = std::vector<std::vector<Index::id_type>>(nthread);
+        auto threads = std::vector<std::thread>{};
+        for(auto t : range(nthread))
+            {
+            threads.emplace_back([&ids,t,nid]
+                {
+                for(int n = 0; n < nid; ++n) ids[t].push_back(Index("i").id());
+                });
+            }
+        for(auto& th : threads) th.join();
+        auto all = std::set<Index::id_type>{};
+        for(auto& v : ids) all.insert(v.begin(),v.end());
+        CHECK(all.size() == size_t(nthread*nid));
+        }
     }
@@ -800,6 +800,58 @@ SECTION("Tie Indices with Diag IQTensor")
         }
     }
 
+SECTION("QDiag QDiag Contraction")
+    {
+    auto makeDiag = [](IQIndexSet is, std::vector<Real> const& v)
+        {
+        auto dat = QDiagReal(is);
+        for(auto j : range(v)) dat.store.at(j) = v[j];
+        return IQTensor(std::move(is),std::move(dat));
+        };
+    auto va = std::vector<Real>(L1.m()),
+         vb = std::vector<Real>(L1.m());
+    for(auto j : range(va))
+        {
+        va[j] = 1.+j;
+        vb[j] = 0.5-j;
+        }
+    auto A = makeDiag(IQIndexSet(dag(L1),prime(L1)),va);
+    auto B = makeDiag(IQIndexSet(dag(prime(L1)),prime(L1,2)),vb);
+
+    auto R = A*B;
+    CHECK(typeOf(R) == QType::QDiagReal);
+    for(auto j : range1(L1))
+    for(auto k : range1(L1))
+        {
+        auto el = (j==k) ? va.at(j-1)*vb.at(j-1) : 0.;
+        CHECK_CLOSE(R.real(L1(j),prime(L1,2)(k)), el);
+        }
+
+    //All indices contracted
+    auto s = A*dag(A);
+    CHECK(s.r() == 0);
+    Real val = 0;
+    for(auto a : va) val += a*a;
+    CHECK_CLOSE(s.real(),val);
+
+    auto dd = delta(dag(L1),prime(L1))*delta(dag(prime(L1)),prime(L1,2));
+    CHECK(typeOf(dd) == QType::QDiagRealAllSame);
+    CHECK_CLOSE(dd.real(L1(4),prime(L1,2)(4)), 1.);
+
+    //Outer product
+    auto d = delta(dag(S1),S2);
+    auto O = d*A;
+    CHECK(typeOf(O) == QType::QDenseReal);
+    CHECK(O.r() == 4);
+    for(auto i1 : range1(S1))
+    for(auto i2 : range1(S2))
+    for(auto j : range1(L1))
+    for(auto k : range1(L1))
+        {
+        auto el = (i1==i2 && j==k) ? va.at(j-1) : 0.;
+        CHECK_CLOSE(O.real(S1(i1),S2(i2),L1(j),prime(L1)(k)), el);
+        }
+    }
 
 //SECTION("Contract All Dense Inds; Diag result")
 //    {
@@ -1257,6 +1309,27 @@ SECTION("Reindex")
     CHECK_THROWS(nT = reindex(T,S1,S3,S2,J4));
     }
 
+SECTION("Contraction With and Without Block Tables")
+    {
+    //Blocks of B are found by incrementally computed
+    //table keys or by binary search of its offsets
+    auto A = randomTensor(QN(),dag(L1),S1,prime(L2),dag(S2)),
+         B = randomTensor(QN(),dag(prime(L2)),S2,prime(L1,2),prime(S1,2));
+    auto T = randomTensor(QN(),dag(L1),S1,dag(S2),prime(L2),prime(S1,3),dag(S3));
+    auto savetable = Global::blockTable();
+    Global::blockTable() = false;
+    auto C0 = A*B;
+    auto D0 = T*B;
+    Global::blockTable() = true;
+    auto C1 = A*B;
+    auto D1 = T*B;
+    Global::blockTable() = savetable;
+    CHECK(ord(C1) == 4);
+    CHECK(norm(C1-C0) < 1E-12*norm(C0));
+    CHECK(ord(D1) == 6);
+    CHECK(norm(D1-D0) < 1E-12*norm(D0));
+    }
+
 //SECTION("Non-contracting product")
 //    {
 //    SECTION("Case 1")
@@ -6,6 +6,7 @@
 #include "itensor/iqindex.h"
 #include "itensor/util/print_macro.h"
 #include <cstdlib>
+#include <thread>
 
 using namespace std;
 using namespace itensor;
@@ -326,6 +327,63 @@ SECTION("DiagRealAllSame Storage")
 std::system(format("rm -f %s",fname).c_str());
 }
 
+SECTION("Write and Read Header")
+{
+auto headerCopy = [](ITensor const& T)
+    {
+    std::stringstream s;
+    auto d = T.writeHeader(s);
+    auto nT = ITensor();
+    auto nd = nT.readHeader(s);
+    CHECK(nd.size() == d.size());
+    std::copy(d.data(),d.data()+d.size(),nd.data());
+    return nT;
+    };
+SECTION("Dense Real Storage")
+    {
+    auto T = randomTensor(s1,s2);
+    auto nT = headerCopy(T);
+    CHECK(typeOf(nT) == Type::DenseReal);
+    CHECK(norm(T-nT) < 1E-12);
+    }
+SECTION("Dense Cplx Storage")
+    {
+    auto T = randomTensorC(s1,s2);
+    auto nT = headerCopy(T);
+    CHECK(typeOf(nT) == Type::DenseCplx);
+    CHECK(norm(T-nT) < 1E-12);
+    }
+SECTION("Combiner Storage")
+    {
+    auto C = combiner(s1,s2);
+    auto nC = headerCopy(C);
+    CHECK(hasindex(nC,s1));
+    CHECK(hasindex(nC,s2));
+    CHECK(typeOf(nC) == Type::Combiner);
+    }
+SECTION("DiagReal Storage")
+    {
+    auto T = diagTensor(std::vector<Real>{1.,2.},s1,prime(s1));
+    auto nT = headerCopy(T);
+    CHECK(typeOf(nT) == Type::DiagReal);
+    CHECK_CLOSE(nT.real(s1(2),prime(s1)(2)),2.);
+    }
+SECTION("Header and Data Read as Stream")
+    {
+    //MailBox::receive(std::stringstream&) relies on
+    //the header followed by the data being the
+    //same bytes as write
+    auto T = randomTensorC(s1,s2);
+    std::stringstream s;
+    auto d = T.writeHeader(s);
+    s.write(reinterpret_cast<const char*>(d.data()),sizeof(Real)*d.size());
+    auto nT = ITensor();
+    nT.read(s);
+    CHECK(typeOf(nT) == Type::DenseCplx);
+    CHECK(norm(T-nT) < 1E-12);
+    }
+}
+
 SECTION("Set and Get Elements")
 {
 auto T = ITensor(s1,s2);
@@ -1620,6 +1678,96 @@ SECTION("Two-index delta Tensor as Index Replacer")
     CHECK(hasindex(R4a,s1));
     CHECK(hasindex(R4b,s1));
     }
+
+SECTION("Scale Rows and Columns")
+    {
+    auto v = std::vector<Real>(K.m());
+    for(auto j : range(v)) v[j] = 1.+j;
+    auto S = diagTensor(v,K,L);
+    auto U = randomTensor(J,K);
+    auto V = randomTensor(L,M,b3);
+
+    //J runs innermost
+    auto US = U*S;
+    //diagonal runs innermost
+    auto SV = S*V;
+
+    for(auto j : range1(J))
+    for(auto k : range1(K))
+        {
+        CHECK_CLOSE(US.real(J(j),L(k)), v.at(k-1)*U.real(J(j),K(k)));
+        }
+    for(auto k : range1(K))
+    for(auto m : range1(M))
+    for(auto i3 : range1(b3))
+        {
+        CHECK_CLOSE(SV.real(K(k),M(m),b3(i3)), v.at(k-1)*V.real(L(k),M(m),b3(i3)));
+        }
+    }
+
+SECTION("Diag Diag Contraction")
+    {
+    auto va = std::vector<Real>(J.m()),
+         vb = std::vector<Real>(J.m());
+    for(auto j : range(va))
+        {
+        va[j] = 1.+j;
+        vb[j] = 0.5-j;
+        }
+    auto dA = diagTensor(va,J,K);
+    auto dB = diagTensor(vb,K,L,M);
+
+    auto R = dA*dB;
+    CHECK(typeOf(R) == Type::DiagReal);
+    CHECK(R.r() == 3);
+    for(auto j : range1(J))
+        {
+        CHECK_CLOSE(R.real(J(j),L(j),M(j)), va.at(j-1)*vb.at(j-1));
+        CHECK(R.real(J(j),L(j),M(1+j%M.m())) == 0.);
+        }
+
+    //All indices contracted
+    auto dC = diagTensor(vb,J,K);
+    auto s = dA*dC;
+    CHECK(s.r() == 0);
+    Real val = 0;
+    for(auto j : range(va)) val += va[j]*vb[j];
+    CHECK_CLOSE(s.real(),val);
+
+    //Rank 1 result
+    auto dD = diagTensor(vb,K);
+    auto R1 = dA*dD;
+    CHECK(typeOf(R1) == Type::DenseReal);
+    for(auto j : range1(J))
+        {
+        CHECK_CLOSE(R1.real(J(j)), va.at(j-1)*vb.at(j-1));
+        }
+
+    //delta tensors keep "all same" storage
+    auto dd = delta(J,K)*delta(K,L);
+    CHECK(typeOf(dd) == Type::DiagRealAllSame);
+    CHECK_CLOSE(dd.real(J(3),L(3)), 1.);
+    CHECK(dd.real(J(3),L(4)) == 0.);
+
+    //Complex
+    auto Rc = dA*(Cplx_i*dB);
+    CHECK(typeOf(Rc) == Type::DiagCplx);
+    CHECK_CLOSE(Rc.cplx(J(2),L(2),M(2)), Cplx_i*va.at(1)*vb.at(1));
+
+    //Outer product
+    auto dE = diagTensor(std::vector<Real>{{2.,-3.}},s1,s2);
+    auto O = dE*dA;
+    CHECK(typeOf(O) == Type::DenseReal);
+    CHECK(O.r() == 4);
+    for(auto i : range1(s1))
+    for(auto i2 : range1(s2))
+    for(auto j : range1(J))
+    for(auto k : range1(K))
+        {
+        auto el = (i==i2 && j==k) ? dE.real(s1(i),s2(i))*va.at(j-1) : 0.;
+        CHECK_CLOSE(O.real(s1(i),s2(i2),J(j),K(k)), el);
+        }
+    }
 }
 
 
@@ -2660,7 +2808,260 @@ SECTION("ITensor Negation")
         }
     }
 
+SECTION("Contraction Rescaling")
+    {
+    auto i = Index("i",2);
+    auto j = Index("j",2);
+    auto filled = [](Index const& a, Index const& b, Real x)
+        {
+        auto T = ITensor(a,b);
+        for(auto n : range1(a))
+        for(auto m : range1(b))
+            {
+            T.set(a(n),b(m),x*(n+m));
+            }
+        return T;
+        };
+    auto save = Global::deferRescale();
+    for(auto defer : {true,false})
+        {
+        Global::deferRescale() = defer;
+        //Data with a norm below 1E-11 is never rescaled
+        auto S = filled(i,j,1E-7)*filled(j,prime(i),1E-7);
+        CHECK(S.scale().real0() == 1.);
+        CHECK_CLOSE(S.real(i(1),prime(i)(1)),1E-14*(2*2+3*3));
+        //Data with a norm above 1E30 always is
+        auto L = filled(i,j,1E20)*filled(j,prime(i),1E20);
+        CHECK(L.scale().real0() != 1.);
+        CHECK(std::fabs(L.real(i(1),prime(i)(1))/1E40-(2*2+3*3)) < 1E-10);
+        }
+    //Other results are only normalized if rescaling is not deferred
+    Global::deferRescale() = true;
+    CHECK((filled(i,j,1.)*filled(j,prime(i),1.)).scale().real0() == 1.);
+    Global::deferRescale() = false;
+    CHECK((filled(i,j,1.)*filled(j,prime(i),1.)).scale().real0() != 1.);
+    Global::deferRescale() = save;
+    }
+
 
 } //TEST_CASE("ITensor")
 
 
+TEST_CASE("StoragePool")
+{
+auto a = Index("a",100),
+     b = Index("b",50),
+     c = Index("c",100);
+auto A = randomTensor(a,b),
+     B = randomTensor(b,c);
+auto C0 = A*B;
+
+SECTION("Reuse")
+    {
+    //The storage of each product is released when
+    //the next one is assigned to C, and reused by
+    //the product after that
+    ITensor C;
+    auto start = storageStats();
+    for(int n = 0; n < 4; ++n)
+        {
+        C = A*B;
+        CHECK(norm(C-C0) < 1E-12*norm(C0));
+        }
+    auto used = storageStats()-start;
+    CHECK(used.nreuse >= 2);
+
+    //Reused buffers are zeroed
+    auto Z = ITensor(a,c);
+    Z.set(a(1),c(1),1.);
+    CHECK(norm(Z) == 1.);
+    }
+
+SECTION("Assignment")
+    {
+    //Assigning to storage returns its old buffer
+    clearStoragePool();
+    auto n = 2*detail::StoragePool<Real>::minSize;
+    auto D = Dense<Real>(n),
+         E = Dense<Real>(n);
+    auto start = storageStats();
+    D = std::move(E);
+    auto F = Dense<Real>(n);
+    CHECK((storageStats()-start).nreuse == 1);
+
+    auto Q = QDense<Real>({{0,0}},n),
+         R = QDense<Real>({{0,0}},n);
+    start = storageStats();
+    Q = R;
+    CHECK((storageStats()-start).nreuse == 1);
+    CHECK(Q.store.size() == n);
+    }
+
+SECTION("Per Thread")
+    {
+    //A buffer released by one thread is
+    //not taken by another
+    clearStoragePool();
+    auto n = 2*detail::StoragePool<Real>::minSize;
+        {
+        auto D = Dense<Real>(n);
+        }
+    auto start = storageStats();
+    auto tused = StorageStats{};
+    auto t = std::thread([n,&tused]
+        {
+        auto tstart = storageStats();
+        auto E = Dense<Real>(n);
+        tused = storageStats()-tstart;
+        });
+    t.join();
+    CHECK(tused.nalloc == 1);
+    CHECK(tused.nreuse == 0);
+    //Counts are kept per thread too
+    CHECK((storageStats()-start).nalloc == 0);
+    auto F = Dense<Real>(n);
+    CHECK((storageStats()-start).nreuse == 1);
+    }
+
+SECTION("Size Limits")
+    {
+    //Buffers more than twice the size
+    //requested are not taken
+    clearStoragePool();
+    auto n = 2*detail::StoragePool<Real>::minSize;
+        {
+        auto D = Dense<Real>(4*n);
+        }
+    auto start = storageStats();
+        {
+        auto E = Dense<Real>(n);
+        }
+    CHECK((storageStats()-start).nreuse == 0);
+    auto F = Dense<Real>(3*n);
+    CHECK((storageStats()-start).nreuse == 1);
+
+    //No buffers are kept past storagePoolBytes()
+    clearStoragePool();
+    auto maxbytes = Global::storagePoolBytes();
+    Global::storagePoolBytes() = sizeof(Real)*n/2;
+        {
+        auto D = Dense<Real>(n);
+        }
+    start = storageStats();
+    auto G = Dense<Real>(n);
+    CHECK((storageStats()-start).nreuse == 0);
+    Global::storagePoolBytes() = maxbytes;
+    }
+
+SECTION("Copy")
+    {
+    auto C = C0;
+    C.set(a(1),c(1),100.);
+    CHECK(C0.real(a(1),c(1)) != 100.);
+    CHECK(C.real(a(1),c(1)) == 100.);
+    CHECK(std::fabs(norm(C-C0)-std::fabs(100.-C0.real(a(1),c(1)))) < 1E-10);
+    }
+
+SECTION("Disabled")
+    {
+    Global::poolStorage() = false;
+    clearStoragePool();
+    auto start = storageStats();
+    ITensor C;
+    for(int n = 0; n < 3; ++n) C = A*B;
+    auto used = storageStats()-start;
+    CHECK(used.nreuse == 0);
+    CHECK(used.nalloc >= 3);
+    CHECK(norm(C-C0) < 1E-12*norm(C0));
+    Global::poolStorage() = true;
+    }
+}
+
+TEST_CASE("TableDispatch")
+{
+auto i = Index("i",3),
+     j = Index("j",4),
+     k = Index("k",2);
+auto A = randomTensor(i,j),
+     B = randomTensor(j,k),
+     Z = randomTensorC(i,j);
+auto D = delta(i,prime(i));
+auto C = combiner(i,j);
+
+//Results of tasks on various pairs of storage types
+auto results = [&]()
+    {
+    auto r = std::vector<ITensor>{};
+    r.push_back(A*B);
+    r.push_back(Z*B);
+    r.push_back(A*D);
+    r.push_back(D*A);
+    r.push_back(A*C);
+    auto S = A;
+    S += Z;
+    r.push_back(S);
+    r.push_back(A*A);
+    r.push_back(ITensor(norm(Z)));
+    return r;
+    };
+
+SECTION("Matches virtual dispatch")
+    {
+    Global::tableDispatch() = false;
+    auto r0 = results();
+    Global::tableDispatch() = true;
+    auto r1 = results();
+    REQUIRE(r0.size() == r1.size());
+    for(auto n : range(r0))
+        {
+        CHECK(norm(r1[n]-r0[n]) < 1E-12*(1+norm(r0[n])));
+        }
+    }
+
+SECTION("Type index")
+    {
+    CHECK((indexOf<StorageTypes,Dense<Real>>() == 0));
+    CHECK((indexOf<StorageTypes,Scalar<Cplx>>() == int(StorageTypes::size())-1));
+    CHECK((indexOf<StorageTypes,int>() == -1));
+    CHECK((A.store()->typeIndex() == indexOf<StorageTypes,Dense<Real>>()));
+    CHECK((D.store()->typeIndex() == indexOf<StorageTypes,Diag<Real>>()));
+    }
+}
+
+TEST_CASE("ElementwiseThreads")
+{
+//Large enough for element-wise loops to be split among threads
+auto i = Index("i",50),
+     j = Index("j",50),
+     k = Index("k",60);
+REQUIRE(size_t(i.m()*j.m()*k.m()) >= elementwiseMinSize);
+auto A = randomTensorC(i,j,k),
+     B = randomTensor(k,i,j),
+     Bs = randomTensor(i,j,k);
+
+auto results = [&]()
+    {
+    auto r = std::vector<ITensor>{};
+    r.push_back(dag(A));
+    r.push_back(Cplx(0.5,-2.)*A);
+    r.push_back(A+B);
+    r.push_back(A+Bs);
+    r.push_back(B+Bs);
+    return r;
+    };
+
+auto nthread = Global::elementwiseThreads();
+Global::elementwiseThreads() = 1;
+auto r1 = results();
+Global::elementwiseThreads() = 3;
+auto r3 = results();
+Global::elementwiseThreads() = nthread;
+
+for(auto n : range(r1))
+    {
+    CHECK(norm(r3[n]-r1[n]) == 0.);
+    }
+CHECK_CLOSE(r1[0].cplx(i(2),j(3),k(4)),std::conj(A.cplx(i(2),j(3),k(4))));
+CHECK_CLOSE(r1[2].cplx(i(2),j(3),k(4)),A.cplx(i(2),j(3),k(4))+B.real(i(2),j(3),k(4)));
+CHECK_CLOSE(r1[3].cplx(i(2),j(3),k(4)),A.cplx(i(2),j(3),k(4))+Bs.real(i(2),j(3),k(4)));
+}
@@ -1,6 +1,8 @@
 #include "test.h"
 #include "itensor/mps/localop.h"
 #include "itensor/mps/localmpo.h"
+#include "itensor/mps/dmrg.h"
+#include "itensor/mps/autompo.h"
 #include "itensor/mps/sites/spinhalf.h"
 #include "itensor/util/print_macro.h"
 
@@ -89,6 +91,30 @@ SECTION("Diag")
 }
 
 
+//Compare environments and products made using
+//the sparse form of H with the dense ones
+template<typename Tensor>
+void
+checkSparseMPO(MPOt<Tensor> const& H, MPSt<Tensor> psi)
+    {
+    auto N = H.N();
+    for(int b = 1; b < N; ++b)
+        {
+        psi.position(b);
+        auto PD = LocalMPO<Tensor>(H);
+        auto PS = LocalMPO<Tensor>(H,{"SparseMPO",true});
+        PD.position(b,psi);
+        PS.position(b,psi);
+        if(b > 1) CHECK(norm(PD.L()-PS.L()) < 1E-12);
+        if(b < N-1) CHECK(norm(PD.R()-PS.R()) < 1E-12);
+        auto phi = psi.A(b)*psi.A(b+1);
+        Tensor Dphi,Sphi;
+        PD.product(phi,Dphi);
+        PS.product(phi,Sphi);
+        CHECK(norm(Dphi-Sphi) < 1E-12);
+        }
+    }
+
 TEST_CASE("LocalMPO")
 {
 SECTION("LocalMPO As MPS")
@@ -109,6 +135,236 @@ SECTION("LocalMPO As MPS")
     auto lmps = LocalMPO<IQTensor>(psiN);
     lmps.position(3,psiF);
     }
+
+SECTION("Sparse MPO")
+    {
+    auto N = 8;
+    auto sites = SpinHalf(N);
+    auto ampo = AutoMPO(sites);
+    for(int i = 1; i <= N; ++i)
+    for(int j = i+1; j <= N; ++j)
+        {
+        auto J = 1./((j-i)*(j-i));
+        ampo += 0.5*J,"S+",i,"S-",j;
+        ampo += 0.5*J,"S-",i,"S+",j;
+        ampo +=     J,"Sz",i,"Sz",j;
+        }
+    auto neel = InitState(sites),
+         aneel = InitState(sites),
+         pairs = InitState(sites);
+    for(int j = 1; j <= N; ++j) 
+        {
+        neel.set(j,j%2==1 ? "Up" : "Dn");
+        aneel.set(j,j%2==1 ? "Dn" : "Up");
+        pairs.set(j,(j-1)%4 < 2 ? "Up" : "Dn");
+        }
+
+    //Product states and an entangled state
+    auto IH = IQMPO(ampo);
+    checkSparseMPO(IH,IQMPS(neel));
+    checkSparseMPO(IH,sum(std::vector<IQMPS>{IQMPS(neel),IQMPS(aneel),IQMPS(pairs)}));
+    auto H = toMPO<ITensor>(ampo,{"Exact",true});
+    checkSparseMPO(H,MPS(neel));
+    checkSparseMPO(H,sum(std::vector<MPS>{MPS(neel),MPS(aneel),MPS(pairs)}));
+
+    auto sparse = SparseIQMPO(IH);
+    auto dsparse = SparseMPO(H);
+    CHECK(sparse.N() == N);
+    for(int j = 2; j < N; ++j)
+        {
+        auto& W = sparse.W(j);
+        CHECK(W.nrow() == commonIndex(IH.A(j-1),IH.A(j)).m());
+        CHECK(W.ncol() == commonIndex(IH.A(j),IH.A(j+1)).m());
+        //Each bulk W has at least the two identity entries
+        CHECK(W.nidentity() >= 2);
+        CHECK(W.nnz() < W.nrow()*W.ncol());
+        //Entries are multiples of S+, S- or Sz
+        CHECK(W.ops().size() == 3);
+        CHECK(dsparse.W(j).ops().size() == 3);
+        }
+    }
 }
 
 
+
+TEST_CASE("TwoSiteVariance")
+{
+auto N = 12;
+auto sites = SpinHalf(N);
+auto neel = InitState(sites),
+     aneel = InitState(sites),
+     pairs = InitState(sites);
+for(int j = 1; j <= N; ++j) 
+    {
+    neel.set(j,j%2==1 ? "Up" : "Dn");
+    aneel.set(j,j%2==1 ? "Dn" : "Up");
+    pairs.set(j,(j-1)%4 < 2 ? "Up" : "Dn");
+    }
+auto psi = sum(std::vector<IQMPS>{IQMPS(neel),IQMPS(aneel),IQMPS(pairs)});
+psi.normalize();
+
+auto exactVariance = [&psi](IQMPO const& H)
+    {
+    return overlap(psi,H,H,psi)-sqr(overlap(psi,H,psi));
+    };
+
+SECTION("Nearest Neighbor")
+    {
+    //H|psi> differs from psi on at most two 
+    //neighboring sites, so the estimate is exact
+    auto ampo = AutoMPO(sites);
+    for(int j = 1; j < N; ++j)
+        {
+        ampo += 0.5,"S+",j,"S-",j+1;
+        ampo += 0.5,"S-",j,"S+",j+1;
+        ampo +=     "Sz",j,"Sz",j+1;
+        }
+    auto H = IQMPO(ampo);
+    auto var = exactVariance(H);
+    CHECK(var > 0.1);
+    CHECK_CLOSE(twoSiteVariance(psi,H),var);
+    }
+
+SECTION("Long Range")
+    {
+    auto ampo = AutoMPO(sites);
+    for(int i = 1; i <= N; ++i)
+    for(int j = i+1; j <= N; ++j)
+        {
+        ampo += 0.5/(j-i),"S+",i,"S-",j;
+        ampo += 0.5/(j-i),"S-",i,"S+",j;
+        }
+    auto H = IQMPO(ampo);
+    auto var = twoSiteVariance(psi,H);
+    CHECK(var > 0);
+    CHECK(var < exactVariance(H)+1E-10);
+    }
+}
+
+TEST_CASE("ExcitedStates")
+{
+auto N = 8;
+auto sites = SpinHalf(N);
+auto ampo = AutoMPO(sites);
+for(int j = 1; j < N; ++j)
+    {
+    ampo += 0.5,"S+",j,"S-",j+1;
+    ampo += 0.5,"S-",j,"S+",j+1;
+    ampo +=     "Sz",j,"Sz",j+1;
+    }
+auto H = IQMPO(ampo);
+auto neel = InitState(sites),
+     aneel = InitState(sites),
+     pairs = InitState(sites);
+for(int j = 1; j <= N; ++j) 
+    {
+    neel.set(j,j%2==1 ? "Up" : "Dn");
+    aneel.set(j,j%2==1 ? "Dn" : "Up");
+    pairs.set(j,(j-1)%4 < 2 ? "Up" : "Dn");
+    }
+
+SECTION("Projector Product")
+    {
+    auto psis = std::vector<IQMPS>{IQMPS(aneel),
+                                   sum(IQMPS(neel),IQMPS(pairs))};
+    auto w = 3.;
+    auto PH = LocalMPO_MPS<IQTensor>(H,psis,{"Weight",w});
+    auto psi = sum(IQMPS(pairs),IQMPS(aneel));
+    psi.normalize();
+    for(int b : {1,4,7})
+        {
+        psi.position(b);
+        PH.position(b,psi);
+        auto phi = psi.A(b)*psi.A(b+1);
+        IQTensor phip;
+        PH.product(phi,phip);
+        //Same matrix element computed from the full MPS
+        auto E = overlap(psi,H,psi);
+        for(auto& p : psis) E += w*sqr(overlap(p,psi));
+        CHECK_CLOSE((dag(phi)*phip).real(),E);
+        }
+    }
+
+SECTION("Batched Targeting")
+    {
+    auto sweeps = Sweeps(5);
+    sweeps.maxm() = 10,20,40;
+    sweeps.cutoff() = 1E-14;
+    sweeps.niter() = 4;
+    auto args = Args{"Quiet",true,"Weight",10.};
+
+    //Lowest states found one at a time
+    auto seq = std::vector<IQMPS>{};
+    auto seqE = std::vector<Real>{};
+    for(auto n : range(3))
+        {
+        auto psi = IQMPS(neel);
+        seqE.push_back(n == 0 ? dmrg(psi,H,sweeps,args) : dmrg(psi,H,seq,sweeps,args));
+        seq.push_back(psi);
+        }
+
+    auto psis = std::vector<IQMPS>(3);
+    psis.front() = IQMPS(neel);
+    auto E = dmrgStates(psis,H,sweeps,args);
+    REQUIRE(E.size() == 3);
+    for(auto n : range(3))
+        {
+        CHECK_CLOSE(E[n],seqE[n]);
+        CHECK_CLOSE(overlap(psis[n],H,psis[n]),E[n]);
+        CHECK_CLOSE(overlap(psis[n],psis[n]),1.);
+        for(auto m : range(n)) CHECK(std::fabs(overlap(psis[m],psis[n])) < 1E-8);
+        }
+    }
+}
+
+class MatvecObserver : public DMRGObserver<IQTensor>
+    {
+    public:
+    long nmatvec = 0;
+
+    MatvecObserver(IQMPS const& psi) : DMRGObserver<IQTensor>(psi) { }
+
+    void
+    measure(Args const& args) override
+        {
+        if(args.getInt("AtBond") == 1 && args.getInt("HalfSweep") == 2)
+            {
+            nmatvec = args.getInt("DavidsonMatvecs");
+            }
+        }
+    };
+
+TEST_CASE("AdaptiveDavidson")
+{
+auto N = 30;
+auto sites = SpinHalf(N);
+auto ampo = AutoMPO(sites);
+for(int j = 1; j < N; ++j)
+    {
+    ampo += 0.5,"S+",j,"S-",j+1;
+    ampo += 0.5,"S-",j,"S+",j+1;
+    ampo +=     "Sz",j,"Sz",j+1;
+    }
+auto H = IQMPO(ampo);
+auto neel = InitState(sites);
+for(int j = 1; j <= N; ++j) neel.set(j,j%2==1 ? "Up" : "Dn");
+
+auto sweeps = Sweeps(6);
+sweeps.maxm() = 10,20,40,60;
+sweeps.cutoff() = 1E-9;
+sweeps.niter() = 6;
+
+auto psi0 = IQMPS(neel);
+auto obs0 = MatvecObserver(psi0);
+auto E0 = dmrg(psi0,H,sweeps,obs0,{"Quiet",true});
+
+auto psi1 = IQMPS(neel);
+auto obs1 = MatvecObserver(psi1);
+auto E1 = dmrg(psi1,H,sweeps,obs1,{"Quiet",true,"AdaptiveDavidson",true});
+
+//MaxIter+1 products at each bond of the last sweep,
+//except near the edges where the space is small
+CHECK(obs0.nmatvec > 6*2*(N-1));
+CHECK(obs1.nmatvec < obs0.nmatvec/2);
+CHECK(std::fabs(E1-E0) < 1E-7);
+}
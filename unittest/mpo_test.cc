@@ -109,6 +109,67 @@ SECTION("Add MPOs")
     CHECK(diff2 < 1E-12);
     }
 
+SECTION("Compress MPOs")
+    {
+    auto N = 12;
+    auto sites = SpinHalf(N);
+    auto ampo = AutoMPO(sites);
+    for(int i = 1; i <= N; ++i)
+    for(int j = i+1; j <= N; ++j)
+        {
+        auto J = 1./((j-i)*(j-i));
+        ampo += 0.5*J,"S+",i,"S-",j;
+        ampo += 0.5*J,"S-",i,"S+",j;
+        ampo +=     J,"Sz",i,"Sz",j;
+        }
+    auto H = IQMPO(ampo);
+    auto HH = overlap(H,H);
+
+    //Relative squared distance of c*H and W
+    auto diff2 = [&H,HH](Real c, IQMPO const& W)
+        {
+        return (c*c*HH-2*c*overlap(H,W)+overlap(W,W))/(c*c*HH);
+        };
+
+    //Exact sums are compressed back to the bond dimension of H
+    auto W = H;
+    addExact(W,H);
+    addExact(W,H);
+    CHECK(maxM(W) == 3*maxM(H));
+    auto err = compressMPO(W);
+    CHECK(err < 1E-6);
+    CHECK(maxM(W) == maxM(H));
+    CHECK(diff2(3,W) < 1E-12);
+    CHECK(isOrtho(W));
+    CHECK(orthoCenter(W) == 1);
+
+    //Fit of a sum without forming it
+    auto F = IQMPO();
+    err = compressMPO(std::vector<IQMPO>{H,H,H},F,{"Method","Fit"});
+    CHECK(err < 1E-6);
+    CHECK(maxM(F) == maxM(H));
+    CHECK(diff2(3,F) < 1E-12);
+
+    auto S = IQMPO();
+    err = compressMPO(std::vector<IQMPO>{H,-1*H,H},S,{"Method","SVD"});
+    CHECK(maxM(S) == maxM(H));
+    CHECK(diff2(1,S) < 1E-12);
+
+    //Truncation to a requested error
+    auto T = H;
+    err = compressMPO(T,{"ErrGoal",1E-2});
+    CHECK(err > 0);
+    CHECK(err <= 1E-2);
+    CHECK(maxM(T) < maxM(H));
+    CHECK(std::sqrt(diff2(1,T)) <= 1.01*err);
+
+    auto D = toMPO<ITensor>(ampo);
+    auto DT = D;
+    auto derr = compressMPO(DT,{"ErrGoal",1E-2});
+    CHECK(derr <= 1E-2);
+    CHECK(maxM(DT) < maxM(D));
+    }
+
 SECTION("Regression Test")
     {
     auto sites = Hubbard(2);
@@ -0,0 +1,285 @@
+#include "test.h"
+
+#define PARALLEL_THREADS
+#include "itensor/util/parallel.h"
+#include "itensor/util/jobs.h"
+#include "itensor/all_basic.h"
+
+using namespace itensor;
+using namespace std;
+
+//Catch assertions are not thread-safe, so results
+//are collected inside parallelRun and checked afterward
+
+TEST_CASE("ParallelThreadsTest")
+{
+auto i = Index("i",3),
+     j = Index("j",4);
+
+SECTION("Single Node Environment")
+    {
+    char* argv[] = { nullptr };
+    Environment env(0,argv);
+    CHECK(env.nnodes() == 1);
+    CHECK(env.firstNode());
+    double r = 2.5;
+    CHECK_CLOSE(sum(env,r),2.5);
+    env.barrier();
+    }
+
+SECTION("MailBox ITensor")
+    {
+    auto T = randomTensor(i,j);
+    auto R = ITensor();
+    ITData const* sent = nullptr;
+    ITData const* recd = nullptr;
+    parallelRun(2,[&](Environment const& env)
+        {
+        if(env.firstNode())
+            {
+            MailBox mailbox(env,1);
+            sent = T.store().get();
+            mailbox.send(T);
+            }
+        else
+            {
+            MailBox mailbox(env,0);
+            mailbox.receive(R);
+            recd = R.store().get();
+            }
+        });
+    CHECK(norm(R-T) < 1E-12);
+    //Received tensor shares storage with the sent one
+    CHECK(sent == recd);
+
+    //Copy-on-write: modifying R must not change T
+    auto Tc = T;
+    R *= 2.;
+    CHECK(norm(T-Tc) < 1E-12);
+    CHECK(norm(R-2*T) < 1E-12);
+    }
+
+SECTION("MailBox Two Way")
+    {
+    auto n0 = std::vector<Real>(),
+         n1 = std::vector<Real>();
+    parallelRun(2,[&](Environment const& env)
+        {
+        MailBox mailbox(env,env.rnode());
+        auto mine = std::vector<Real>(5,env.rank()+1.);
+        if(env.firstNode())
+            {
+            mailbox.send(mine);
+            mailbox.receive(n0);
+            }
+        else
+            {
+            mailbox.receive(n1);
+            mailbox.send(mine);
+            }
+        });
+    CHECK(n0 == std::vector<Real>(5,2.));
+    CHECK(n1 == std::vector<Real>(5,1.));
+    }
+
+SECTION("Stream and Typed Messages")
+    {
+    auto T = randomTensor(i,j);
+    auto R1 = ITensor(),
+         R2 = ITensor();
+    parallelRun(2,[&](Environment const& env)
+        {
+        MailBox mailbox(env,env.rnode());
+        if(env.firstNode())
+            {
+            std::stringstream data;
+            itensor::write(data,T);
+            mailbox.send(data);
+            mailbox.send(T);
+            }
+        else
+            {
+            mailbox.receive(R1);
+            std::stringstream data;
+            mailbox.receive(data);
+            itensor::read(data,R2);
+            }
+        });
+    CHECK(norm(R1-T) < 1E-12);
+    CHECK(norm(R2-T) < 1E-12);
+    }
+
+SECTION("Broadcast and Sums")
+    {
+    int const N = 4;
+    auto T = randomTensor(i,j);
+    auto bcast = std::vector<ITensor>(N);
+    auto bvals = std::vector<Real>(N);
+    auto sums = std::vector<Real>(N);
+    auto allsums = std::vector<ITensor>(N);
+    auto scattered = std::vector<std::vector<int>>(N);
+    auto gathered = std::vector<int>();
+    parallelRun(N,[&](Environment const& env)
+        {
+        auto r = env.rank();
+        auto A = ITensor();
+        Real x = 0;
+        if(env.firstNode())
+            {
+            A = T;
+            x = 3.;
+            }
+        env.broadcast(A,x);
+        bcast.at(r) = A;
+        bvals.at(r) = x;
+
+        sums.at(r) = sum(env,double(r+1));
+
+        auto B = (r+1.)*T;
+        allsums.at(r) = allSum(env,B);
+
+        env.barrier();
+
+        auto v = std::vector<int>();
+        if(env.firstNode()) v = {0,1,2,3,4,5,6,7,8,9};
+        scatterVector(env,v);
+        scattered.at(r) = v;
+        gatherVector(env,v);
+        if(env.firstNode()) gathered = v;
+        });
+    for(auto r : range(N))
+        {
+        CHECK(norm(bcast[r]-T) < 1E-12);
+        CHECK_CLOSE(bvals[r],3.);
+        CHECK(norm(allsums[r]-10*T) < 1E-10);
+        }
+    CHECK_CLOSE(sums[0],10.);
+    CHECK(scattered[0] == std::vector<int>({0,1,2}));
+    CHECK(scattered[1] == std::vector<int>({3,4,5}));
+    CHECK(scattered[2] == std::vector<int>({6,7}));
+    CHECK(scattered[3] == std::vector<int>({8,9}));
+    CHECK(gathered == std::vector<int>({0,1,2,3,4,5,6,7,8,9}));
+    }
+
+SECTION("Exceptions")
+    {
+    auto run = []()
+        {
+        parallelRun(3,[](Environment const& env)
+            {
+            if(env.rank() == 2) throw ITError("node 2 failed");
+            //Would block forever without failure propagation
+            MailBox mailbox(env,2);
+            Real x = 0;
+            mailbox.receive(x);
+            });
+        };
+    CHECK_THROWS_AS(run(),ITError);
+    }
+
+SECTION("Nodes Run Loops Serially")
+    {
+    auto serial = std::vector<int>(3,0);
+    parallelRun(3,[&serial](Environment const& env)
+        {
+        serial.at(env.rank()) = detail::inParallelChunk();
+        });
+    CHECK(serial == std::vector<int>({1,1,1}));
+    CHECK(!detail::inParallelChunk());
+    }
+
+SECTION("Several Receivers of One Queue")
+    {
+    //Messages from 0 to 1 with the same tag, taken by
+    //two threads; the queue is erased whenever it empties
+    detail::ThreadWorld world(2);
+    int nmess = 200;
+    auto got = std::vector<int>(2,0);
+    auto recv = [&](int t)
+        {
+        for(int n = 0; n < nmess/2; ++n)
+            {
+            int x = 0;
+            detail::readMessage(world.take(0,1,0),x);
+            got[t] += x;
+            }
+        };
+    auto t0 = std::thread(recv,0),
+         t1 = std::thread(recv,1);
+    for(int n = 0; n < nmess; ++n) world.post(0,1,0,detail::makeMessage(1));
+    t0.join();
+    t1.join();
+    CHECK((got[0]+got[1]) == nmess);
+    }
+}
+
+TEST_CASE("JobsTest")
+{
+
+SECTION("All Jobs Run")
+    {
+    int njobs = 20;
+    auto norms = std::vector<Real>(njobs,0.);
+    auto argsok = std::vector<int>(njobs,0);
+    Global::args("JobsTest",-1);
+    runJobs(njobs,[&](int job)
+        {
+        //Each job has its own copy of the global Args
+        argsok[job] = (Args::global().getInt("JobsTest") == -1);
+        Global::args("JobsTest",job);
+        auto i = Index("i",job+1);
+        auto T = ITensor(i);
+        for(auto n : range1(i)) T.set(i(n),1.);
+        norms[job] = norm(T);
+        argsok[job] = argsok[job] && (Args::global().getInt("JobsTest") == job);
+        //No threads started inside jobs by default
+        argsok[job] = argsok[job] && (Args::global().getInt("NThread",0) == 1);
+        },
+        {"Threads",4});
+    for(auto job : range(njobs))
+        {
+        CHECK_CLOSE(norms[job],std::sqrt(job+1.));
+        CHECK(argsok[job]);
+        }
+    CHECK(Args::global().getInt("JobsTest") == -1);
+    Args::global().remove("JobsTest");
+    }
+
+SECTION("Seeded Jobs")
+    {
+    //Random numbers and Index IDs of a job do
+    //not depend on the number of threads
+    int njobs = 8;
+    auto draw = [njobs](int nthread)
+        {
+        auto r = std::vector<Real>(njobs);
+        auto id = std::vector<Index::id_type>(njobs);
+        runJobs(njobs,[&r,&id](int job)
+            {
+            r[job] = Global::random();
+            id[job] = Index("i").id();
+            },
+            {"Threads",nthread,"Seed",7});
+        return std::make_pair(r,id);
+        };
+    auto r1 = draw(1),
+         r3 = draw(3);
+    for(auto job : range(njobs))
+        {
+        CHECK(r1.first[job] == r3.first[job]);
+        CHECK(r1.second[job] == r3.second[job]);
+        }
+    CHECK(r1.first[0] != r1.first[1]);
+    CHECK(r1.second[0] != r1.second[1]);
+    }
+
+SECTION("Exceptions")
+    {
+    CHECK_THROWS_AS(runJobs(100,[](int job)
+        {
+        if(job == 2) throw std::runtime_error("job failed");
+        },
+        {"Threads",2}),std::runtime_error);
+    }
+
+}
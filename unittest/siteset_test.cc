@@ -8,6 +8,40 @@
 
 using namespace itensor;
 
+//Site whose operators depend on its position, not only
+//on its index, so it does not declare cacheOps()
+class ScaledSite
+    {
+    IQIndex s;
+    int n = 0;
+    public:
+
+    ScaledSite() { }
+
+    ScaledSite(int n_, Args const& args = Args::global())
+      : n(n_)
+        {
+        s = IQIndex{nameint("S ",n),
+               Index(nameint("Up ",n),1,Site),QN("Sz=",+1),
+               Index(nameint("Dn ",n),1,Site),QN("Sz=",-1)};
+        }
+
+    IQIndex
+    index() const { return s; }
+
+    IQIndexVal
+    state(std::string const& state) { return s(1); }
+
+    IQTensor
+    op(std::string const& opname,
+       Args const& args) const
+        {
+        auto Op = IQTensor(dag(s),prime(s));
+        Op.set(s(1),prime(s)(1),Real(n));
+        return Op;
+        }
+    };
+
 TEST_CASE("SiteSetTest")
 {
 
@@ -112,5 +146,83 @@ SECTION("tJ")
     sites.op("Adn",2); 
     sites.op("F",2); 
     }
-}
+SECTION("Operator Cache")
+    {
+    auto sites = SpinOne(N,{"SHalfEdge",true});
+    auto fresh = [&sites](std::string const& opname, int i, Args const& args)
+        {
+        sites.clearOpCache();
+        return sites.op(opname,i,args);
+        };
+
+    auto Sz2 = sites.op("Sz",2);
+    auto stats = sites.opCacheStats();
+    CHECK(stats.misses == 1);
+    CHECK(stats.hits == 0);
+    CHECK(stats.size == 1);
+
+    //Sites of the same kind share the cached operator
+    auto Sz5 = sites.op("Sz",5);
+    CHECK(hasindex(Sz5,sites(5)));
+    CHECK(hasindex(Sz5,prime(sites(5))));
+    CHECK(sites.opCacheStats().hits == 1);
+    CHECK(norm(Sz5-fresh("Sz",5,{})) < 1E-14);
+
+    //S=1/2 edge sites are of another kind
+    sites.op("Sz",2);
+    auto Sz1 = sites.op("Sz",1);
+    CHECK(sites.opCacheStats().misses == 2);
+    CHECK(norm(Sz1-fresh("Sz",1,{})) < 1E-14);
+    CHECK(Sz1.r() == 2);
+    CHECK(hasindex(Sz1,sites(1)));
+    sites.op("Sz",N);
+    CHECK(sites.opCacheStats().hits == 1);
+
+    //Products of operators
+    sites.clearOpCache();
+    auto SzSz = sites.op("Sz*Sz",3);
+    auto SzSz7 = sites.op("Sz*Sz",7);
+    CHECK(norm(SzSz7-fresh("Sz*Sz",7,{})) < 1E-14);
+    CHECK(norm(SzSz-multSiteOps(sites.op("Sz",3),sites.op("Sz",3))) < 1E-14);
+
+    //Args are part of the key
+    sites.clearOpCache();
+    auto P1 = sites.op("Proj",4,{"State",1});
+    auto P3 = sites.op("Proj",6,{"State",3});
+    CHECK(sites.opCacheStats().misses == 2);
+    CHECK(P1.real(sites(4)(1),prime(sites(4))(1)) == 1);
+    CHECK(P3.real(sites(6)(3),prime(sites(6))(3)) == 1);
+    CHECK(norm(sites.op("Proj",6,{"State",1})-fresh("Proj",6,{"State",1})) < 1E-14);
 
+    //Modifying a returned operator does not change the cached one
+    auto A = sites.op("Sz",3);
+    A *= 2;
+    A.set(sites(3)(1),prime(sites(3))(1),7.);
+    auto B = sites.op("Sz",3);
+    CHECK(sites.opCacheStats().hits >= 1);
+    CHECK(norm(B-fresh("Sz",3,{})) < 1E-14);
+
+    //Copies of a SiteSet share its cache
+    auto copy = sites;
+    copy.op("Sz",8);
+    CHECK(sites.opCacheStats().hits == 1);
+    sites.clearOpCache();
+    CHECK(copy.opCacheStats().size == 0);
+
+    //Only the args passed to op() are in the key
+    sites.op("Sz",3,{"Unused",1});
+    sites.op("Sz",3);
+    CHECK(sites.opCacheStats().misses == 2);
+    }
+SECTION("No Cache Without cacheOps")
+    {
+    auto sites = BasicSiteSet<ScaledSite>(N);
+    CHECK(sites.op("X",2).real(sites(2)(1),prime(sites(2))(1)) == 2);
+    CHECK(sites.op("X",3).real(sites(3)(1),prime(sites(3))(1)) == 3);
+    CHECK(sites.op("X",3).real(sites(3)(1),prime(sites(3))(1)) == 3);
+    auto stats = sites.opCacheStats();
+    CHECK(stats.size == 0);
+    CHECK(stats.hits == 0);
+    CHECK(stats.misses == 0);
+    }
+}
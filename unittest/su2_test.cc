@@ -0,0 +1,312 @@
+#include "test.h"
+#include "itensor/su2.h"
+#include "itensor/su2tensor.h"
+#include "itensor/decomp.h"
+#include "itensor/mps/sites/spinhalf.h"
+#include "itensor/mps/sites/spinone.h"
+#include "itensor/mps/sites/spinhalfsu2.h"
+
+using namespace itensor;
+
+TEST_CASE("SU2Test")
+{
+
+SECTION("Clebsch-Gordan")
+    {
+    //Two spin 1/2s
+    CHECK_CLOSE(clebschGordan(1,1,1,1,2,2),1.);
+    CHECK_CLOSE(clebschGordan(1,1,1,-1,2,0),1./std::sqrt(2.));
+    CHECK_CLOSE(clebschGordan(1,-1,1,1,2,0),1./std::sqrt(2.));
+    CHECK_CLOSE(clebschGordan(1,1,1,-1,0,0),1./std::sqrt(2.));
+    CHECK_CLOSE(clebschGordan(1,-1,1,1,0,0),-1./std::sqrt(2.));
+    //Spin 1 and spin 1/2
+    CHECK_CLOSE(clebschGordan(2,0,1,1,3,1),std::sqrt(2./3));
+    CHECK_CLOSE(clebschGordan(2,2,1,-1,3,1),std::sqrt(1./3));
+    CHECK_CLOSE(clebschGordan(2,2,1,-1,1,1),std::sqrt(2./3));
+    CHECK_CLOSE(clebschGordan(2,0,1,1,1,1),-std::sqrt(1./3));
+    //Vanishing by selection rules
+    CHECK(clebschGordan(1,1,1,1,2,0) == 0.);
+    CHECK(clebschGordan(1,1,1,1,4,2) == 0.);
+    CHECK(clebschGordan(1,3,1,1,2,4) == 0.);
+
+    //Orthonormality: sum_{m1,m2} <j1 m1 j2 m2|J M><j1 m1 j2 m2|J' M> = delta_{JJ'}
+    for(auto tj1 : {1,2,3,4})
+    for(auto tj2 : {1,2,5})
+    for(auto tJ : su2Fuse(tj1,tj2))
+    for(auto tJp : su2Fuse(tj1,tj2))
+        {
+        Real maxerr = 0;
+        for(auto tM = -tJ; tM <= tJ; tM += 2)
+            {
+            Real s = 0;
+            for(auto tm1 = -tj1; tm1 <= tj1; tm1 += 2)
+                {
+                auto tm2 = tM-tm1;
+                s += clebschGordan(tj1,tm1,tj2,tm2,tJ,tM)*clebschGordan(tj1,tm1,tj2,tm2,tJp,tM);
+                }
+            maxerr = std::max(maxerr,std::fabs(s-(tJ == tJp ? 1. : 0.)));
+            }
+        CHECK(maxerr < 1E-13);
+        }
+
+    //Large spins
+    for(auto tj1 : {61,80})
+    for(auto tJ : {1,41,80,141})
+        {
+        auto tj2 = 80;
+        if(!isTriangle(tj1,tj2,tJ)) continue;
+        Real maxerr = 0;
+        for(auto tM = -tJ; tM <= tJ; tM += 2)
+        for(auto tJp : su2Fuse(tj1,tj2))
+            {
+            if(std::abs(tM) > tJp) continue;
+            Real s = 0;
+            for(auto tm1 = -tj1; tm1 <= tj1; tm1 += 2)
+                {
+                auto tm2 = tM-tm1;
+                s += clebschGordan(tj1,tm1,tj2,tm2,tJ,tM)*clebschGordan(tj1,tm1,tj2,tm2,tJp,tM);
+                }
+            maxerr = std::max(maxerr,std::fabs(s-(tJ == tJp ? 1. : 0.)));
+            }
+        CHECK(maxerr < 1E-12);
+        }
+    //Tiny coefficients keep their relative precision:
+    //<j1 j1, j2 -j2|J j1-j2> = 1/sqrt(C(2J,2j1)) for J = j1+j2
+    auto cg = clebschGordan(40,40,40,-40,80,0);
+    CHECK(std::fabs(cg*std::sqrt(1.0750720873333618e23)-1.) < 1E-12);
+    }
+
+SECTION("6j and 9j")
+    {
+    //{a b c; b a 0} = (-1)^(a+b+c)/sqrt((2a+1)(2b+1))
+    CHECK_CLOSE(wigner6j(1,1,2,1,1,0),0.5);
+    CHECK_CLOSE(wigner6j(2,2,2,2,2,0),-1./3);
+    CHECK_CLOSE(wigner6j(3,1,2,1,3,0),-1./std::sqrt(8.));
+    CHECK_CLOSE(wigner6j(2,2,2,2,2,2),1./6);
+    CHECK(wigner6j(1,1,4,1,1,0) == 0.);
+
+    //Orthogonality: sum_x (2x+1)(2f+1){a b x; c d f}{a b x; c d f'} = delta_{ff'}
+    int ta = 3, tb = 2, tc = 1, td = 4;
+    for(auto tf = 0; tf <= 8; ++tf)
+    for(auto tfp = 0; tfp <= 8; ++tfp)
+        {
+        if(!isTriangle(ta,td,tf) || !isTriangle(tc,tb,tf)) continue;
+        if(!isTriangle(ta,td,tfp) || !isTriangle(tc,tb,tfp)) continue;
+        Real s = 0;
+        for(auto tx : su2Fuse(ta,tb))
+            {
+            s += (tx+1.)*(tf+1.)*wigner6j(ta,tb,tx,tc,td,tf)*wigner6j(ta,tb,tx,tc,td,tfp);
+            }
+        CHECK(std::fabs(s-(tf == tfp ? 1. : 0.)) < 1E-13);
+        }
+
+    //9j with a zero entry reduces to a 6j:
+    //{a b e; c d e; f f 0} = (-1)^(b+c+e+f){a b e; d c f}/sqrt((2e+1)(2f+1))
+    for(auto tf : {1,3})
+    for(auto te : {1,3})
+        {
+        int ta = 2, tb = 1, tc = 1, td = 2;
+        auto sgn = ((tb+tc+te+tf)/2)%2 == 0 ? 1. : -1.;
+        CHECK_CLOSE(wigner9j(ta,tb,te,tc,td,te,tf,tf,0),
+                    sgn*wigner6j(ta,tb,te,td,tc,tf)/std::sqrt((te+1.)*(tf+1.)));
+        }
+    }
+
+SECTION("Wigner-Eckart")
+    {
+    //Spin operators of spin 1/2 and spin 1 sites
+    //from the reduced matrix element of S
+    auto check = [](SiteSet const& sites, int tj)
+        {
+        auto s = sites(1);
+        auto Sz = sites.op("Sz",1),
+             Sp = sites.op("S+",1),
+             Sm = sites.op("S-",1);
+        auto red = reducedSpin(tj);
+        //State n of the site has m = j-(n-1)
+        for(auto n : range1(s.m()))
+        for(auto np : range1(s.m()))
+            {
+            auto tm = tj-2*(n-1),
+                 tmp = tj-2*(np-1);
+            auto el = [&](int tq) { return red*wignerEckart(tj,tm,2,tq,tj,tmp); };
+            CHECK_CLOSE(Sz.real(prime(s)(n),dag(s)(np)),el(0));
+            //S+ = -sqrt(2) S^1_(+1), S- = sqrt(2) S^1_(-1)
+            CHECK_CLOSE(Sp.real(prime(s)(n),dag(s)(np)),-std::sqrt(2.)*el(2));
+            CHECK_CLOSE(Sm.real(prime(s)(n),dag(s)(np)),std::sqrt(2.)*el(-2));
+            }
+        };
+    check(SpinHalf(1),1);
+    check(SpinOne(1,{"SHalfEdge",false}),2);
+    }
+}
+
+TEST_CASE("SU2DenseTest")
+{
+//Sectors of spin 0, 1/2, 1 and 3/2
+auto a = IQIndex("a",Index("a0",2),su2QN(0),
+                     Index("a2",1),su2QN(2),Out);
+auto b = IQIndex("b",Index("b1",2),su2QN(1),
+                     Index("b3",1),su2QN(3),Out);
+auto c = IQIndex("c",Index("c1",1),su2QN(1),
+                     Index("c2",2),su2QN(2),
+                     Index("c3",1),su2QN(3),Out);
+auto d = IQIndex("d",Index("d0",1),su2QN(0),
+                     Index("d2",2),su2QN(2),Out);
+
+auto diffNorm = [](IQTensor const& X, IQTensor const& Y) { return norm(X-Y); };
+
+SECTION("Storage")
+    {
+    auto A = randomSU2Tensor(a,b,dag(c),d);
+    CHECK(isSU2(A));
+    CHECK(!isSU2(randomTensor(QN(),a,dag(a))));
+    CHECK_CLOSE(norm(A),norm(toSzBasis(A)));
+    //Every element in the Sz basis conserves total Sz
+    CHECK(div(toSzBasis(A)) == QN());
+    }
+
+SECTION("Contract")
+    {
+    auto A = randomSU2Tensor(a,b,dag(c));
+    auto B = randomSU2Tensor(c,dag(b),d,prime(a));
+    auto C = A*B;
+    CHECK(isSU2(C));
+    CHECK(diffNorm(toSzBasis(C),toSzBasis(A)*toSzBasis(B)) < 1E-11);
+
+    //Contracting arrows of either direction and
+    //indices of any position in the fusion trees
+    auto D = randomSU2Tensor(dag(d),prime(b),dag(a));
+    auto E = C*D;
+    CHECK(diffNorm(toSzBasis(E),toSzBasis(C)*toSzBasis(D)) < 1E-11);
+
+    //Outer product
+    auto F = randomSU2Tensor(dag(prime(c,2)),prime(d,2));
+    CHECK(diffNorm(toSzBasis(A*F),toSzBasis(A)*toSzBasis(F)) < 1E-11);
+
+    //Full contraction
+    auto z = A*dag(A);
+    CHECK(z.r() == 0);
+    CHECK_CLOSE(z.real(),sqr(norm(A)));
+    CHECK_CLOSE(z.real(),(toSzBasis(A)*dag(toSzBasis(A))).real());
+    }
+
+SECTION("Add and Order")
+    {
+    auto A = randomSU2Tensor(a,b,dag(c),d);
+    auto B = randomSU2Tensor(d,a,dag(c),b);
+    auto C = A+B;
+    CHECK(diffNorm(toSzBasis(C),toSzBasis(A)+toSzBasis(B)) < 1E-11);
+    auto D = 2*A-B;
+    CHECK(diffNorm(toSzBasis(D),2*toSzBasis(A)-toSzBasis(B)) < 1E-11);
+
+    auto O = A;
+    O.order(dag(c),d,b,a);
+    CHECK(O.inds()[0] == dag(c));
+    CHECK(diffNorm(toSzBasis(O),toSzBasis(A)) < 1E-11);
+    }
+
+SECTION("Complex")
+    {
+    auto A = randomSU2Tensor(a,b,dag(c));
+    auto B = randomSU2Tensor(a,b,dag(c));
+    auto Z = A+Cplx_i*B;
+    CHECK(isComplex(Z));
+    auto ZB = randomSU2Tensor(c,dag(b));
+    CHECK(diffNorm(toSzBasis(Z*ZB),toSzBasis(Z)*toSzBasis(ZB)) < 1E-11);
+    CHECK(diffNorm(toSzBasis(dag(Z)),dag(toSzBasis(Z))) < 1E-11);
+
+    //Real plus complex with permuted indices
+    auto P = Cplx_i*randomSU2Tensor(dag(c),a,b);
+    auto R = A;
+    R += P;
+    CHECK(isComplex(R));
+    CHECK(diffNorm(toSzBasis(R),toSzBasis(A)+toSzBasis(P)) < 1E-11);
+    }
+
+SECTION("Combiner")
+    {
+    auto A = randomSU2Tensor(a,b,dag(c),d);
+    auto C = su2Combiner({a,dag(c)});
+    auto ci = C.inds().front();
+    auto AC = A*C;
+    CHECK(hasindex(AC,ci));
+    CHECK_CLOSE(norm(AC),norm(A));
+    CHECK(diffNorm(AC*dag(C),A) < 1E-11);
+    //dag(C)*C is the identity on ci
+    auto I = dag(C)*prime(C,ci);
+    CHECK(diffNorm(toSzBasis(AC*I),toSzBasis(prime(AC,ci))) < 1E-11);
+    }
+
+SECTION("SVD")
+    {
+    auto A = randomSU2Tensor(a,b,dag(c),d);
+    IQTensor U(a,dag(c)),D,V;
+    svd(A,U,D,V);
+    CHECK(isSU2(U));
+    CHECK(isSU2(D));
+    CHECK(isSU2(V));
+    CHECK(diffNorm(U*D*V,A) < 1E-11);
+    CHECK(diffNorm(toSzBasis(U)*toSzBasis(D)*toSzBasis(V),toSzBasis(A)) < 1E-11);
+
+    //U is an isometry
+    auto u = commonIndex(U,D);
+    auto UU = dag(U)*prime(U,u);
+    CHECK_CLOSE(sqr(norm(UU)),szIndex(u).m());
+    CHECK(diffNorm(mapprime(UU*prime(UU),2,1),UU) < 1E-11);
+
+    //Truncation keeps whole multiplets
+    IQTensor Ut(a,dag(c)),Dt,Vt;
+    auto spec = svd(A,Ut,Dt,Vt,{"Maxm",2});
+    auto ut = commonIndex(Ut,Dt);
+    CHECK(ut.m() == 2);
+    auto err = sqr(norm(A-Ut*Dt*Vt)/norm(A));
+    CHECK(std::fabs(err-spec.truncerr()) < 1E-10);
+    }
+
+SECTION("SpinHalfSU2")
+    {
+    auto N = 2;
+    auto sites = SpinHalfSU2(N);
+    auto ssites = SpinHalf(N);
+    CHECK_CLOSE(norm(toSzBasis(sites.op("S2",1))),0.75*std::sqrt(2.));
+
+    //S_1 . S_2 in the Sz basis
+    auto SS = sites.op("S",1)*sites.op("Sdag",2);
+    CHECK(SS.r() == 4);
+    auto Ssz = toSzBasis(SS);
+    auto s1 = szIndex(sites(1)),
+         s2 = szIndex(sites(2));
+    //Sectors of the Sz index run from m = 1/2 to -1/2,
+    //as the Up, Dn states of SpinHalf
+    auto el = [&](int n1p, int n2p, int n1, int n2)
+        {
+        return Ssz.real(prime(s1)(n1p),prime(s2)(n2p),dag(s1)(n1),dag(s2)(n2));
+        };
+    auto ref = [&](int n1p, int n2p, int n1, int n2)
+        {
+        auto t = ssites.op("Sz",1)*ssites.op("Sz",2)
+               + 0.5*ssites.op("S+",1)*ssites.op("S-",2)
+               + 0.5*ssites.op("S-",1)*ssites.op("S+",2);
+        auto i1 = ssites(1), i2 = ssites(2);
+        return t.real(prime(i1)(n1p),prime(i2)(n2p),dag(i1)(n1),dag(i2)(n2));
+        };
+    for(auto n1p : range1(2))
+    for(auto n2p : range1(2))
+    for(auto n1 : range1(2))
+    for(auto n2 : range1(2))
+        {
+        CHECK_CLOSE(el(n1p,n2p,n1,n2),ref(n1p,n2p,n1,n2));
+        }
+    }
+
+SECTION("Read and Write")
+    {
+    auto A = randomSU2Tensor(a,b,dag(c));
+    writeToFile("_su2dense_test",A);
+    auto B = readFromFile<IQTensor>("_su2dense_test");
+    CHECK(isSU2(B));
+    CHECK(diffNorm(A,B) < 1E-14);
+    std::remove("_su2dense_test");
+    }
+}
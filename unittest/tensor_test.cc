@@ -152,6 +152,34 @@ SECTION("TensorRef")
                 }
 
             }
+
+        SECTION("Case 3 - Split Among Threads")
+            {
+            //Large enough to be split into chunks
+            auto T1 = Tensor(60,40,64);
+            auto T2 = Tensor(64,60,40);
+            REQUIRE(size_t(area(T1.range())) >= elementwiseMinSize);
+            randomize(T1);
+            randomize(T2);
+            auto PT2 = permute(T2,Labels{2,0,1});
+
+            auto nthread = Global::elementwiseThreads();
+            Global::elementwiseThreads() = 1;
+            auto S1 = T1;
+            S1 += PT2;
+            Global::elementwiseThreads() = 3;
+            auto P1 = T1;
+            P1 += PT2;
+            Global::elementwiseThreads() = nthread;
+
+            Real maxdiff = 0;
+            for(auto n : range(area(T1.range())))
+                {
+                maxdiff = std::max(maxdiff,std::fabs(P1.store()[n]-S1.store()[n]));
+                }
+            CHECK(maxdiff == 0.);
+            CHECK_CLOSE(P1(59,39,63),T1(59,39,63)+T2(63,59,39));
+            }
         }
     }
 
@@ -320,6 +348,37 @@ SECTION("Slicing")
 
         }
 
+    SECTION("Permuted Copy")
+        {
+        //Copying a permuted view runs through transform,
+        //whose loops are specialized by rank
+        auto savethreads = Global::elementwiseThreads();
+        for(auto nthread : {1,2})
+        for(auto r : range1(8))
+            {
+            Global::elementwiseThreads() = nthread;
+            auto rb = RangeBuilder(r);
+            //Extents giving more than elementwiseMinSize
+            //elements for r = 7 and 8, so that the loop is
+            //also split among threads
+            for(auto n : range(r)) rb.nextIndex(n%2==0 ? (r >= 7 ? 7 : 2) : 3);
+            auto R = rb.build();
+            auto T = Tensor(std::vector<Real>(area(R)),std::move(R));
+            for(auto& el : T) el = detail::quickran();
+            auto P = Labels(r);
+            for(auto n : range(r)) P[n] = (n+1)%r;
+            auto PT = permute(T,P);
+            auto PC = Tensor(PT);
+            long nwrong = 0;
+            for(auto& i : PC.range())
+                {
+                if(PC(i) != PT(i)) ++nwrong;
+                }
+            CHECK(nwrong == 0);
+            }
+        Global::elementwiseThreads() = savethreads;
+        }
+
     SECTION("Sub Tensor")
         {
         auto T = Tensor(7,3,8,6);
@@ -3,6 +3,9 @@
 #include "itensor/global.h"
 #include "itensor/util/infarray.h"
 #include "itensor/util/stats.h"
+#include "itensor/util/profile.h"
+#include "itensor/itensor.h"
+#include <thread>
 
 using namespace itensor;
 using namespace std;
@@ -261,3 +264,118 @@ SECTION("BinErr")
     }
 }
 
+
+TEST_CASE("Profile")
+{
+auto i = Index("i",10),
+     j = Index("j",20),
+     k = Index("k",30);
+auto A = randomTensor(i,j),
+     B = randomTensor(k,j);
+
+SECTION("Off By Default")
+    {
+    profileReset();
+    auto C = A*B;
+    CHECK(!profiling());
+    CHECK(profileRegions().children.empty());
+    }
+
+SECTION("Nested Regions")
+    {
+    profileReset();
+    profiling() = true;
+        {
+        PROFILE_SCOPE("outer")
+        for(int n = 0; n < 3; ++n)
+            {
+            PROFILE_SCOPE("inner",10.,8.)
+            }
+        auto C = A*B;
+        }
+    profiling() = false;
+
+    auto R = profileRegions();
+    auto outer = R.find("outer");
+    REQUIRE(outer);
+    CHECK(outer->count == 1);
+    auto inner = R.find("outer/inner");
+    REQUIRE(inner);
+    CHECK(inner->count == 3);
+    CHECK(inner->flops == 30.);
+    CHECK(inner->bytes == 24.);
+    CHECK(outer->time >= inner->time);
+    CHECK(outer->selfTime() >= 0.);
+
+    //Dense contraction C_ik = A_ij B_kj is a single gemm
+    auto gemm = R.find("outer/contract/gemm");
+    REQUIRE(gemm);
+    CHECK(gemm->count == 1);
+    CHECK(gemm->flops == 2.*10*20*30);
+    CHECK(gemm->bytes > 0);
+
+    //Disabled scopes do not record anything
+        {
+        PROFILE_SCOPE("outer")
+        }
+    CHECK(profileRegions().find("outer")->count == 1);
+    }
+
+SECTION("Threads")
+    {
+    profileReset();
+    profiling() = true;
+    auto work = []()
+        {
+        PROFILE_SCOPE("work",1.,0.)
+        };
+    auto t1 = std::thread(work);
+    auto t2 = std::thread(work);
+    t1.join();
+    t2.join();
+    profiling() = false;
+
+    auto R = profileRegions();
+    REQUIRE(R.find("work"));
+    CHECK(R.find("work")->count == 2);
+    CHECK(R.find("work")->flops == 2.);
+    auto threads = profileThreads();
+    CHECK(threads.size() >= 3);
+    }
+
+SECTION("Export")
+    {
+    profileReset();
+    profiling() = true;
+        {
+        PROFILE_SCOPE("export \"test\"",5.,6.)
+        }
+    profiling() = false;
+
+    std::stringstream json;
+    writeProfileJSON(json);
+    CHECK(json.str().find("{\"threads\":[") == 0);
+    CHECK(json.str().find("\"name\":\"export \\\"test\\\"\"") != std::string::npos);
+
+    std::stringstream trace;
+    writeChromeTrace(trace);
+    CHECK(trace.str().find("\"traceEvents\"") != std::string::npos);
+    CHECK(trace.str().find("\"ph\":\"X\"") != std::string::npos);
+    CHECK(trace.str().find("\"flops\":5") != std::string::npos);
+
+    profileTrace() = false;
+    profileReset();
+    profiling() = true;
+        {
+        PROFILE_SCOPE("untraced")
+        }
+    profiling() = false;
+    profileTrace() = true;
+    std::stringstream trace2;
+    writeChromeTrace(trace2);
+    CHECK(trace2.str().find("untraced") == std::string::npos);
+    CHECK(profileRegions().find("untraced"));
+    }
+
+profileReset();
+}